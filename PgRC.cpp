@@ -4,6 +4,7 @@
 #include "pgrc/pgrc-encoder.h"
 #include "pgrc/pgrc-decoder.h"
 #include "pseudogenome/persistence/SeparatedPseudoGenomePersistence.h"
+#include "pseudogenome/generator/ParallelGreedySwipingPackedOverlapPseudoGenomeGenerator.h"
 #include <omp.h>
 
 #define RELEASE_DATE "2024-11-20"
@@ -28,6 +29,7 @@ int main(int argc, char *argv[])
     bool pairFilePresent = false;
     bool compressionParamPresent = false;
     bool decompressMode = false;
+    bool outputParamPresent = false;
 
     numberOfThreads = omp_get_num_procs();
 
@@ -38,10 +40,10 @@ int main(int argc, char *argv[])
 #endif
 
 #ifdef DEVELOPER_BUILD
-    while ((opt = getopt(argc, argv, "c:t:i:q:g:s:M:p:l:B:E:C:doSIrNRVTaAQvh?")) != -1) {
+    while ((opt = getopt(argc, argv, "c:t:i:q:g:s:M:p:P:L:l:B:E:C:b:O:f:x:doXSIrNRVTaAmQvh?")) != -1) {
         char* valPtr;
 #else
-    while ((opt = getopt(argc, argv, "t:i:q:g:s:M:p:doQvh?")) != -1) {
+    while ((opt = getopt(argc, argv, "c:t:i:q:g:s:M:p:P:L:O:f:x:doXQvh?")) != -1) {
 #endif
         switch (opt) {
             case 'i':
@@ -56,12 +58,28 @@ int main(int argc, char *argv[])
                 compressionParamPresent = true;
                 params->setPreserveOrderMode();
                 break;
+            case 'X':
+                compressionParamPresent = true;
+                params->setRandomAccessMode();
+                break;
             case 'd':
                 decompressMode = true;
                 break;
             case 't':
                 numberOfThreads = atoi(optarg);
                 break;
+            case 'O':
+                outputParamPresent = true;
+                params->setOutputName(optarg);
+                break;
+            case 'f':
+                outputParamPresent = true;
+                params->setOutputFormat(*optarg);
+                break;
+            case 'x':
+                outputParamPresent = true;
+                params->setReadsRange(optarg);
+                break;
             case 'q':
                 compressionParamPresent = true;
                 params->setQualityBasedDivisionErrorLimitInPromils(atoi(optarg));
@@ -100,11 +118,19 @@ int main(int argc, char *argv[])
                 compressionParamPresent = true;
                 params->setMinimalPgReverseComplementedRepeatLength(atoi(optarg));
                 break;
-#ifdef DEVELOPER_BUILD
+            case 'P':
+                compressionParamPresent = true;
+                params->setPgSeqParallelBlocks(optarg);
+                break;
             case 'c':
                 compressionParamPresent = true;
                 params->setCompressionLevel(atoi(optarg));
                 break;
+            case 'L':
+                compressionParamPresent = true;
+                params->setMaxMemory(optarg);
+                break;
+#ifdef DEVELOPER_BUILD
             case 'C':
                 compressionParamPresent = true;
                 setAutoSelectorLevel(atoi(optarg));
@@ -161,6 +187,14 @@ int main(int argc, char *argv[])
                 compressionParamPresent = true;
                 SeparatedPseudoGenomePersistence::enableRevOffsetMismatchesRepresentation = false;
                 break;
+            case 'm':
+                compressionParamPresent = true;
+                ReadsSetPersistence::memoryMappedFASTQMode = false;
+                break;
+            case 'b':
+                compressionParamPresent = true;
+                PgIndex::ParallelGreedySwipingPackedOverlapPseudoGenomeGeneratorFactory::blockPrefixLength = atoi(optarg);
+                break;
             case 'B':
                 compressionParamPresent = true;
                 params->setBeginAfterStage(atoi(optarg));
@@ -178,14 +212,24 @@ int main(int argc, char *argv[])
             default: /* '?' */
                 printVersion(false);
                 fprintf(stderr, "Usage: %s [-i seqSrcFile [pairSrcFile]] [-t noOfThreads]"
-                                "\n[-o] [-d] archiveName\n\n", argv[0]);
+                                "\n[-o [-X]] [-d [-O output] [-f format] [-x first[:last]]] archiveName\n\n", argv[0]);
                 fprintf(stderr, "\t-d decompression mode\n");
+                fprintf(stderr, "\t-O decompression output (archiveName_out - default; '-' - stdout; 'fd:N' - file descriptor N)\n"
+                                "\t   (paired reads are written to output_1 and output_2 files or interleaved to stdout/fd)\n");
+                fprintf(stderr, "\t-f decompression output format: s - sequences (default); a - FASTA; q - FASTQ\n");
+                fprintf(stderr, "\t-x output only reads (pairs in PE mode) numbered from first to last in the original order\n"
+                                "\t   (requires an archive compressed with -o option; numbering starts from 1;\n"
+                                "\t   only blocks covering the range are decoded from archives compressed with -X option,\n"
+                                "\t   otherwise the archive is decoded (nearly) as a whole - only reads outside the range are not written)\n");
                 fprintf(stderr, "\t-o preserve original read order information\n");
+                fprintf(stderr, "\t-X random access to ranges of reads (requires -o option; reads and pseudogenome are coded\n"
+                                "\t   in independently decodable blocks and pseudogenomes are not matched - weaker compression)\n");
                 fprintf(stderr, "\t-t number of threads used (%d - default)\n", numberOfThreads);
                 fprintf(stderr, "\t-h print full command help and exit\n");
                 fprintf(stderr, "\t-v print version number and exit\n");
                 fprintf(stderr, "\n------------------ EXPERT OPTIONS ----------------\n");
-                fprintf(stderr, "[-q qualityStreamErrorProbability*1000] (1000=>disable)\n"
+                fprintf(stderr, "[-c compressionLevel] 1 - fast; 2 - default; 3 - max\n"
+                                "[-q qualityStreamErrorProbability*1000] (1000=>disable)\n"
                                 "[-Q] disable simplified quality estimation mode\n"
                                 "[-g generatorBasedQualityCoefficientIn_%%] (0=>disable; 'ov' param in the paper)\n"
                                 "[-s "
@@ -194,14 +238,20 @@ int main(int argc, char *argv[])
 #endif
                                 "lengthOfReadSeedPartForReadsAlignmentPhase]\n"
                                 "[-M minimalNumberOfCharsPerMismatchForReadsAlignmentPhase]\n"
-                                "[-p minimalReverseComplementedRepeatLength]\n\n");
+                                "[-p minimalReverseComplementedRepeatLength]\n"
+                                "[-P pgBlocksPerThread[:primingLengthInMB]] (parallel coding of pseudogenome "
+                                "in blocks: faster but weaker;\n"
+                                "    0 => disable (default); priming length - %d MB default)\n"
+                                "[-L maxMemoryInMB] resident memory budget (idle data is spilled to disk when approached;\n"
+                                "    peak memory of each stage is reported)\n\n",
+                                DEFAULT_PG_SEQ_BLOCKS_PRIMING_LENGTH_IN_MB);
 #ifdef DEVELOPER_BUILD
                 fprintf(stderr, "Matching modes: d[s]:default; i[s]:interleaved; c[s]:copMEM ('s' suffix: shortcut after first read match)\n");
                 fprintf(stderr, "------------------ DEVELOPER OPTIONS ----------------\n");
-                fprintf(stderr, "[-c backendCompressionLevel] 1 - fast; 2 - default; 3 - max\n");
                 fprintf(stderr, "[-C backendCompressionAutoSelectorLevel] 0 - default\n");
                 fprintf(stderr, "[-l [matchingMode]lengthOfReadSeedPartForReadsAlignmentPhase] (enables preliminary reads matching stage)\n"
-                                "[-S] [-I] [-r] [-N] [-V] [-v] [-t] [-a] [-A]\n"
+                                "[-b blockPrefixLengthForPgGeneration] (0 - auto; default)\n"
+                                "[-S] [-I] [-r] [-N] [-V] [-v] [-t] [-a] [-A] [-m]\n"
                                 "[-B numberOfStagesToSkip] [-E numberOfAStageToEnd]\n\n");
                 fprintf(stderr, "-S ignore pair information (explicit single reads mode)\n");
                 fprintf(stderr, "-I ignore order of reads in a pair (works when pairSrcFile is specified)\n");
@@ -212,6 +262,7 @@ int main(int argc, char *argv[])
                                 "(decompression supports -i parameter in validation mode)\n"
                                 "-T write numbers in text mode\n");
                 fprintf(stderr, "-a write absolute read position \n-A write mismatches as positions\n");
+                fprintf(stderr, "-m read FASTQ files using streams (disables memory-mapped input)\n");
                 fprintf(stderr, "Stages: 1:QualDivision; 2:PgGenDivision; 3:Pg(HQ); 4:ReadsMatching; 5:Pg(LQ&N); 6:OrderInfo; 7:PgSequences\n\n");
 #endif
                 fprintf(stderr, "The order of all selected options is arbitrary.\n\n");
@@ -228,6 +279,11 @@ int main(int argc, char *argv[])
         fprintf(stderr, "try '%s -h' for more information\n", argv[0]);
         exit(EXIT_FAILURE);
     }
+    if (outputParamPresent && !decompressMode) {
+        fprintf(stderr, "Output options are supported only in decompression mode.\n");
+        fprintf(stderr, "try '%s -h' for more information\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
     if (!srcFilePresent && !decompressMode) {
         fprintf(stderr, "Input file(s) not specified.\n");
         fprintf(stderr, "try '%s -h' for more information\n", argv[0]);
@@ -249,6 +305,8 @@ int main(int argc, char *argv[])
     params->setPgRCFileName(argv[optind++]);
 
     if (decompressMode) {
+        if (ReadsOutput::isStdout(params->outputName))
+            cout.rdbuf(cerr.rdbuf());
         PgRCDecoder decoder(params);
         decoder.decompressPgRC();
     }
@@ -0,0 +1,65 @@
+#include "../pgrc/pgrc-decoder.h"
+
+#include <omp.h>
+
+using namespace PgHelpers;
+using namespace PgTools;
+
+// measures decompression throughput (decoded reads written per second) versus the number of threads
+// usage: decoder-benchmark [maxThreads] archive [archive ...]
+// (decompressed reads are written next to archives and removed after each run)
+
+static uint64_t fileSize(const string &fileName) {
+    ifstream in(fileName, ios_base::in | ios_base::binary | ios_base::ate);
+    return in ? (uint64_t) in.tellg() : 0;
+}
+
+int main(int argc, char *argv[]) {
+    int argi = 1;
+    int maxThreads = omp_get_num_procs();
+    if (argc > 2 && atoi(argv[1]) > 0 && !ifstream(argv[1]))
+        maxThreads = atoi(argv[argi++]);
+    if (argi >= argc) {
+        fprintf(stderr, "Usage: %s [maxThreads] archive [archive ...]\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+    vector<int> threadsCounts;
+    for (int t = 1; t < maxThreads; t *= 2)
+        threadsCounts.push_back(t);
+    threadsCounts.push_back(maxThreads);
+
+    logout = &null_stream;
+    devout = &null_stream;
+    fprintf(stdout, "%-24s %-7s %8s %10s %10s %8s\n", "archive", "mode", "threads", "time[ms]", "MB/s", "speedup");
+    for (; argi < argc; argi++) {
+        const string archive = argv[argi];
+        const vector<string> outFiles = { archive + "_out", archive + "_out_1", archive + "_out_2" };
+        double singleThreadTime = 0;
+        for (int threads : threadsCounts) {
+            numberOfThreads = threads;
+            omp_set_num_threads(threads);
+            PgRCParams params;
+            params.setPgRCFileName(archive);
+            PgRCDecoder decoder(&params);
+            std::streambuf* coutBuf = cout.rdbuf(null_stream.rdbuf());
+            chrono::steady_clock::time_point start_t = chrono::steady_clock::now();
+            decoder.decompressPgRC();
+            const double time = std::max<double>(time_millis(start_t), 1);
+            cout.rdbuf(coutBuf);
+
+            uint64_t outputSize = 0;
+            for (const string &outFile : outFiles) {
+                outputSize += fileSize(outFile);
+                std::remove(outFile.c_str());
+            }
+            if (threads == 1)
+                singleThreadTime = time;
+            const char* mode = params.preserveOrderMode ? (params.singleReadsMode ? "ORD-SE" : "ORD-PE")
+                    : (params.singleReadsMode ? "SE" : "PE");
+            fprintf(stdout, "%-24s %-7s %8d %10.0lf %10.1lf %8.2lf\n", archive.c_str(), mode, threads, time,
+                    outputSize / time / 1000, singleThreadTime / time);
+            fflush(stdout);
+        }
+    }
+    return 0;
+}
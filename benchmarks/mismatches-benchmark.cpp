@@ -0,0 +1,95 @@
+#include "../utils/helper.h"
+#include "../utils/mismatches.h"
+#include "../coders/SymbolsPackingFacility.h"
+
+#include <random>
+#include <vector>
+
+using namespace PgHelpers;
+using namespace PgIndex;
+
+// measures mismatches counting kernels on read-like sequences with a few mismatches
+// usage: mismatches-benchmark [readLength] [maxMismatches] [comparisonsInMillions]
+
+static const int SEQUENCES_COUNT = 1 << 14;
+
+int main(int argc, char *argv[]) {
+    const uint_read_len_max readLength = argc > 1 ? atoi(argv[1]) : 150;
+    const uint8_t maxMismatches = argc > 2 ? atoi(argv[2]) : 8;
+    const uint64_t comparisons = (argc > 3 ? atoi(argv[3]) : 20) * 1000000ULL;
+    if (readLength == 0 || maxMismatches >= UINT8_MAX) {
+        fprintf(stderr, "Invalid benchmark parameters.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    std::mt19937 rng(1);
+    const char* symbols = "ACGT";
+    vector<string> patterns(SEQUENCES_COUNT), texts(SEQUENCES_COUNT);
+    vector<uint8_t> packed;
+    SymbolsPackingFacility* packer = &SymbolsPackingFacility::ACGTPacker;
+    const size_t packedLength = readLength + sizeof(uint64_t);
+    packed.resize(SEQUENCES_COUNT * packedLength);
+    for (int i = 0; i < SEQUENCES_COUNT; i++) {
+        patterns[i].resize(readLength);
+        for (char &c : patterns[i])
+            c = symbols[rng() % 4];
+        texts[i] = patterns[i];
+        const int mismatches = rng() % (2 * maxMismatches + 2);
+        for (int m = 0; m < mismatches; m++)
+            texts[i][rng() % readLength] = symbols[rng() % 4];
+        packer->packSequence(patterns[i].data(), readLength, packed.data() + i * packedLength);
+    }
+
+    const MismatchesCountingKernel kernels[] = { countSymbolsMismatchesScalar, countSymbolsMismatchesSSE42,
+                                                 countSymbolsMismatchesAVX2 };
+    const char* kernelsNames[] = { "scalar", "SSE4.2", "AVX2" };
+    const bool kernelsSupported[] = { true, isSSE42Supported(), isAVX2Supported() };
+    fprintf(stdout, "Read length: %d; max mismatches: %d; comparisons: %llu; runtime kernel: %s\n", (int) readLength,
+            (int) maxMismatches, (unsigned long long) comparisons, getMismatchesCountingKernelName());
+
+    vector<uint8_t> expected(SEQUENCES_COUNT);
+    for (int i = 0; i < SEQUENCES_COUNT; i++)
+        expected[i] = countSymbolsMismatchesScalar(patterns[i].data(), texts[i].data(), readLength, maxMismatches);
+
+    double scalarTime = 0;
+    for (int k = 0; k < 3; k++) {
+        if (!kernelsSupported[k]) {
+            fprintf(stdout, "%-8s not supported\n", kernelsNames[k]);
+            continue;
+        }
+        uint64_t checksum = 0;
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (uint64_t c = 0; c < comparisons; c++) {
+            const int i = c % SEQUENCES_COUNT;
+            const uint8_t res = kernels[k](patterns[i].data(), texts[i].data(), readLength, maxMismatches);
+            if (res != expected[i]) {
+                fprintf(stderr, "%s kernel result mismatch.\n", kernelsNames[k]);
+                exit(EXIT_FAILURE);
+            }
+            checksum += res;
+        }
+        const double time = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if (k == 0)
+            scalarTime = time;
+        fprintf(stdout, "%-8s %.2f ns/comparison (speedup %.2fx; checksum %llu)\n", kernelsNames[k],
+                time * 1e9 / comparisons, scalarTime / time, (unsigned long long) checksum);
+    }
+
+    uint64_t checksum = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (uint64_t c = 0; c < comparisons; c++) {
+        const int i = c % SEQUENCES_COUNT;
+        const uint8_t res = packer->countSequenceMismatchesVsUnpacked(packed.data() + i * packedLength,
+                                                                      texts[i].data(), readLength, maxMismatches);
+        if (res != expected[i]) {
+            fprintf(stderr, "packed sequence result mismatch.\n");
+            exit(EXIT_FAILURE);
+        }
+        checksum += res;
+    }
+    const double time = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    fprintf(stdout, "%-8s %.2f ns/comparison (speedup %.2fx; checksum %llu)\n", "packed",
+            time * 1e9 / comparisons, scalarTime / time, (unsigned long long) checksum);
+
+    return 0;
+}
@@ -114,7 +114,8 @@ unsigned char* Compress(size_t &destLen, const unsigned char *src, size_t srcLen
 #if DEVELOPER_BUILD
     unique_ptr<CoderProps> scPropsPtr;
     if (!disable_auto_selector && auto_selector_level > 0 && props->getCoderType() != VARLEN_DNA_CODER
-        && props->getCoderType() != PARALLEL_BLOCKS_CODER_TYPE && props->getCoderType() != COMPOUND_CODER_TYPE
+        && props->getCoderType() != PARALLEL_BLOCKS_CODER_TYPE && props->getCoderType() != PRIMED_PARALLEL_BLOCKS_CODER_TYPE
+        && props->getCoderType() != COMPOUND_CODER_TYPE
             && props->getCoderType() != SELECTOR_CODER_TYPE) {
         scPropsPtr = getSelectorCoder(props);
         props = scPropsPtr.get();
@@ -149,6 +150,7 @@ unsigned char* Compress(size_t &destLen, const unsigned char *src, size_t srcLen
             estimated_compression = VarLenDNACoder::COMPRESSION_ESTIMATION;
             break;
         case PARALLEL_BLOCKS_CODER_TYPE:
+        case PRIMED_PARALLEL_BLOCKS_CODER_TYPE:
             res = parallelBlocksCompress(dest, destLen, src, srcLen,
                                          (ParallelBlocksCoderProps *) props, estimated_compression, logout);
             break;
@@ -275,6 +277,12 @@ void Uncompress(unsigned char* dest, size_t destLen, unsigned char* src, size_t
         case PARALLEL_BLOCKS_CODER_TYPE:
             res = parallelBlocksDecompress(dest, &outLen, src, logout);
             break;
+        case PRIMED_PARALLEL_BLOCKS_CODER_TYPE:
+            res = parallelBlocksDecompress(dest, &outLen, src, logout, true);
+            break;
+        case PRIMED_LZMA_CODER:
+            fprintf(stderr, "Primed LZMA block cannot be decompressed without its priming block.\n");
+            exit(EXIT_FAILURE);
         case LZMA2_CODER:
         default:
             fprintf(stderr, "Unsupported coder type: %d.\n", coder_type);
@@ -291,20 +299,35 @@ void Uncompress(unsigned char* dest, size_t destLen, unsigned char* src, size_t
                          << PgHelpers::time_millis(start_t) << " msec." << endl;
 }
 
+// primed blocks are marked with PRIMED_LZMA_CODER type (unless stored uncompressed)
+void writeStream(ostream &dest, const unsigned char *src, size_t srcLen, const unsigned char *compSeq, size_t compLen,
+        CoderProps* props, bool primedBlock = false) {
+    ostringstream headerOut;
+    if (srcLen == 0)
+        PgHelpers::writeValue<uint64_t>(headerOut, 0);
+    else if (primedBlock && compLen < srcLen) {
+        PgHelpers::writeValue<uint64_t>(headerOut, srcLen);
+        PgHelpers::writeValue<uint64_t>(headerOut, compLen);
+        PgHelpers::writeValue<uint8_t>(headerOut, PRIMED_LZMA_CODER);
+    } else
+        writeHeader(headerOut, srcLen, compLen, props);
+    const string header = headerOut.str();
+    const unsigned char* data = compLen < srcLen ? compSeq : src;
+    const size_t dataLen = compLen < srcLen ? compLen : srcLen;
+    dest.write(header.data(), header.length());
+    if (dataLen)
+        PgHelpers::writeArray(dest, (void*) data, dataLen);
+}
+
 void writeCompressed(ostream &dest, const char *src, size_t srcLen, CoderProps* props, double estimated_compression) {
     if (srcLen == 0) {
-        PgHelpers::writeValue<uint64_t>(dest, 0);
+        writeStream(dest, (const unsigned char*) src, 0, nullptr, 0, props);
         *PgHelpers::devout << "skipped compression (0 bytes)." << endl;
         return;
     }
     size_t compLen = 0;
     unsigned char* compSeq = Compress(compLen, (const unsigned char*) src, srcLen, props, estimated_compression);
-    writeHeader(dest, srcLen, compLen, props);
-    if (compLen < srcLen) {
-        PgHelpers::writeArray(dest, (void*) compSeq, compLen);
-    } else {
-        PgHelpers::writeArray(dest, (void *) src, srcLen);
-    }
+    writeStream(dest, (const unsigned char*) src, srcLen, compSeq, compLen, props);
     delete[] compSeq;
 }
 
@@ -333,7 +356,14 @@ void writeHeader(ostream &dest, size_t srcLen, size_t destLen, CoderProps *props
     }
 }
 
-vector<string*> prefetchedStreams;
+// lazily prefetched streams (without data) are decompressed from their indexed archive when read
+struct PrefetchedStream {
+    string* data = nullptr;
+    const IndexedArchive* lazySrc = nullptr;
+    uint32_t id = 0;
+};
+
+vector<PrefetchedStream> prefetchedStreams;
 int prefetchedStreamsLimit = 0;
 int prefetchedStreamsRead = 0;
 
@@ -341,11 +371,38 @@ bool areStreamsPrefetched() {
     return prefetchedStreamsRead < prefetchedStreamsLimit;
 }
 
+bool isNextPrefetchedStreamLazy() {
+    return prefetchedStreams[prefetchedStreamsRead].lazySrc != nullptr;
+}
+
+// the stream is skipped if dest is nullptr (a lazy stream is then never decompressed)
+void readPrefetchedStream(string* dest, ostream* logout) {
+    const PrefetchedStream &stream = prefetchedStreams[prefetchedStreamsRead++];
+    if (stream.lazySrc) {
+        if (dest)
+            stream.lazySrc->readStream(stream.id, *dest, logout);
+        return;
+    }
+    if (dest)
+        *dest = std::move(*stream.data);
+    delete(stream.data);
+}
+
+
+uint32_t skipPrefetchedStreams(uint32_t count) {
+    if (prefetchedStreamsRead + (int64_t) count > prefetchedStreamsLimit) {
+        fprintf(stderr, "Missing streams in the archive.\n");
+        exit(EXIT_FAILURE);
+    }
+    const uint32_t id = count ? prefetchedStreams[prefetchedStreamsRead].id : 0;
+    for (uint32_t i = 0; i < count; i++)
+        readPrefetchedStream(nullptr, PgHelpers::devout);
+    return id;
+}
 
 void readCompressed(istream &src, string& dest, ostream* logout) {
     if (areStreamsPrefetched()) {
-        dest = std::move(*prefetchedStreams[prefetchedStreamsRead]);
-        delete(prefetchedStreams[prefetchedStreamsRead++]);
+        readPrefetchedStream(&dest, logout);
         return;
     }
     uint64_t destLen = 0;
@@ -380,7 +437,7 @@ void readCompressed(istream &src, string& dest, ostream* logout) {
 #endif
 }
 
-void readCompressed(unsigned char *src, string& dest, ostream* logout) {
+void uncompressStream(unsigned char *src, string& dest, ostream* logout) {
     uint64_t destLen = 0;
     uint64_t srcLen = 0;
     uint8_t coder_type = 0;
@@ -404,11 +461,15 @@ void readCompressed(unsigned char *src, string& dest, ostream* logout) {
     } else {
         Uncompress((unsigned char *) dest.data(), destLen, src, srcLen, coder_type, logout);
     }
+}
+
+void readCompressed(unsigned char *src, string& dest, ostream* logout) {
+    uncompressStream(src, dest, logout);
 #ifdef DEVELOPER_BUILD
     if (dump_after_decompression) {
         string dumpFileName = dump_after_decompression_prefix + (dump_after_decompression_counter < 10?"0":"");
         PgHelpers::writeArrayToFile(dumpFileName + PgHelpers::toString(dump_after_decompression_counter++),
-                                      (void*) dest.data(), destLen);
+                                      (void*) dest.data(), dest.size());
     }
 #endif
 }
@@ -419,22 +480,90 @@ double simpleUintCompressionEstimate(uint64_t dataMaxValue, uint64_t typeMaxValu
     return dataBits / typeBits;
 }
 
+// the first block (up to offsets[1]) is a preset dictionary of all remaining blocks
+void compressPrimedBlocks(const unsigned char *src, const vector<size_t> &offsets, const CLzmaEncProps* lzmaProps,
+        double estimated_compression, vector<unsigned char*> &compSeqs, vector<size_t> &compLens) {
+    const int blocksCount = offsets.size() - 1;
+    const size_t primingLength = offsets[1];
+    compSeqs.assign(blocksCount, nullptr);
+    compLens.assign(blocksCount, 0);
+#ifdef __APPLE__
+    omp_set_max_active_levels(4);
+#else
+    omp_set_nested(true);
+#endif
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int i = 0; i < blocksCount; i++) {
+        const size_t primeLen = i ? primingLength : 0;
+        CLzmaEncProps blockProps = *lzmaProps;
+        blockProps.reduceSize = primeLen + offsets[i + 1] - offsets[i];
+        if (blockProps.reduceSize >= UINT32_MAX)
+            blockProps.numThreads = 1;
+        int res = LzmaCompressPrimed(compSeqs[i], compLens[i], src + offsets[i], offsets[i + 1] - offsets[i],
+                                     src, primeLen, &blockProps, estimated_compression);
+        if (res != SZ_OK) {
+            fprintf(stderr, "Error during compression of a primed block (code: %d).\n", res);
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+void primedBlocksCompress(ostream &destOut, const unsigned char *src, size_t srcLen, size_t blockSize,
+        ParallelBlocksCoderProps *props, double estimated_compression) {
+    const size_t primingLength = props->primingLength;
+    const int blocksCount = props->numOfBlocks + 1;
+    vector<size_t> offsets(blocksCount + 1, primingLength);
+    offsets[0] = 0;
+    for (int i = 2; i < blocksCount; i++)
+        offsets[i] = offsets[i - 1] + blockSize;
+    offsets[blocksCount] = srcLen;
+    vector<unsigned char*> compSeqs;
+    vector<size_t> compLens;
+    compressPrimedBlocks(src, offsets, ((LzmaCoderProps*) props->blocksCoder)->getProps(), estimated_compression,
+                         compSeqs, compLens);
+    for (int i = 0; i < blocksCount; i++) {
+        writeStream(destOut, src + offsets[i], offsets[i + 1] - offsets[i], compSeqs[i], compLens[i],
+                    props->blocksCoder);
+        delete[] compSeqs[i];
+    }
+}
+
+void writePrimedBlocksCompressed(ostream &dest, const unsigned char *src, const vector<size_t> &offsets,
+        CoderProps *lzmaProps, double estimated_compression) {
+    vector<unsigned char*> compSeqs;
+    vector<size_t> compLens;
+    compressPrimedBlocks(src, offsets, ((LzmaCoderProps*) lzmaProps)->getProps(), estimated_compression,
+                         compSeqs, compLens);
+    for (size_t i = 0; i + 1 < offsets.size(); i++) {
+        writeStream(dest, src + offsets[i], offsets[i + 1] - offsets[i], compSeqs[i], compLens[i], lzmaProps, i > 0);
+        delete[] compSeqs[i];
+    }
+}
+
 int parallelBlocksCompress(unsigned char *&dest, size_t &destLen, const unsigned char *src, size_t srcLen,
         ParallelBlocksCoderProps *props, double estimated_compression, ostream* logout) {
     props->prepare(srcLen);
-    size_t blockSize = ((srcLen / props->numOfBlocks) / props->blockAlignment) * props->blockAlignment;
+    const size_t primingLength = props->primingLength;
+    size_t blockSize = (((srcLen - primingLength) / props->numOfBlocks) / props->blockAlignment)
+            * props->blockAlignment;
     stringstream destOut;
-    PgHelpers::writeValue(destOut, props->numOfBlocks);
-    vector<CompressionJob> cJobs;
-    size_t offset = 0;
-    for (int i = 0; i < props->numOfBlocks - 1; i++) {
-        cJobs.push_back(CompressionJob("block " + toString(i + 1) + "... ", src + offset, blockSize,
-                props->blocksCoder));
-        offset += blockSize;
-    }
-    cJobs.push_back(CompressionJob("block " + toString(props->numOfBlocks) + "... ", src + offset, srcLen - offset,
+    PgHelpers::writeValue(destOut, props->numOfBlocks + (primingLength ? 1 : 0));
+    if (props->getCoderType() == PRIMED_PARALLEL_BLOCKS_CODER_TYPE)
+        PgHelpers::writeValue<uint64_t>(destOut, primingLength);
+    if (primingLength)
+        primedBlocksCompress(destOut, src, srcLen, blockSize, props, estimated_compression);
+    else {
+        vector<CompressionJob> cJobs;
+        size_t offset = 0;
+        for (int i = 0; i < props->numOfBlocks - 1; i++) {
+            cJobs.push_back(CompressionJob("block " + toString(i + 1) + "... ", src + offset, blockSize,
                     props->blocksCoder));
-    CompressionJob::writeCompressedCollectiveParallel(destOut, cJobs, &null_stream);
+            offset += blockSize;
+        }
+        cJobs.push_back(CompressionJob("block " + toString(props->numOfBlocks) + "... ", src + offset,
+                srcLen - offset, props->blocksCoder));
+        CompressionJob::writeCompressedCollectiveParallel(destOut, cJobs, &null_stream);
+    }
     destLen = destOut.tellp();
     dest = new unsigned char[destLen];
     destOut.seekg(0);
@@ -443,10 +572,36 @@ int parallelBlocksCompress(unsigned char *&dest, size_t &destLen, const unsigned
     return SZ_OK;
 }
 
-int parallelBlocksDecompress(unsigned char *dest, size_t *destLen, unsigned char* src, ostream* logout) {
+void primedBlockUncompress(unsigned char* dest, size_t destLen, unsigned char* src, size_t srcLen,
+        const unsigned char* prime, size_t primeLen, ostream* logout) {
+    unsigned char* primedBuf = nullptr;
+    unsigned char* primedDest = dest;
+    if (prime + primeLen != dest) {
+        primedBuf = new unsigned char[primeLen + destLen];
+        memcpy(primedBuf, prime, primeLen);
+        primedDest = primedBuf + primeLen;
+    }
+    size_t outLen = destLen;
+    int res = LzmaUncompress(primedDest, &outLen, src, srcLen, logout, primeLen);
+    if (res != SZ_OK || outLen != destLen) {
+        fprintf(stderr, "Error during decompression of a primed block (code: %d).\n", res);
+        fprintf(stderr, "srcLen: %zu\tdestLen: %zu\tprimeLen: %zu\n", srcLen, destLen, primeLen);
+        exit(EXIT_FAILURE);
+    }
+    if (primedBuf) {
+        memcpy(dest, primedDest, destLen);
+        delete[] primedBuf;
+    }
+}
+
+int parallelBlocksDecompress(unsigned char *dest, size_t *destLen, unsigned char* src, ostream* logout,
+        bool primedMode) {
     chrono::steady_clock::time_point start_t = chrono::steady_clock::now();
     int numOfBlocks;
+    uint64_t primingLength = 0;
     PgHelpers::readValue<int>(src, numOfBlocks);
+    if (primedMode)
+        PgHelpers::readValue<uint64_t>(src, primingLength);
     *logout << "... parallel_blocks (no = " << numOfBlocks << ") of ";
     size_t offset = 0;
 #pragma omp parallel
@@ -469,12 +624,20 @@ int parallelBlocksDecompress(unsigned char *dest, size_t *destLen, unsigned char
                 }
                 if (blockLen == 0)
                     continue;
+                if (i == 0 && primingLength) {
+                    // priming block is required by all remaining blocks
+                    Uncompress(destPtr, blockLen, srcString, srcLen, coder_type, &null_stream);
+                    continue;
+                }
 #pragma omp task
                 {
                     ostringstream tmpout;
-                    ostream* currentOut = i == 0?&tmpout:&null_stream;
-                    Uncompress(destPtr, blockLen, srcString, srcLen, coder_type, currentOut);
-                    if (i == 0) {
+                    ostream* currentOut = i == (primingLength ? 1 : 0)?&tmpout:&null_stream;
+                    if (primingLength && coder_type == LZMA_CODER)
+                        primedBlockUncompress(destPtr, blockLen, srcString, srcLen, dest, primingLength, currentOut);
+                    else
+                        Uncompress(destPtr, blockLen, srcString, srcLen, coder_type, currentOut);
+                    if (currentOut == &tmpout) {
                         string log = tmpout.str();
                         *logout << log.substr(4, log.find("...", 4));
                     }
@@ -520,18 +683,12 @@ void CompressionJob::writeCompressedCollectiveParallel(ostream &dest, vector<Com
         cJobs[i].log.append(localLogOut.str());
     }
     for(int i = 0; i < cJobs.size(); i++) {
+        writeStream(dest, cJobs[i].src, cJobs[i].srcLen, compSeqs[i], compLens[i], cJobs[i].props);
         if (cJobs[i].srcLen == 0) {
-            PgHelpers::writeValue<uint64_t>(dest, 0);
             *PgHelpers::devout << "skipped compression (0 bytes)." << endl;
             continue;
         }
-        writeHeader(dest, cJobs[i].srcLen, compLens[i], cJobs[i].props);
         *logout << "\t" << cJobs[i].log;
-        if (compLens[i] < cJobs[i].srcLen)
-            PgHelpers::writeArray(dest, (void *) compSeqs[i], compLens[i]);
-        else
-            PgHelpers::writeArray(dest, (void *) cJobs[i].src, cJobs[i].srcLen);
-
         delete[] compSeqs[i];
     }
     *logout << "collective compression finished in " << PgHelpers::time_millis(start_t) << " msec." << endl;
@@ -539,23 +696,52 @@ void CompressionJob::writeCompressedCollectiveParallel(ostream &dest, vector<Com
         *PgHelpers::logout << PgHelpers::time_millis(start_t) << "       \t";
 }
 
+void resetPrefetchedStreams() {
+    for (int i = prefetchedStreamsRead; i < prefetchedStreams.size(); i++)
+        delete(prefetchedStreams[i].data);
+    prefetchedStreams.clear();
+    prefetchedStreamsLimit = 0;
+    prefetchedStreamsRead = 0;
+}
+
 void prefetchCompressedCollectiveParallel(istream &src, int streamsLimit) {
-    for (int i = 0; i < streamsLimit; i++)
-        prefetchedStreams.push_back(new string());
-    readCompressedCollectiveParallel(src, prefetchedStreams);
+    resetPrefetchedStreams();
+    prefetchedStreams.resize(streamsLimit);
+    vector<string*> destStrings;
+    for (PrefetchedStream &stream: prefetchedStreams)
+        destStrings.push_back(stream.data = new string());
+    readCompressedCollectiveParallel(src, destStrings);
+    // streams beyond the end of the archive are not prefetched
+    prefetchedStreams.resize(destStrings.size());
     prefetchedStreamsLimit = prefetchedStreams.size();
 }
 
 void readCompressedCollectiveParallel(istream &src, vector<string*>& destStrings, int obsolete_pgrc_compound_coder) {
     int i = 0;
     if (areStreamsPrefetched()) {
+        // lazy streams are decompressed in parallel (pairs of stream and destination indexes)
+        vector<pair<int, int>> lazyStreams;
         for (; i < destStrings.size(); i++) {
-            if (areStreamsPrefetched()) {
-                *destStrings[i] = std::move(*prefetchedStreams[prefetchedStreamsRead]);
-                delete(prefetchedStreams[prefetchedStreamsRead++]);
+            if (!areStreamsPrefetched())
                 continue;
-            }
+            if (isNextPrefetchedStreamLazy() && destStrings[i])
+                lazyStreams.emplace_back(prefetchedStreamsRead++, i);
+            else
+                readPrefetchedStream(destStrings[i], PgHelpers::devout);
         }
+        vector<ostringstream> logOuts(lazyStreams.size());
+#ifdef __APPLE__
+        omp_set_max_active_levels(4);
+#else
+        omp_set_nested(true);
+#endif
+#pragma omp parallel for schedule(dynamic)
+        for (size_t k = 0; k < lazyStreams.size(); k++) {
+            const PrefetchedStream &stream = prefetchedStreams[lazyStreams[k].first];
+            stream.lazySrc->readStream(stream.id, *destStrings[lazyStreams[k].second], &logOuts[k]);
+        }
+        for (size_t k = 0; k < lazyStreams.size(); k++)
+            *PgHelpers::devout << "\t" << logOuts[k].str();
     }
     if (i == destStrings.size())
         return;
@@ -580,16 +766,18 @@ void readCompressedCollectiveParallel(istream &src, vector<string*>& destStrings
                 uint8_t primary_coder_type = 0;
                 string srcString, component;
                 if (prefetchedStreamsLimit == 0 && !prefetchedStreams.empty() && src.peek() == -1) {
-                    for(int j = i; j < prefetchedStreams.size(); j++)
-                        delete(prefetchedStreams[j]);
-                    prefetchedStreams.resize(i);
+                    for(int j = i; j < destStrings.size(); j++)
+                        delete(destStrings[j]);
+                    destStrings.resize(i);
                     assert(i == destStrings.size());
                     continue;
                 }
                 PgHelpers::readValue<uint64_t>(src, destLen);
-                destStrings[i]->resize(destLen);
-                if (destLen == 0)
+                if (destLen == 0) {
+                    if (destStrings[i])
+                        destStrings[i]->clear();
                     continue;
+                }
                 if (obsolete_pgrc_compound_coder == i) {
                     PgHelpers::readValue<uint64_t>(src, compLen);
                     PgHelpers::readValue<uint8_t>(src, coder_type);
@@ -606,8 +794,12 @@ void readCompressedCollectiveParallel(istream &src, vector<string*>& destStrings
                     }
                     PgHelpers::readArray(src, (void *) srcString.data(), srcLen);
                 }
+                if (!destStrings[i])
+                    continue;
 #pragma omp task
                 {
+                    // output is allocated (and first touched) by the decoding thread
+                    destStrings[i]->resize(destLen);
                     if (coder_type == COMPOUND_CODER_TYPE) {
                         logOuts[i] << "\t";
                         if (obsolete_pgrc_compound_coder != i)
@@ -626,6 +818,8 @@ void readCompressedCollectiveParallel(istream &src, vector<string*>& destStrings
 #ifdef DEVELOPER_BUILD
     if (dump_after_decompression)
         for (int i = 0; i < destStrings.size(); i++) {
+            if (!destStrings[i])
+                continue;
             string dumpFileName = dump_after_decompression_prefix + (dump_after_decompression_counter < 10 ? "0" : "");
             PgHelpers::writeArrayToFile(dumpFileName + PgHelpers::toString(dump_after_decompression_counter++),
                                         (void *) destStrings[i]->data(), destStrings[i]->size());
@@ -640,3 +834,198 @@ void readCompressedCollectiveParallel(istream &src, vector<string*>& destStrings
         *PgHelpers::logout << PgHelpers::time_millis(start_t) << "       \t";
 }
 
+
+const static size_t STREAMS_INDEX_ENTRY_LENGTH = 2 * sizeof(uint32_t) + 3 * sizeof(uint64_t) + sizeof(uint8_t);
+const static size_t STREAMS_INDEX_TRAILER_LENGTH = sizeof(uint64_t) + 2 * sizeof(uint32_t) + STREAMS_INDEX_MARK_LENGTH;
+
+void writeStreamsIndex(ostream &dest, const vector<StreamIndexEntry> &index) {
+    const uint64_t indexOffset = dest.tellp();
+    ostringstream indexOut;
+    for (const StreamIndexEntry &entry: index) {
+        PgHelpers::writeValue<uint32_t>(indexOut, entry.id, false);
+        PgHelpers::writeValue<uint64_t>(indexOut, entry.offset, false);
+        PgHelpers::writeValue<uint64_t>(indexOut, entry.length, false);
+        PgHelpers::writeValue<uint64_t>(indexOut, entry.rawLength, false);
+        PgHelpers::writeValue<uint8_t>(indexOut, entry.coderType, false);
+        PgHelpers::writeValue<uint32_t>(indexOut, entry.checksum, false);
+    }
+    const string indexStr = indexOut.str();
+    dest.write(indexStr.data(), indexStr.length());
+    PgHelpers::writeValue<uint64_t>(dest, indexOffset, false);
+    PgHelpers::writeValue<uint32_t>(dest, index.size(), false);
+    PgHelpers::writeValue<uint32_t>(dest, PgHelpers::calculateCRC32(indexStr.data(), indexStr.length()), false);
+    dest.write(STREAMS_INDEX_MARK, STREAMS_INDEX_MARK_LENGTH);
+}
+
+bool readStreamsIndex(const char* archive, size_t archiveLength, vector<StreamIndexEntry> &index) {
+    index.clear();
+    if (archiveLength < STREAMS_INDEX_TRAILER_LENGTH)
+        return false;
+    unsigned char* pos = (unsigned char*) archive + archiveLength - STREAMS_INDEX_TRAILER_LENGTH;
+    uint64_t indexOffset;
+    uint32_t streamsCount, checksum;
+    PgHelpers::readValue<uint64_t>(pos, indexOffset);
+    PgHelpers::readValue<uint32_t>(pos, streamsCount);
+    PgHelpers::readValue<uint32_t>(pos, checksum);
+    const uint64_t indexLength = (uint64_t) streamsCount * STREAMS_INDEX_ENTRY_LENGTH;
+    if (memcmp(pos, STREAMS_INDEX_MARK, STREAMS_INDEX_MARK_LENGTH) != 0 ||
+        indexOffset + indexLength != archiveLength - STREAMS_INDEX_TRAILER_LENGTH ||
+        PgHelpers::calculateCRC32(archive + indexOffset, indexLength) != checksum)
+        return false;
+    pos = (unsigned char*) archive + indexOffset;
+    index.resize(streamsCount);
+    for (uint32_t i = 0; i < streamsCount; i++) {
+        StreamIndexEntry &entry = index[i];
+        PgHelpers::readValue<uint32_t>(pos, entry.id);
+        PgHelpers::readValue<uint64_t>(pos, entry.offset);
+        PgHelpers::readValue<uint64_t>(pos, entry.length);
+        PgHelpers::readValue<uint64_t>(pos, entry.rawLength);
+        PgHelpers::readValue<uint8_t>(pos, entry.coderType);
+        PgHelpers::readValue<uint32_t>(pos, entry.checksum);
+        if (entry.id != i || entry.offset > indexOffset || entry.length > indexOffset - entry.offset)
+            return false;
+    }
+    return true;
+}
+
+bool scanStreamsIndex(const char* archive, size_t streamsOffset, size_t streamsEnd, vector<StreamIndexEntry> &index) {
+    index.clear();
+    size_t offset = streamsOffset;
+    while (offset < streamsEnd) {
+        StreamIndexEntry entry;
+        entry.id = index.size();
+        entry.offset = offset;
+        entry.checksum = 0;
+        entry.coderType = NO_CODER;
+        unsigned char* pos = (unsigned char*) archive + offset;
+        size_t headerLength = sizeof(uint64_t);
+        uint64_t srcLen = 0;
+        if (streamsEnd - offset < headerLength)
+            return false;
+        PgHelpers::readValue<uint64_t>(pos, entry.rawLength);
+        if (entry.rawLength > 0) {
+            headerLength += sizeof(uint64_t) + sizeof(uint8_t);
+            if (streamsEnd - offset < headerLength)
+                return false;
+            PgHelpers::readValue<uint64_t>(pos, srcLen);
+            PgHelpers::readValue<uint8_t>(pos, entry.coderType);
+            if (entry.coderType == COMPOUND_CODER_TYPE)
+                headerLength += sizeof(uint64_t) + sizeof(uint8_t);
+            if (streamsEnd - offset < headerLength || streamsEnd - offset - headerLength < srcLen)
+                return false;
+        }
+        entry.length = headerLength + srcLen;
+        offset += entry.length;
+        index.push_back(entry);
+    }
+    return true;
+}
+
+void calculateStreamsChecksums(const char* archive, vector<StreamIndexEntry> &index) {
+#pragma omp parallel for schedule(dynamic)
+    for (size_t i = 0; i < index.size(); i++)
+        index[i].checksum = PgHelpers::calculateCRC32(archive + index[i].offset, index[i].length);
+}
+
+void readCompressed(const char* archive, const StreamIndexEntry &entry, string& dest, bool verifyChecksum,
+        ostream* logout) {
+    if (verifyChecksum && PgHelpers::calculateCRC32(archive + entry.offset, entry.length) != entry.checksum) {
+        fprintf(stderr, "Checksum mismatch of stream %u (corrupted archive).\n", entry.id);
+        exit(EXIT_FAILURE);
+    }
+    uncompressStream((unsigned char*) archive + entry.offset, dest, logout);
+    if (dest.size() != entry.rawLength) {
+        fprintf(stderr, "Invalid length of stream %u (corrupted archive).\n", entry.id);
+        exit(EXIT_FAILURE);
+    }
+}
+
+void readPrimedCompressed(const char* archive, const StreamIndexEntry &entry, string& dest, const string& prime,
+        bool verifyChecksum, ostream* logout) {
+    if (entry.coderType != PRIMED_LZMA_CODER) {
+        readCompressed(archive, entry, dest, verifyChecksum, logout);
+        return;
+    }
+    if (verifyChecksum && PgHelpers::calculateCRC32(archive + entry.offset, entry.length) != entry.checksum) {
+        fprintf(stderr, "Checksum mismatch of stream %u (corrupted archive).\n", entry.id);
+        exit(EXIT_FAILURE);
+    }
+    unsigned char* src = (unsigned char*) archive + entry.offset;
+    uint64_t destLen = 0;
+    uint64_t srcLen = 0;
+    uint8_t coder_type = 0;
+    PgHelpers::readValue<uint64_t>(src, destLen);
+    PgHelpers::readValue<uint64_t>(src, srcLen);
+    PgHelpers::readValue<uint8_t>(src, coder_type);
+    if (destLen != entry.rawLength || coder_type != PRIMED_LZMA_CODER) {
+        fprintf(stderr, "Invalid header of stream %u (corrupted archive).\n", entry.id);
+        exit(EXIT_FAILURE);
+    }
+    chrono::steady_clock::time_point start_t = chrono::steady_clock::now();
+    dest.resize(destLen);
+    primedBlockUncompress((unsigned char*) dest.data(), destLen, src, srcLen,
+                          (const unsigned char*) prime.data(), prime.size(), logout);
+    *logout << "uncompressed " << srcLen << " bytes to " << destLen << " bytes in "
+            << PgHelpers::time_millis(start_t) << " msec." << endl;
+}
+
+void IndexedArchive::readStream(uint32_t id, string &dest, ostream* logout) const {
+    readCompressed(archive, index[id], dest, verifyChecksums, logout);
+}
+
+void IndexedArchive::readPrimedStream(uint32_t id, string &dest, const string &prime, ostream* logout) const {
+    readPrimedCompressed(archive, index[id], dest, prime, verifyChecksums, logout);
+}
+
+void prefetchCompressedCollectiveParallel(const IndexedArchive &archive, bool lazyMode) {
+    resetPrefetchedStreams();
+    const size_t streamsCount = archive.index.size();
+    prefetchedStreams.resize(streamsCount);
+    prefetchedStreamsLimit = streamsCount;
+    if (lazyMode) {
+        for (size_t i = 0; i < streamsCount; i++) {
+            prefetchedStreams[i].lazySrc = &archive;
+            prefetchedStreams[i].id = i;
+        }
+        return;
+    }
+    chrono::steady_clock::time_point start_t = chrono::steady_clock::now();
+    *PgHelpers::devout << "collective decompression of indexed streams..." << endl;
+    for (size_t i = 0; i < streamsCount; i++)
+        prefetchedStreams[i].data = new string();
+    vector<size_t> order(streamsCount);
+    for (size_t i = 0; i < streamsCount; i++)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+            [&](size_t a, size_t b) { return archive.index[a].length > archive.index[b].length; });
+    vector<ostringstream> logOuts;
+    logOuts.resize(streamsCount);
+#ifdef __APPLE__
+    omp_set_max_active_levels(4);
+#else
+    omp_set_nested(true);
+#endif
+#pragma omp parallel
+    {
+#pragma omp single
+        {
+            for (size_t k = 0; k < streamsCount; k++) {
+                const size_t i = order[k];
+#pragma omp task
+                archive.readStream(i, *prefetchedStreams[i].data, &logOuts[i]);
+            }
+        }
+    }
+#ifdef DEVELOPER_BUILD
+    if (dump_after_decompression)
+        for (size_t i = 0; i < streamsCount; i++) {
+            string dumpFileName = dump_after_decompression_prefix + (dump_after_decompression_counter < 10 ? "0" : "");
+            PgHelpers::writeArrayToFile(dumpFileName + PgHelpers::toString(dump_after_decompression_counter++),
+                                        (void *) prefetchedStreams[i].data->data(), prefetchedStreams[i].data->size());
+        }
+#endif
+    for (size_t i = 0; i < streamsCount; i++)
+        *PgHelpers::devout << "\t" << logOuts[i].str();
+    *PgHelpers::devout << "collective decompression finished in " << PgHelpers::time_millis(start_t) << " msec."
+                       << endl;
+}
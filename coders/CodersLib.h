@@ -22,6 +22,9 @@ const static uint8_t FSE_HUF_CODER = 5;
 const static uint8_t VARLEN_DNA_CODER = 11;
 const static uint8_t COMPOUND_CODER_TYPE = 77;
 const static uint8_t PARALLEL_BLOCKS_CODER_TYPE = 88;
+const static uint8_t PRIMED_PARALLEL_BLOCKS_CODER_TYPE = 89;
+// LZMA block of a separate stream decodable only with the priming block (its preset dictionary)
+const static uint8_t PRIMED_LZMA_CODER = 90;
 const static uint8_t SELECTOR_CODER_TYPE = 99;
 
 const static int LZMA_DATAPERIODCODE_8_t = 0;
@@ -42,6 +45,7 @@ const static double COMPRESSION_ESTIMATION_MIS_SYM = 0.250;
 
 const static int MINIMAL_PARALLEL_BLOCK_LENGTH = 1 << 20;
 const static int PARALLEL_BLOCKS_ALIGNMENT = 1 << 4;
+const static size_t MAX_PARALLEL_BLOCKS_PRIMING_LENGTH = (size_t) 1 << 31;
 
 class CoderProps {
 private:
@@ -150,6 +154,8 @@ void moveStringToVector(string &src, vector<T>& dest) {
     src.shrink_to_fit();
 }
 
+// independently decodable blocks coded in parallel; in the primed mode the priming block (a prefix of the data)
+// is coded first and then used as a preset dictionary of all remaining (LZMA coded) blocks
 class ParallelBlocksCoderProps: public CoderProps {
 public:
 
@@ -157,17 +163,19 @@ public:
     CoderProps* blocksCoder;
     const uint32_t minBlockLength;
     const uint32_t blockAlignment;
+    size_t primingLength;
 
     ParallelBlocksCoderProps(int numOfBlocks, CoderProps* blocksCoder,
             uint32_t minBlockLength = MINIMAL_PARALLEL_BLOCK_LENGTH,
-            uint32_t blockAlignment = PARALLEL_BLOCKS_ALIGNMENT)
-            : CoderProps(PARALLEL_BLOCKS_CODER_TYPE, -1), blocksCoder(blocksCoder),
-              numOfBlocks(numOfBlocks), minBlockLength(minBlockLength),
-              blockAlignment(blockAlignment) { }
+            uint32_t blockAlignment = PARALLEL_BLOCKS_ALIGNMENT, size_t primingLength = 0)
+            : CoderProps(primingLength ? PRIMED_PARALLEL_BLOCKS_CODER_TYPE : PARALLEL_BLOCKS_CODER_TYPE, -1),
+              blocksCoder(blocksCoder), numOfBlocks(numOfBlocks), minBlockLength(minBlockLength),
+              blockAlignment(blockAlignment), primingLength(primingLength) { }
 
     string log() override {
         if (numOfBlocks > 1)
-            return " parallel_blocks (no = " + to_string(numOfBlocks) + ") of" + blocksCoder->log();
+            return " parallel_blocks (no = " + to_string(numOfBlocks) + (primingLength ?
+                "; priming = " + to_string(primingLength >> 10) + "KB" : "") + ") of" + blocksCoder->log();
         else
             return " (skipped blocks)" + blocksCoder->log();
     }
@@ -175,13 +183,16 @@ public:
     ~ParallelBlocksCoderProps() override { };
 
     void prepare(size_t srcLen) {
-        int maxBlocks = srcLen / minBlockLength;
+        if (blocksCoder->getCoderType() != LZMA_CODER || primingLength > MAX_PARALLEL_BLOCKS_PRIMING_LENGTH
+            || primingLength >= srcLen / 2)
+            primingLength = 0;
+        int maxBlocks = (srcLen - primingLength) / minBlockLength;
         if (numOfBlocks > maxBlocks)
             numOfBlocks = maxBlocks;
-        else if (numOfBlocks > maxBlocks)
-            numOfBlocks = maxBlocks;
-        if (numOfBlocks == 0)
+        if (numOfBlocks <= 1) {
             numOfBlocks = 1;
+            primingLength = 0;
+        }
     }
 };
 
@@ -189,7 +200,12 @@ int parallelBlocksCompress(unsigned char *&dest, size_t &destLen, const unsigned
                              ParallelBlocksCoderProps* props, double estimated_compression = 1,
                              ostream* logout = PgHelpers::devout);
 int parallelBlocksDecompress(unsigned char *dest, size_t *destLen, unsigned char *src,
-        ostream* logout = PgHelpers::devout);
+        ostream* logout = PgHelpers::devout, bool primedMode = false);
+
+// blocks of src (delimited by offsets) are written as separate streams; the first block is LZMA coded
+// and used as a preset dictionary of the remaining blocks (written as PRIMED_LZMA_CODER streams)
+void writePrimedBlocksCompressed(ostream &dest, const unsigned char *src, const vector<size_t> &offsets,
+        CoderProps* lzmaProps, double estimated_compression = 1);
 
 class CompressionJob {
 private:
@@ -210,8 +226,53 @@ public:
             ostream* logout = PgHelpers::devout);
 };
 
+// streams with nullptr destinations are skipped
 void readCompressedCollectiveParallel(istream &src, vector<string*> &destStrings, int obsolete_pgrc_compound_coder = -1);
 void prefetchCompressedCollectiveParallel(istream &src, int streamsLimit = 1024);
+// skips lazily prefetched streams (to be read through the index) returning the index id of the first one
+uint32_t skipPrefetchedStreams(uint32_t count);
+
+// index of streams (table of contents) written in the footer of seekable archives
+const static char* const STREAMS_INDEX_MARK = "PgRC-TOC";
+const static size_t STREAMS_INDEX_MARK_LENGTH = 8;
+
+struct StreamIndexEntry {
+    uint32_t id;
+    uint64_t offset; // of the stream header in the archive
+    uint64_t length; // including the stream header
+    uint64_t rawLength;
+    uint8_t coderType;
+    uint32_t checksum; // CRC-32 of the stream (including its header)
+};
+
+// index of consecutive streams written to the archive (from the offset of the first stream to its end)
+void writeStreamsIndex(ostream &dest, const vector<StreamIndexEntry> &index);
+// returns false if the archive has no valid streams index
+bool readStreamsIndex(const char* archive, size_t archiveLength, vector<StreamIndexEntry> &index);
+// indexes consecutive streams by their headers (for archives without an index; checksums are not available)
+bool scanStreamsIndex(const char* archive, size_t streamsOffset, size_t streamsEnd, vector<StreamIndexEntry> &index);
+// checksums of scanned streams are calculated in parallel
+void calculateStreamsChecksums(const char* archive, vector<StreamIndexEntry> &index);
+void readCompressed(const char* archive, const StreamIndexEntry &entry, string& dest, bool verifyChecksum = true,
+        ostream* logout = PgHelpers::devout);
+// decompresses a PRIMED_LZMA_CODER stream using the decompressed priming block (other streams as usual)
+void readPrimedCompressed(const char* archive, const StreamIndexEntry &entry, string& dest, const string& prime,
+        bool verifyChecksum = true, ostream* logout = PgHelpers::devout);
+
+// streams of a (memory mapped) archive accessed through its index
+struct IndexedArchive {
+    const char* archive = nullptr;
+    vector<StreamIndexEntry> index;
+    bool verifyChecksums = true;
+
+    void readStream(uint32_t id, string &dest, ostream* logout = PgHelpers::devout) const;
+    void readPrimedStream(uint32_t id, string &dest, const string &prime, ostream* logout = PgHelpers::devout) const;
+};
+
+// streams are decompressed directly from the archive in any order (the largest first)
+// or, in lazy mode, only when they are read (skipped streams are never decompressed;
+// the archive has to stay mapped and its index available until all streams are read)
+void prefetchCompressedCollectiveParallel(const IndexedArchive &archive, bool lazyMode = false);
 
 class SelectorCoderProps: public CoderProps {
 public:
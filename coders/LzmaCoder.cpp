@@ -14,6 +14,22 @@ MY_STDAPI LzmaCompress(unsigned char *&dest, size_t &destLen, const unsigned cha
     props->reduceSize = srcLen;
     if (srcLen >= UINT32_MAX)
         props->numThreads = 1;
+    int res = LzmaCompressPrimed(dest, destLen, src, srcLen, nullptr, 0, props, estimated_compression);
+    LzmaEncProps_Normalize(props);
+    return res;
+}
+
+MY_STDAPI LzmaCompressPrimed(unsigned char *&dest, size_t &destLen, const unsigned char *src, size_t srcLen,
+                             const unsigned char *prime, size_t primeLen, const CLzmaEncProps* props,
+                             double estimated_compression) {
+    const unsigned char* primedSrc = primeLen ? prime : src;
+    unsigned char* primedBuf = nullptr;
+    if (primeLen && prime + primeLen != src) {
+        primedBuf = new unsigned char[primeLen + srcLen];
+        memcpy(primedBuf, prime, primeLen);
+        memcpy(primedBuf + primeLen, src, srcLen);
+        primedSrc = primedBuf;
+    }
     size_t propsSize = LZMA_PROPS_SIZE;
     size_t maxDestSize = propsSize + (srcLen + srcLen / 3) * estimated_compression + 128;
     try {
@@ -24,9 +40,9 @@ MY_STDAPI LzmaCompress(unsigned char *&dest, size_t &destLen, const unsigned cha
         dest = new unsigned char[maxDestSize];
     }
     destLen = maxDestSize - propsSize;
-    int res = LzmaEncode(dest + LZMA_PROPS_SIZE, &destLen, src, srcLen, props, dest, &propsSize, 0,
-                         NULL, &g_Alloc, &g_Alloc);
-    LzmaEncProps_Normalize(props);
+    int res = LzmaEncodePrimed(dest + LZMA_PROPS_SIZE, &destLen, primedSrc, primeLen + srcLen, primeLen,
+                               props, dest, &propsSize, 0, NULL, &g_Alloc, &g_Alloc);
+    delete[] primedBuf;
     assert(propsSize == LZMA_PROPS_SIZE);
     destLen += propsSize;
     return res;
@@ -34,7 +50,8 @@ MY_STDAPI LzmaCompress(unsigned char *&dest, size_t &destLen, const unsigned cha
 
 #define RC_INIT_SIZE 5
 
-MY_STDAPI LzmaUncompress(unsigned char *dest, size_t *destLen, const unsigned char *src, size_t srcLen, ostream* logout) {
+MY_STDAPI LzmaUncompress(unsigned char *dest, size_t *destLen, const unsigned char *src, size_t srcLen, ostream* logout,
+                         size_t primeLen) {
     size_t propsSize = LZMA_PROPS_SIZE;
     *logout << "... lzma ... ";
     unsigned char propsBuf[LZMA_PROPS_SIZE];
@@ -49,17 +66,22 @@ MY_STDAPI LzmaUncompress(unsigned char *dest, size_t *destLen, const unsigned ch
         return SZ_ERROR_INPUT_EOF;
     LzmaDec_Construct(&p);
     RINOK(LzmaDec_AllocateProbs(&p, propsBuf, propsSize, &g_Alloc));
-    p.dic = dest;
-    p.dicBufSize = outSize;
+    p.dic = dest - primeLen;
+    p.dicBufSize = primeLen + outSize;
     LzmaDec_Init(&p);
+    if (primeLen) {
+        p.dicPos = primeLen;
+        p.processedPos = primeLen;
+        p.checkDicSize = primeLen >= p.prop.dicSize ? p.prop.dicSize : 0;
+    }
     Int64 srcLeftCount = inSize;
     do {
         size_t srcBufSize = srcLeftCount;
         srcLen = srcBufSize;
         srcLeftCount -= srcBufSize;
-        res = LzmaDec_DecodeToDic(&p, outSize, src + propsSize, &srcLen, LZMA_FINISH_ANY, &status);
+        res = LzmaDec_DecodeToDic(&p, primeLen + outSize, src + propsSize, &srcLen, LZMA_FINISH_ANY, &status);
     } while (srcLeftCount && status == LZMA_STATUS_NEEDS_MORE_INPUT);
-    *destLen = p.dicPos;
+    *destLen = p.dicPos - primeLen;
     if (res == SZ_OK && status == LZMA_STATUS_NEEDS_MORE_INPUT)
         res = SZ_ERROR_INPUT_EOF;
     LzmaDec_FreeProbs(&p, &g_Alloc);
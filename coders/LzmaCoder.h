@@ -115,7 +115,13 @@ public:
 MY_STDAPI LzmaCompress(unsigned char *&dest, size_t &destLen, const unsigned char *src, size_t srcLen,
                        CLzmaEncProps* props, double estimated_compression);
 
+// encodes src using primeLen bytes of prime as a preset dictionary (props should have reduceSize set)
+MY_STDAPI LzmaCompressPrimed(unsigned char *&dest, size_t &destLen, const unsigned char *src, size_t srcLen,
+                             const unsigned char *prime, size_t primeLen, const CLzmaEncProps* props,
+                             double estimated_compression);
+
+// primed streams are decoded with primeLen bytes of the preset dictionary preceding dest
 MY_STDAPI LzmaUncompress(unsigned char *dest, size_t *destLen, const unsigned char *src, size_t srcLen,
-        ostream* logout = PgHelpers::devout);
+        ostream* logout = PgHelpers::devout, size_t primeLen = 0);
 
 #endif //PGTOOLS_LZMACODER_H
@@ -11,7 +11,7 @@ LzmaCoderProps* getDefaulLzmaCoderProps(int coder_level, int dataPeriodCode = -1
     int noOfThreads = PgHelpers::numberOfThreads > 1 ? 2 : 1;
     switch(coder_level) {
         case CODER_LEVEL_FAST:
-            return new LzmaCoderProps(5, 1 << 24, 3, dataPeriodCode, dataPeriodCode, 6, -1, noOfThreads);
+            return new LzmaCoderProps(5, 1 << 22, 3, dataPeriodCode, dataPeriodCode, 16, 0, noOfThreads);
         case CODER_LEVEL_NORMAL:
             return new LzmaCoderProps(9, 3 << 29, 3, dataPeriodCode, dataPeriodCode, 128, -1, noOfThreads);
         case CODER_LEVEL_MAX:
@@ -54,6 +54,8 @@ unique_ptr<CoderProps> getDefaultCoderProps(uint8_t coder_type, uint8_t coder_le
         case LZMA_CODER:
             return unique_ptr<CoderProps>(getDefaulLzmaCoderProps(coder_level, coder_param));
         case PPMD7_CODER:
+            if (coder_level == CODER_LEVEL_FAST)
+                return getDefaultFSECoderProps();
             return unique_ptr<CoderProps>(getDefaultPpmdCoderProps(coder_level, coder_param));
         case RANGE_CODER:
             return unique_ptr<CoderProps>(getRangeCoderProps(coder_param, 1));
@@ -72,6 +74,12 @@ unique_ptr<CoderProps> getCompoundCoderProps(CoderProps* firstCoderProps, CoderP
     return unique_ptr<CoderProps>(new CompoundCoderProps(firstCoderProps, secondCoderProps));
 }
 
+unique_ptr<CoderProps> getParallelBlocksCoderProps(CoderProps* blocksCoderProps, int numOfBlocks,
+                                                   size_t primingLength) {
+    return unique_ptr<CoderProps>(new ParallelBlocksCoderProps(numOfBlocks, blocksCoderProps,
+            MINIMAL_PARALLEL_BLOCK_LENGTH, PARALLEL_BLOCKS_ALIGNMENT, primingLength));
+}
+
 unique_ptr<CoderProps> getSelectorCoderProps(std::initializer_list<CoderProps*> coderPropsList, float probeFraction,
                                              size_t minProbeSize) {
     if (coderPropsList.size() <= 1) {
@@ -92,8 +100,8 @@ unique_ptr<CoderProps> getReadsPositionsCoderProps(uint8_t coder_level, uint8_t
     int lc = 8;
     switch(coder_level) {
         case CODER_LEVEL_FAST:
-            return unique_ptr<CoderProps>(new LzmaCoderProps(9, 1 << 20, lc,
-                    lzma_pos_dataperiod_param, lzma_pos_dataperiod_param, 5, 1, noOfThreads));
+            // positions are almost random within the pseudogenome (little gain from LZMA context modelling)
+            return getDefaultFSECoderProps();
         case CODER_LEVEL_NORMAL:
             return unique_ptr<CoderProps>(new LzmaCoderProps(9, 8 << 20, lc,
                     lzma_pos_dataperiod_param, lzma_pos_dataperiod_param, 16, 1, noOfThreads));
@@ -106,12 +114,18 @@ unique_ptr<CoderProps> getReadsPositionsCoderProps(uint8_t coder_level, uint8_t
     }
 }
 
+unique_ptr<CoderProps> getPgMappingOffsetsCoderProps(uint8_t coder_level, int lzma_pos_dataperiod_param) {
+    if (coder_level == CODER_LEVEL_FAST)
+        return getDefaultFSECoderProps();
+    return getDefaultCoderProps(LZMA_CODER, coder_level, lzma_pos_dataperiod_param);
+}
+
 unique_ptr<CoderProps> getVarLenEncodedPgCoderProps(uint8_t coder_level) {
     int noOfThreads = PgHelpers::numberOfThreads > 1 ? 2 : 1;
     switch(coder_level) {
         case CODER_LEVEL_FAST:
-            return unique_ptr<CoderProps>(new LzmaCoderProps(9, 1 << 24, 8,
-                    LZMA_DATAPERIODCODE_8_t, LZMA_DATAPERIODCODE_8_t, 16, 1, noOfThreads));
+            // var-len DNA codes are only entropy coded (tANS)
+            return getDefaultFSECoderProps();
         case CODER_LEVEL_NORMAL:
             return unique_ptr<CoderProps>(new LzmaCoderProps(9, 3 << 29, 8,
                     LZMA_DATAPERIODCODE_8_t, LZMA_DATAPERIODCODE_8_t, 32, 1, noOfThreads));
@@ -128,8 +142,8 @@ unique_ptr<CoderProps> getRelativeOffsetDeltasOfPairsValueCoderProps(uint8_t cod
     int noOfThreads = PgHelpers::numberOfThreads > 1 ? 2 : 1;
     switch(coder_level) {
         case CODER_LEVEL_FAST:
-            return unique_ptr<CoderProps>(new LzmaCoderProps(9, 1 << 24, 8,
-                    LZMA_DATAPERIODCODE_8_t, LZMA_DATAPERIODCODE_8_t, 5, 1, noOfThreads));
+            return unique_ptr<CoderProps>(new LzmaCoderProps(9, 1 << 22, 8,
+                    LZMA_DATAPERIODCODE_8_t, LZMA_DATAPERIODCODE_8_t, 5, 0, noOfThreads));
         case CODER_LEVEL_NORMAL:
             return unique_ptr<CoderProps>(new LzmaCoderProps(9, 3 << 29, 8,
                     LZMA_DATAPERIODCODE_8_t, LZMA_DATAPERIODCODE_8_t, 16, 1, noOfThreads));
@@ -13,11 +13,17 @@ unique_ptr<CoderProps> getDefaultHufCoderProps(uint8_t tableLog = 0, uint8_t max
 
 unique_ptr<CoderProps> getCompoundCoderProps(CoderProps* firstCoderProps, CoderProps* secondCoderProps);
 
+unique_ptr<CoderProps> getParallelBlocksCoderProps(CoderProps* blocksCoderProps, int numOfBlocks,
+                                                   size_t primingLength = 0);
+
 unique_ptr<CoderProps> getSelectorCoderProps(std::initializer_list<CoderProps*> coderPropsList, float probeFraction = 1,
                                              size_t minProbeSize = SelectorCoderProps::DEFAULT_MIN_PROBE_SIZE);
 
 unique_ptr<CoderProps> getReadsPositionsCoderProps(uint8_t coder_level, uint8_t lzma_pos_dataperiod_param);
 
+// offsets of pseudogenomes mapping (FSE coded in the fast mode)
+unique_ptr<CoderProps> getPgMappingOffsetsCoderProps(uint8_t coder_level, int lzma_pos_dataperiod_param);
+
 unique_ptr<CoderProps> getVarLenEncodedPgCoderProps(uint8_t coder_level);
 
 unique_ptr<CoderProps> getRelativeOffsetDeltasOfPairsValueCoderProps(uint8_t coder_level);
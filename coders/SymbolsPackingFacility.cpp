@@ -24,7 +24,7 @@ namespace PgIndex {
             cout << "ERROR in symbols packaging: max value for type: " << (int) (uint8_t) - 1 << " while max " << " \n";
 
         reverse = new char_pg*[combinationCount];
-        reverseFlat = new char_pg[combinationCount * symbolsPerElement];
+        reverseFlat = new char_pg[combinationCount * symbolsPerElement + sizeof(uint64_t)];
 
         clear = new uint8_t*[combinationCount];
         clearFlat = new uint8_t[combinationCount * symbolsPerElement];
@@ -46,7 +46,7 @@ namespace PgIndex {
             cout << "ERROR in symbols packaging: max value for type: " << (int) (uint8_t) - 1 << " while max " << " \n";
 
         reverse = new char_pg*[combinationCount];
-        reverseFlat = new char_pg[combinationCount * symbolsPerElement];
+        reverseFlat = new char_pg[combinationCount * symbolsPerElement + sizeof(uint64_t)];
 
         clear = new uint8_t*[combinationCount];
         clearFlat = new uint8_t[combinationCount * symbolsPerElement];
@@ -345,31 +345,24 @@ namespace PgIndex {
                                                                                     const char *pattern,
                                                                                     uint_read_len_max length,
                                                                                     uint8_t maxMismatches) {
+        // sequence is unpacked in chunks (by whole elements) and compared using a vectorized kernel
+        char_pg unpacked[UNPACKED_CHUNK_LENGTH + sizeof(uint64_t)];
         uint8_t res = 0;
-        uint_max i = length;
-        while (i >= symbolsPerElement) {
-            uint_ps_element_min pSeq = packSymbols(pattern);
-            if (*seq != pSeq) {
-                for(uint8_t j = 0; j < symbolsPerElement; j++) {
-                    if (reverse[*seq][j] != *pattern++)
-                        if (res++ >= maxMismatches)
-                            return UINT8_MAX;
-                }
-            } else
-                pattern += symbolsPerElement;
-            seq++;
-            i -= symbolsPerElement;
-        }
-
-        int j = 0;
-        while (i--) {
-            if (reverse[*seq][j] != *pattern++) {
-                if (res++ >= maxMismatches)
-                    return UINT8_MAX;
+        while (length > 0) {
+            const uint_read_len_max chunkLength = length < UNPACKED_CHUNK_LENGTH ? length : UNPACKED_CHUNK_LENGTH;
+            char_pg* ptr = unpacked;
+            char_pg* const chunkEnd = unpacked + chunkLength;
+            while (ptr < chunkEnd) {
+                memcpy(ptr, reverse[*seq++], sizeof(uint64_t));
+                ptr += symbolsPerElement;
             }
-            j++;
+            const uint8_t chunkRes = countSymbolsMismatches(unpacked, pattern, chunkLength, maxMismatches - res);
+            if (chunkRes == UINT8_MAX)
+                return UINT8_MAX;
+            res += chunkRes;
+            pattern += chunkLength;
+            length -= chunkLength;
         }
-
         return res;
     }
 
@@ -2,6 +2,7 @@
 #define	SYMBOLSPACKINGFACILITY_H
 
 #include "../utils/helper.h"
+#include "../utils/mismatches.h"
 #include "../pgrc/pg-config.h"
 #include "../readsset/ReadsSetBase.h"
 
@@ -14,6 +15,8 @@ namespace PgIndex {
 
             const static uint16_t PACK_LUT_SIZE = 1 << 11;
             const static uint16_t PACK_MASK = PACK_LUT_SIZE - 1;
+            // divisible by any possible number of symbols per element
+            const static uint16_t UNPACKED_CHUNK_LENGTH = 240;
 
             uint_max maxValue;
             const uint_symbols_cnt symbolsCount;
@@ -28,6 +31,7 @@ namespace PgIndex {
             uchar symbolsPerLUT1;
 
             // for a given value reverse[value][pos] returns character at the given position
+            // (reverseFlat is padded to allow reading 8 bytes at reverse[maxValue])
             char_pg** reverse;
             char_pg* reverseFlat;
             
@@ -89,6 +93,39 @@ namespace PgIndex {
             uint8_t countSequenceMismatchesVsUnpacked(uint_ps_element_min *seq, const char *pattern, uint_read_len_max length,
                                               uint8_t maxMismatches);
 
+            uchar getSymbolsPerElement() const { return symbolsPerElement; };
+
+            // 4 symbols packed per element (2 bits per symbol, first symbol in the most significant bits), so that
+            // a packed sequence read as big-endian 64-bit words holds 32 consecutive symbols in order
+            bool isTwoBitsPerSymbolLayout() const { return symbolsCount == 4 && symbolsPerElement == 4; };
+
+            // bytes required after the last packed sequence for word-level access
+            static const uint8_t WORD_ACCESS_PADDING = sizeof(uint64_t);
+
+            static inline uint64_t loadTwoBitsWord(const uint8_t* seq, uint_max pos) {
+                uint64_t word;
+                memcpy(&word, seq + (pos >> 2), sizeof(word));
+                return __builtin_bswap64(word) << ((pos & 3) << 1);
+            }
+
+            // compares length symbols of 2-bit layout sequences starting at lPos and rPos (returns -1, 0 or 1)
+            static inline int compareTwoBitsSequences(const uint8_t* lSeq, uint_max lPos,
+                                                      const uint8_t* rSeq, uint_max rPos, uint_max length) {
+                const uint_max stepSymbols = ((lPos | rPos) & 3) ? 28 : 32;
+                while (length > 0) {
+                    const uint_max n = length < stepSymbols ? length : stepSymbols;
+                    const uint64_t mask = UINT64_MAX << (64 - (n << 1));
+                    const uint64_t lWord = loadTwoBitsWord(lSeq, lPos) & mask;
+                    const uint64_t rWord = loadTwoBitsWord(rSeq, rPos) & mask;
+                    if (lWord != rWord)
+                        return lWord < rWord ? -1 : 1;
+                    lPos += n;
+                    rPos += n;
+                    length -= n;
+                }
+                return 0;
+            }
+
             static SymbolsPackingFacility ACGTPacker, ACGTNPacker;
 
             static SymbolsPackingFacility *getInstance(ReadsSetProperties *properties, uchar symbolsPerElement);
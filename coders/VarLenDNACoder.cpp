@@ -25,24 +25,57 @@ void PgHelpers::VarLenDNACoder::initUsing(const string &codes) {
         exit(EXIT_FAILURE);
     }
 
-    codeLUT = new uint8_t[CODE_LUT_SIZE];
-    memset(codeLUT, NOT_FOUND_CODE, CODE_LUT_SIZE);
+    uint8_t symbolsCount = 0;
     for (int i = 0; i < counter; i++) {
-        uint32_t temp = 0;
-        memcpy(&temp, codeBook[i], MAX_CODE_LENGTH);
-        codeLUT[temp & CODE_LUT_MASK] = i;
+        for (char* ptr = codeBook[i]; *ptr; ptr++) {
+            uint8_t &symbol = symbolLUT[(uint8_t) *ptr];
+            if (symbol)
+                continue;
+            if (symbolsCount == MAX_NUMBER_OF_SYMBOLS) {
+                fprintf(stderr, "Too many symbols in the var-len coder book!");
+                exit(EXIT_FAILURE);
+            }
+            symbol = ++symbolsCount;
+        }
+    }
+    uint8_t exactCodeLUT[CODE_LUT_SIZE] = {};
+    for (int i = 0; i < counter; i++) {
+        uint32_t key = 0;
+        for (int j = 0; codeBook[i][j]; j++)
+            key |= (uint32_t) symbolLUT[(uint8_t) codeBook[i][j]] << (j * SYMBOL_BITS);
+        if (key)
+            exactCodeLUT[key] = i;
+    }
+    // resolves the longest code being a prefix of each symbols combination
+    // (unknown symbols are encoded using the not found code)
+    for (uint32_t key = 0; key < CODE_LUT_SIZE; key++) {
+        uint8_t length = MAX_CODE_LENGTH;
+        uint32_t prefixKey = key;
+        while (length > 1 && exactCodeLUT[prefixKey] == NOT_FOUND_CODE)
+            prefixKey &= (1 << (--length * SYMBOL_BITS)) - 1;
+        codeLUT[key] = exactCodeLUT[prefixKey];
+        codeLengthLUT[key] = length;
     }
 }
 
-PgHelpers::VarLenDNACoder::~VarLenDNACoder() {
-    delete[] codeLUT;
+const PgHelpers::VarLenDNACoder& PgHelpers::VarLenDNACoder::getStaticCoder(uint8_t staticCodeBookID) {
+    if (staticCodeBookID >= VARLEN_CODEBOOKS_COUNT) {
+        fprintf(stderr, "Unknown var-len coder static codebook id: %d.\n", staticCodeBookID);
+        exit(EXIT_FAILURE);
+    }
+    static const VarLenDNACoder staticCoders[VARLEN_CODEBOOKS_COUNT] = {
+            VarLenDNACoder((uint8_t) AG_EXTENDED_CODES_ID),
+            VarLenDNACoder((uint8_t) SYNC_ON_A_CODES_ID),
+            VarLenDNACoder((uint8_t) AG_SHORT_EXTENDED_CODES_ID)
+    };
+    return staticCoders[staticCodeBookID];
 }
 
 void
-PgHelpers::VarLenDNACoder::writeBook(unsigned char *dest, size_t &destLen) {
+PgHelpers::VarLenDNACoder::writeBook(unsigned char *dest, size_t &destLen) const {
     uint8_t* destPtr = dest;
     for (size_t i = 0; i < MAX_NUMBER_OF_CODES; i++) {
-        char* ptr = codeBook[i];
+        const char* ptr = codeBook[i];
         while(*ptr)
             *(destPtr++) = *(ptr++);
         *(destPtr++) = '\n';
@@ -52,62 +85,30 @@ PgHelpers::VarLenDNACoder::writeBook(unsigned char *dest, size_t &destLen) {
 }
 
 void
-PgHelpers::VarLenDNACoder::encode(unsigned char *dest, size_t &destLen, const unsigned char *src, size_t srcLen) {
+PgHelpers::VarLenDNACoder::encode(unsigned char *dest, size_t &destLen, const unsigned char *src, size_t srcLen) const {
     assert(MAX_CODE_LENGTH == 4);
     destLen = 0;
     size_t pos = 0;
-    while (pos <= srcLen - 4) {
-        uint32_t temp = 0;
-        memcpy(&temp, src + pos, 4);
-        temp &= CODE_LUT_MASK;
-        if (codeLUT[temp] != NOT_FOUND_CODE) {
-            dest[destLen++] = codeLUT[temp];
-            pos += 4;
-            continue;
-        }
-        temp &= 0x00FFFFFF;
-        if (codeLUT[temp] != NOT_FOUND_CODE) {
-            dest[destLen++] = codeLUT[temp];
-            pos += 3;
-            continue;
-        }
-        temp &= 0x0000FFFF;
-        if (codeLUT[temp] != NOT_FOUND_CODE) {
-            dest[destLen++] = codeLUT[temp];
-            pos += 2;
-            continue;
-        }
-        temp &= 0x000000FF;
-        dest[destLen++] = codeLUT[temp];
-        pos++;
+    while (pos + MAX_CODE_LENGTH <= srcLen) {
+        const uint32_t key = symbolLUT[src[pos]] | symbolLUT[src[pos + 1]] << SYMBOL_BITS |
+                symbolLUT[src[pos + 2]] << (2 * SYMBOL_BITS) | symbolLUT[src[pos + 3]] << (3 * SYMBOL_BITS);
+        dest[destLen++] = codeLUT[key];
+        pos += codeLengthLUT[key];
     }
     while (pos < srcLen) {
-        uint32_t temp = 0;
-        memcpy(&temp, src + pos, srcLen - pos);
-        temp &= CODE_LUT_MASK;
-        temp &= 0x00FFFFFF;
-        if (srcLen - pos >= 3 && codeLUT[temp] != NOT_FOUND_CODE) {
-            dest[destLen++] = codeLUT[temp];
-            pos += 3;
-            continue;
-        }
-        temp &= 0x0000FFFF;
-        if (srcLen - pos >= 2 && codeLUT[temp] != NOT_FOUND_CODE) {
-            dest[destLen++] = codeLUT[temp];
-            pos += 2;
-            continue;
-        }
-        temp &= 0x000000FF;
-        dest[destLen++] = codeLUT[temp];
-        pos++;
+        uint32_t key = 0;
+        for (size_t i = 0; pos + i < srcLen && i < MAX_CODE_LENGTH; i++)
+            key |= (uint32_t) symbolLUT[src[pos + i]] << (i * SYMBOL_BITS);
+        dest[destLen++] = codeLUT[key];
+        pos += codeLengthLUT[key];
     }
 }
 
-int PgHelpers::VarLenDNACoder::decode(unsigned char *dest, size_t expDestLen, unsigned char *src, size_t srcLen) {
+int PgHelpers::VarLenDNACoder::decode(unsigned char *dest, size_t expDestLen, unsigned char *src, size_t srcLen) const {
     uint8_t* destPtr = dest;
     for (size_t i = 0; i < srcLen; i++) {
         uint8_t code = src[i];
-        char* ptr = codeBook[code];
+        const char* ptr = codeBook[code];
         while(*ptr)
             *(destPtr++) = *(ptr++);
     }
@@ -131,12 +132,12 @@ PgHelpers::VarLenDNACoder::Compress(unsigned char *&dest, size_t &destLen, const
         maxDestSize -= srcLen / 3 * COMPRESSION_ESTIMATION;
         dest = new unsigned char[maxDestSize];
     }
-    VarLenDNACoder* coder;
+    const VarLenDNACoder* coder;
     dest[0] = props->mode;
     dest[1] = props->staticCodeBookID;
     switch (props->mode) {
         case STATIC_CODES_CODER_PARAM:
-            coder = new VarLenDNACoder(props->staticCodeBookID);
+            coder = &getStaticCoder(props->staticCodeBookID);
             break;
         default:
             fprintf(stderr, "Unsupported %d PgRC var-len coder parameter.\n", (int) props->staticCodeBookID);
@@ -145,7 +146,6 @@ PgHelpers::VarLenDNACoder::Compress(unsigned char *&dest, size_t &destLen, const
     coder->writeBook(dest + headerSize, destLen);
     headerSize += destLen;
     coder->encode(dest + headerSize, destLen, src, srcLen);
-    delete(coder);
     destLen += headerSize;
     if (destLen > maxDestSize)
         fprintf(stderr, "WARNING: exceeded maximum destination size: %ld .\n", maxDestSize);
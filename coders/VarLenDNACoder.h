@@ -29,14 +29,20 @@ namespace PgHelpers {
 
         const static uint32_t MAX_NUMBER_OF_CODES = UINT8_MAX + 1;
         const static uint8_t MAX_CODE_LENGTH = 4;
-        const static uint32_t CODE_LUT_SIZE = 1 << 27;
-        const static uint32_t CODE_LUT_MASK = CODE_LUT_SIZE - 1;
         const static uint8_t NOT_FOUND_CODE = 0;
 
+        // codes are looked up by up to MAX_CODE_LENGTH symbols packed on SYMBOL_BITS each
+        // (symbol 0 stands for a character absent from the codebook or past the end of input)
+        const static uint8_t SYMBOL_BITS = 3;
+        const static uint8_t MAX_NUMBER_OF_SYMBOLS = (1 << SYMBOL_BITS) - 1;
+        const static uint32_t CODE_LUT_SIZE = 1 << (SYMBOL_BITS * MAX_CODE_LENGTH);
+
         const static size_t VAR_LEN_PROPS_SIZE = 2;
         const static size_t MAX_CODEBOOK_SIZE = 2 + (MAX_CODE_LENGTH + 1) * MAX_NUMBER_OF_CODES;
 
-        uint8_t* codeLUT;
+        uint8_t symbolLUT[UINT8_MAX + 1] = {};
+        uint8_t codeLUT[CODE_LUT_SIZE] = {};
+        uint8_t codeLengthLUT[CODE_LUT_SIZE] = {};
         char codeBook[MAX_NUMBER_OF_CODES][MAX_CODE_LENGTH + 1] = {};
 
         const static string AG_EXTENDED_CODES;
@@ -48,16 +54,18 @@ namespace PgHelpers {
     public:
         VarLenDNACoder(const string &codes);
         VarLenDNACoder(uint8_t staticCodeBookID);
-        ~VarLenDNACoder();
+
+        // immutable coder of a static codebook (built once and shared by all threads)
+        static const VarLenDNACoder& getStaticCoder(uint8_t staticCodeBookID);
 
         static int Compress(unsigned char *&dest, size_t &destLen, const unsigned char *src, size_t srcLen,
                             VarLenDNACoderProps* props);
         static int Uncompress(unsigned char *dest, size_t *destLen, unsigned char *src, size_t srcLen);
 
-        void writeBook(unsigned char *dest, size_t &destLen);
-        void encode(unsigned char *dest, size_t &destLen, const unsigned char *src, size_t srcLen);
+        void writeBook(unsigned char *dest, size_t &destLen) const;
+        void encode(unsigned char *dest, size_t &destLen, const unsigned char *src, size_t srcLen) const;
         static string readBook(unsigned char *src);
-        int decode(unsigned char *dest, size_t expDestLen, unsigned char *src, size_t srcLen);
+        int decode(unsigned char *dest, size_t expDestLen, unsigned char *src, size_t srcLen) const;
 
         enum CODEBOOK_ID {
             AG_EXTENDED_CODES_ID,
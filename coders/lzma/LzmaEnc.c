@@ -3077,8 +3077,10 @@ unsigned LzmaEnc_IsWriteEndMark(CLzmaEncHandle p)
 }
 
 
-SRes LzmaEnc_MemEncode(CLzmaEncHandle p, Byte *dest, SizeT *destLen, const Byte *src, SizeT srcLen,
-    int writeEndMark, ICompressProgressPtr progress, ISzAllocPtr alloc, ISzAllocPtr allocBig)
+/* first (primeLen) bytes of (src) are not encoded and are used only as a preset dictionary;
+   the decoder must use the same bytes as already decoded data preceding the encoded data */
+static SRes LzmaEnc_MemEncodePrimed(CLzmaEncHandle p, Byte *dest, SizeT *destLen, const Byte *src, SizeT srcLen,
+    SizeT primeLen, int writeEndMark, ICompressProgressPtr progress, ISzAllocPtr alloc, ISzAllocPtr allocBig)
 {
   SRes res;
   // GET_CLzmaEnc_p
@@ -3094,6 +3096,23 @@ SRes LzmaEnc_MemEncode(CLzmaEncHandle p, Byte *dest, SizeT *destLen, const Byte
   p->rc.outStream = &outStream.vt;
 
   res = LzmaEnc_MemPrepare(p, src, srcLen, 0, alloc, allocBig);
+
+  if (res == SZ_OK && primeLen != 0)
+  {
+    if (primeLen >= srcLen || primeLen > ((UInt32)1 << 31))
+      res = SZ_ERROR_PARAM;
+    #ifndef Z7_ST
+    else if (p->mtMode)
+      res = MatchFinderMt_InitMt(&p->matchFinderMt);
+    #endif
+    if (res == SZ_OK)
+    {
+      p->matchFinder.Init(p->matchFinderObj);
+      p->needInit = 0;
+      p->matchFinder.Skip(p->matchFinderObj, (UInt32)primeLen);
+      p->nowPos64 = primeLen;
+    }
+  }
   
   if (res == SZ_OK)
   {
@@ -3109,9 +3128,25 @@ SRes LzmaEnc_MemEncode(CLzmaEncHandle p, Byte *dest, SizeT *destLen, const Byte
 }
 
 
+SRes LzmaEnc_MemEncode(CLzmaEncHandle p, Byte *dest, SizeT *destLen, const Byte *src, SizeT srcLen,
+    int writeEndMark, ICompressProgressPtr progress, ISzAllocPtr alloc, ISzAllocPtr allocBig)
+{
+  return LzmaEnc_MemEncodePrimed(p, dest, destLen, src, srcLen, 0, writeEndMark, progress, alloc, allocBig);
+}
+
+
 SRes LzmaEncode(Byte *dest, SizeT *destLen, const Byte *src, SizeT srcLen,
     const CLzmaEncProps *props, Byte *propsEncoded, SizeT *propsSize, int writeEndMark,
     ICompressProgressPtr progress, ISzAllocPtr alloc, ISzAllocPtr allocBig)
+{
+  return LzmaEncodePrimed(dest, destLen, src, srcLen, 0, props, propsEncoded, propsSize, writeEndMark,
+      progress, alloc, allocBig);
+}
+
+
+SRes LzmaEncodePrimed(Byte *dest, SizeT *destLen, const Byte *src, SizeT srcLen, SizeT primeLen,
+    const CLzmaEncProps *props, Byte *propsEncoded, SizeT *propsSize, int writeEndMark,
+    ICompressProgressPtr progress, ISzAllocPtr alloc, ISzAllocPtr allocBig)
 {
   CLzmaEncHandle p = LzmaEnc_Create(alloc);
   SRes res;
@@ -3123,7 +3158,7 @@ SRes LzmaEncode(Byte *dest, SizeT *destLen, const Byte *src, SizeT srcLen,
   {
     res = LzmaEnc_WriteProperties(p, propsEncoded, propsSize);
     if (res == SZ_OK)
-      res = LzmaEnc_MemEncode(p, dest, destLen, src, srcLen,
+      res = LzmaEnc_MemEncodePrimed(p, dest, destLen, src, srcLen, primeLen,
           writeEndMark, progress, alloc, allocBig);
   }
 
@@ -78,6 +78,13 @@ SRes LzmaEncode(Byte *dest, SizeT *destLen, const Byte *src, SizeT srcLen,
     const CLzmaEncProps *props, Byte *propsEncoded, SizeT *propsSize, int writeEndMark,
     ICompressProgressPtr progress, ISzAllocPtr alloc, ISzAllocPtr allocBig);
 
+/* LzmaEncodePrimed() encodes src[primeLen..srcLen) using src[0..primeLen) as a preset dictionary.
+   The decoder must be started at position (primeLen) with the same bytes in its dictionary. */
+
+SRes LzmaEncodePrimed(Byte *dest, SizeT *destLen, const Byte *src, SizeT srcLen, SizeT primeLen,
+    const CLzmaEncProps *props, Byte *propsEncoded, SizeT *propsSize, int writeEndMark,
+    ICompressProgressPtr progress, ISzAllocPtr alloc, ISzAllocPtr allocBig);
+
 EXTERN_C_END
 
 #endif
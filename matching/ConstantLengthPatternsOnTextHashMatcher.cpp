@@ -1,8 +1,56 @@
 #include "ConstantLengthPatternsOnTextHashMatcher.h"
 
+void HashToIndexFlatMap::build() {
+    const size_t patternsCount = hashes.size();
+    uint8_t bucketBits = 1;
+    while (bucketBits < 32 && ((size_t) 1 << bucketBits) < patternsCount)
+        bucketBits++;
+    bucketShift = 32 - bucketBits;
+    const size_t bucketsCount = (size_t) 1 << bucketBits;
+    directory.assign(bucketsCount + 1, 0);
+    for(size_t i = 0; i < patternsCount; i++)
+        directory[(hashes[i] >> bucketShift) + 1]++;
+    for(size_t b = 0; b < bucketsCount; b++)
+        directory[b + 1] += directory[b];
+    vector<uint32_t> bucketPos(directory.begin(), directory.end() - 1);
+    vector<uint32_t> sortedHashes(patternsCount), sortedIndexes(patternsCount);
+    for(size_t i = patternsCount; i-- > 0;) {
+        const uint32_t pos = bucketPos[hashes[i] >> bucketShift]++;
+        sortedHashes[pos] = hashes[i];
+        sortedIndexes[pos] = indexes[i];
+    }
+    hashes.clear();
+    hashes.shrink_to_fit();
+    indexes.clear();
+    indexes.shrink_to_fit();
+    #pragma omp parallel for schedule(dynamic, 1 << 16)
+    for(size_t b = 0; b < bucketsCount; b++) {
+        // stable insertion sort (buckets are expected to be very small)
+        for(uint32_t i = directory[b] + 1; i < directory[b + 1]; i++) {
+            const uint32_t hash = sortedHashes[i];
+            const uint32_t idx = sortedIndexes[i];
+            uint32_t j = i;
+            for(; j > directory[b] && sortedHashes[j - 1] > hash; j--) {
+                sortedHashes[j] = sortedHashes[j - 1];
+                sortedIndexes[j] = sortedIndexes[j - 1];
+            }
+            sortedHashes[j] = hash;
+            sortedIndexes[j] = idx;
+        }
+    }
+    hashes = std::move(sortedHashes);
+    indexes = std::move(sortedIndexes);
+    built = true;
+}
+
 
 DefaultConstantLengthPatternsOnTextHashMatcher::DefaultConstantLengthPatternsOnTextHashMatcher(uint32_t patternLength)
-        : patternLength(patternLength), hf(patternLength, 32) {
+        : patternLength(patternLength), hf(patternLength, 32), iterator(*this) {
+}
+
+DefaultConstantLengthPatternsOnTextHashMatcher::TextIterator::TextIterator(
+        DefaultConstantLengthPatternsOnTextHashMatcher &matcher)
+        : hashToIndexMap(matcher.hashToIndexMap), patternLength(matcher.patternLength), hf(matcher.hf) {
 }
 
 DefaultConstantLengthPatternsOnTextHashMatcher::~DefaultConstantLengthPatternsOnTextHashMatcher() {
@@ -10,24 +58,27 @@ DefaultConstantLengthPatternsOnTextHashMatcher::~DefaultConstantLengthPatternsOn
 }
 
 void DefaultConstantLengthPatternsOnTextHashMatcher::addPattern(const char *pattern, uint32_t idx) {
-    if (this->txt != 0) {
+    if (hashToIndexMap.isBuilt()) {
         cerr << "Adding patterns not permitted during iteration";
         exit(EXIT_FAILURE);
     }
     hf.reset();
     for(uint32_t i = 0; i < patternLength; i++)
         hf.eat(pattern[i]);
-    hashToIndexMap.insert(std::pair<uint32_t, uint32_t>(hf.hashvalue, idx));
+    hashToIndexMap.insert(hf.hashvalue, idx);
 }
 
 void DefaultConstantLengthPatternsOnTextHashMatcher::addReadsSetOfPatterns(ConstantLengthReadsSetInterface *readsSet,
                                                                            uint8_t partsCount,
                                                                            vector<bool> matchedReadsBitmap) {
-    if (this->txt != 0) {
+    if (hashToIndexMap.isBuilt()) {
         cerr << "Adding patterns not permitted during iteration";
         exit(EXIT_FAILURE);
     }
     const uint_reads_cnt_max readsCount = readsSet->getReadsSetProperties()->readsCount;
+    const size_t patternsReadsCount = readsCount -
+            (matchedReadsBitmap.empty() ? 0 : std::count(matchedReadsBitmap.begin(), matchedReadsBitmap.end(), true));
+    hashToIndexMap.reserve(patternsReadsCount * partsCount);
     for (uint_reads_cnt_max i = 0; i < readsCount; i++) {
         if (!matchedReadsBitmap.empty() && matchedReadsBitmap[i])
             continue;
@@ -36,25 +87,22 @@ void DefaultConstantLengthPatternsOnTextHashMatcher::addReadsSetOfPatterns(Const
             hf.reset();
             for(uint32_t k = 0; k < patternLength; k++)
                 hf.eat(readsSet->getReadSymbol(i, offset + k));
-            hashToIndexMap.insert(std::pair<uint32_t, uint32_t>(hf.hashvalue, i * partsCount + j));
+            hashToIndexMap.insert(hf.hashvalue, i * partsCount + j);
         }
     }
 }
 
-uint32_t DefaultConstantLengthPatternsOnTextHashMatcher::getHashMatchPatternIndex() {
-    return indexIter->second;
-}
-
-uint64_t DefaultConstantLengthPatternsOnTextHashMatcher::getHashMatchTextPosition() {
-    return this->txtPos;
-}
 
 InterleavedConstantLengthPatternsOnTextHashMatcher::InterleavedConstantLengthPatternsOnTextHashMatcher(
         uint32_t patternLength, const uint8_t patternParts)
-        : patternLength(patternLength), patternParts(patternParts), patternSpan(patternLength*patternParts) {
-    hf.push_back(CyclicHash<uint32_t>(patternLength, 32));
-    for(uint8_t i = 1; i < patternParts; i++)
-        hf.push_back(hf[0]);
+        : patternLength(patternLength), patternParts(patternParts), patternSpan(patternLength*patternParts),
+        hf(patternLength, 32), iterator(*this) {
+}
+
+InterleavedConstantLengthPatternsOnTextHashMatcher::TextIterator::TextIterator(
+        InterleavedConstantLengthPatternsOnTextHashMatcher &matcher)
+        : hashToIndexMap(matcher.hashToIndexMap), patternParts(matcher.patternParts),
+        patternSpan(matcher.patternSpan), hf(matcher.patternParts, matcher.hf) {
 }
 
 InterleavedConstantLengthPatternsOnTextHashMatcher::~InterleavedConstantLengthPatternsOnTextHashMatcher() {
@@ -62,40 +110,36 @@ InterleavedConstantLengthPatternsOnTextHashMatcher::~InterleavedConstantLengthPa
 }
 
 void InterleavedConstantLengthPatternsOnTextHashMatcher::addPattern(const char *pattern, uint32_t idx) {
-    if (this->txt != 0) {
+    if (hashToIndexMap.isBuilt()) {
         cerr << "Adding patterns not permitted during iteration";
         exit(EXIT_FAILURE);
     }
-    hf[0].reset();
+    hf.reset();
     for(uint32_t i = 0; i < patternSpan; i += patternParts)
-        hf[0].eat(pattern[i]);
-    hashToIndexMap.insert(std::pair<uint32_t, uint32_t>(hf[0].hashvalue, idx));
+        hf.eat(pattern[i]);
+    hashToIndexMap.insert(hf.hashvalue, idx);
 }
 
 
 void InterleavedConstantLengthPatternsOnTextHashMatcher::addPackedPatterns(ConstantLengthReadsSetInterface *readsSet,
         int partsCount, vector<bool> matchedReadsBitmap) {
-    if (this->txt != 0) {
+    if (hashToIndexMap.isBuilt()) {
         cerr << "Adding patterns not permitted during iteration";
         exit(EXIT_FAILURE);
     }
     const uint_reads_cnt_max readsCount = readsSet->getReadsSetProperties()->readsCount;
+    const size_t patternsReadsCount = readsCount -
+            (matchedReadsBitmap.empty() ? 0 : std::count(matchedReadsBitmap.begin(), matchedReadsBitmap.end(), true));
+    hashToIndexMap.reserve(patternsReadsCount * partsCount);
     for (uint_reads_cnt_max i = 0; i < readsCount; i++) {
         for (uint8_t j = 0; j < partsCount; j++) {
             if (!matchedReadsBitmap.empty() && matchedReadsBitmap[i])
                 continue;
-            hf[0].reset();
+            hf.reset();
             for(uint32_t k = 0; k < patternSpan; k += patternParts)
-                hf[0].eat(readsSet->getReadSymbol(i, j + k));
-            hashToIndexMap.insert(std::pair<uint32_t, uint32_t>(hf[0].hashvalue, i * partsCount + j));
+                hf.eat(readsSet->getReadSymbol(i, j + k));
+            hashToIndexMap.insert(hf.hashvalue, i * partsCount + j);
         }
     }
 }
 
-uint32_t InterleavedConstantLengthPatternsOnTextHashMatcher::getHashMatchPatternIndex() {
-    return indexIter->second;
-}
-
-uint64_t InterleavedConstantLengthPatternsOnTextHashMatcher::getHashMatchTextPosition() {
-    return this->txtPos;
-}
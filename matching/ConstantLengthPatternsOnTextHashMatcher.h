@@ -1,26 +1,87 @@
 #ifndef PGTOOLS_CONSTANTLENGTHPATTERNSONTEXTHASHMATCHER_H
 #define PGTOOLS_CONSTANTLENGTHPATTERNSONTEXTHASHMATCHER_H
 
-#include <unordered_map>
 #include <vector>
 #include "rollinghash/cyclichash.h"
 #include "../readsset/ReadsSetInterface.h"
 
 using namespace std;
 
+// flat multimap of (hash, index) pairs sorted by hash with a directory of buckets (indexed by hash prefix);
+// patterns with equal hashes are reported in reverse order of insertion
+class HashToIndexFlatMap {
+private:
+    vector<uint32_t> hashes;
+    vector<uint32_t> indexes;
+    vector<uint32_t> directory;
+    uint8_t bucketShift = 32;
+    bool built = false;
+
+public:
+    void reserve(size_t patternsCount) {
+        hashes.reserve(patternsCount);
+        indexes.reserve(patternsCount);
+    }
+
+    void insert(uint32_t hash, uint32_t idx) {
+        hashes.push_back(hash);
+        indexes.push_back(idx);
+    }
+
+    void build();
+    bool isBuilt() const { return built; }
+
+    inline void prefetch(uint32_t hash) const {
+        __builtin_prefetch(directory.data() + (hash >> bucketShift));
+    }
+
+    inline void equalRange(uint32_t hash, uint32_t &beg, uint32_t &end) const {
+        const uint32_t bucket = hash >> bucketShift;
+        uint32_t i = directory[bucket];
+        const uint32_t bucketEnd = directory[bucket + 1];
+        while (i < bucketEnd && hashes[i] < hash)
+            i++;
+        beg = i;
+        while (i < bucketEnd && hashes[i] == hash)
+            i++;
+        end = i;
+    }
+
+    inline uint32_t getIndex(uint32_t pos) const { return indexes[pos]; }
+};
+
 class DefaultConstantLengthPatternsOnTextHashMatcher {
 private:
-    unordered_multimap<uint32_t, uint32_t> hashToIndexMap;
+    HashToIndexFlatMap hashToIndexMap;
     const uint32_t patternLength;
 
     CyclicHash<uint32_t> hf;
 
-    const  char* txt = nullptr;
-    uint64_t txtSize = 0;
+public:
+    // independent iteration state (many iterators can scan disjoint parts of a text in parallel)
+    class TextIterator {
+    private:
+        const HashToIndexFlatMap &hashToIndexMap;
+        const uint32_t patternLength;
+        CyclicHash<uint32_t> hf;
 
-    //iterator fields
-    int64_t txtPos = -1;
-    unordered_multimap<uint32_t, uint32_t>::iterator indexIter, indexIterEnd;
+        const char* txt = nullptr;
+        uint64_t txtSize = 0;
+
+        int64_t txtPos = -1;
+        uint32_t indexIter = 0, indexIterEnd = 0;
+
+    public:
+        TextIterator(DefaultConstantLengthPatternsOnTextHashMatcher &matcher);
+
+        inline void iterateOver(const char* txt, uint64_t length);
+        inline bool moveNext();
+        uint32_t getHashMatchPatternIndex() const { return hashToIndexMap.getIndex(indexIter); }
+        uint64_t getHashMatchTextPosition() const { return this->txtPos; }
+    };
+
+private:
+    TextIterator iterator;
 
 public:
     DefaultConstantLengthPatternsOnTextHashMatcher(uint32_t patternLength);
@@ -31,36 +92,39 @@ public:
     void addReadsSetOfPatterns(ConstantLengthReadsSetInterface *readsSet, uint8_t partsCount = 1,
                                vector<bool> matchedReadsBitmap = {});
 
+    uint32_t getPatternLength() const { return patternLength; }
+
+    // finalizes patterns index (required before scanning a text with TextIterator instances)
+    void prepareIteration() { if (!hashToIndexMap.isBuilt()) hashToIndexMap.build(); };
+
     //iterator routines
-    inline void iterateOver(const char* txt, uint64_t length);
-    inline bool moveNext();
-    uint32_t getHashMatchPatternIndex();
-    uint64_t getHashMatchTextPosition();
+    inline void iterateOver(const char* txt, uint64_t length) { prepareIteration(); iterator.iterateOver(txt, length); };
+    inline bool moveNext() { return iterator.moveNext(); };
+    uint32_t getHashMatchPatternIndex() const { return iterator.getHashMatchPatternIndex(); };
+    uint64_t getHashMatchTextPosition() const { return iterator.getHashMatchTextPosition(); };
 };
 
-
-void DefaultConstantLengthPatternsOnTextHashMatcher::iterateOver(const char *txt, uint64_t length) {
+void DefaultConstantLengthPatternsOnTextHashMatcher::TextIterator::iterateOver(const char *txt, uint64_t length) {
     this->txt = txt;
     this->txtSize = length;
     hf.reset();
     for(uint32_t i = 0; i < txtSize && i < patternLength; i++)
         hf.eat(this->txt[i]);
     this->txtPos = -1;
-    indexIter = hashToIndexMap.end();
-    indexIterEnd = hashToIndexMap.end();
+    indexIter = 0;
+    indexIterEnd = 0;
 }
 
-bool DefaultConstantLengthPatternsOnTextHashMatcher::moveNext() {
+bool DefaultConstantLengthPatternsOnTextHashMatcher::TextIterator::moveNext() {
     if (indexIter != indexIterEnd) {
         indexIter++;
         if (indexIter != indexIterEnd)
             return true;
     }
     while(++this->txtPos <= (int64_t) txtSize - patternLength) {
-        auto indexIterRange = hashToIndexMap.equal_range(hf.hashvalue);
+        hashToIndexMap.equalRange(hf.hashvalue, indexIter, indexIterEnd);
         hf.update(this->txt[this->txtPos], this->txt[this->txtPos + patternLength]);
-        indexIter = indexIterRange.first;
-        indexIterEnd = indexIterRange.second;
+        hashToIndexMap.prefetch(hf.hashvalue);
         if (indexIter != indexIterEnd)
             return true;
     }
@@ -69,20 +133,40 @@ bool DefaultConstantLengthPatternsOnTextHashMatcher::moveNext() {
 
 class InterleavedConstantLengthPatternsOnTextHashMatcher {
 private:
-    unordered_multimap<uint32_t, uint32_t> hashToIndexMap;
+    HashToIndexFlatMap hashToIndexMap;
     const uint32_t patternLength;
     const uint8_t patternParts;
     const uint32_t patternSpan;
 
-    std::vector<CyclicHash<uint32_t>> hf;
-    uint8_t currentHF = 0;
+    CyclicHash<uint32_t> hf;
 
-    const  char* txt = nullptr;
-    uint64_t txtSize = 0;
+public:
+    // independent iteration state (many iterators can scan disjoint parts of a text in parallel)
+    class TextIterator {
+    private:
+        const HashToIndexFlatMap &hashToIndexMap;
+        const uint8_t patternParts;
+        const uint32_t patternSpan;
+        std::vector<CyclicHash<uint32_t>> hf;
+        uint8_t currentHF = 0;
+
+        const char* txt = nullptr;
+        uint64_t txtSize = 0;
+
+        int64_t txtPos = -1;
+        uint32_t indexIter = 0, indexIterEnd = 0;
+
+    public:
+        TextIterator(InterleavedConstantLengthPatternsOnTextHashMatcher &matcher);
+
+        inline void iterateOver(const char* txt, uint64_t length);
+        inline bool moveNext();
+        uint32_t getHashMatchPatternIndex() const { return hashToIndexMap.getIndex(indexIter); }
+        uint64_t getHashMatchTextPosition() const { return this->txtPos; }
+    };
 
-    //iterator fields
-    int64_t txtPos = -1;
-    unordered_multimap<uint32_t, uint32_t>::iterator indexIter, indexIterEnd;
+private:
+    TextIterator iterator;
 
 public:
     InterleavedConstantLengthPatternsOnTextHashMatcher(uint32_t patternLength, const uint8_t patternParts);
@@ -91,18 +175,22 @@ public:
 
     void addPattern(const char* pattern, uint32_t idx);
 
+    uint32_t getPatternSpan() const { return patternSpan; }
+
+    // finalizes patterns index (required before scanning a text with TextIterator instances)
+    void prepareIteration() { if (!hashToIndexMap.isBuilt()) hashToIndexMap.build(); };
+
     //iterator routines
-    inline void iterateOver(const char* txt, uint64_t length);
-    inline bool moveNext();
-    uint32_t getHashMatchPatternIndex();
-    uint64_t getHashMatchTextPosition();
+    inline void iterateOver(const char* txt, uint64_t length) { prepareIteration(); iterator.iterateOver(txt, length); };
+    inline bool moveNext() { return iterator.moveNext(); };
+    uint32_t getHashMatchPatternIndex() const { return iterator.getHashMatchPatternIndex(); };
+    uint64_t getHashMatchTextPosition() const { return iterator.getHashMatchTextPosition(); };
 
     void addPackedPatterns(ConstantLengthReadsSetInterface*readsSet, int partsCount,
                            vector<bool> matchedReadsBitmap = {});
 };
 
-
-void InterleavedConstantLengthPatternsOnTextHashMatcher::iterateOver(const char *txt, uint64_t length) {
+void InterleavedConstantLengthPatternsOnTextHashMatcher::TextIterator::iterateOver(const char *txt, uint64_t length) {
     this->txt = txt;
     this->txtSize = length;
     for(uint8_t h = 0; h < patternParts; h++) {
@@ -112,24 +200,23 @@ void InterleavedConstantLengthPatternsOnTextHashMatcher::iterateOver(const char
             hf[h].eat(this->txt[i]);
     }
     this->txtPos = -1;
-    indexIter = hashToIndexMap.end();
-    indexIterEnd = hashToIndexMap.end();
+    indexIter = 0;
+    indexIterEnd = 0;
     currentHF = 0;
 }
 
-bool InterleavedConstantLengthPatternsOnTextHashMatcher::moveNext() {
+bool InterleavedConstantLengthPatternsOnTextHashMatcher::TextIterator::moveNext() {
     if (indexIter != indexIterEnd) {
         indexIter++;
         if (indexIter != indexIterEnd)
             return true;
     }
-    while(++this->txtPos <= txtSize - patternSpan) {
-        auto indexIterRange = hashToIndexMap.equal_range(hf[currentHF].hashvalue);
+    while(++this->txtPos <= (int64_t) txtSize - patternSpan) {
+        hashToIndexMap.equalRange(hf[currentHF].hashvalue, indexIter, indexIterEnd);
         hf[currentHF++].update(this->txt[this->txtPos], this->txt[this->txtPos + patternSpan]);
         if (currentHF == patternParts)
             currentHF = 0;
-        indexIter = indexIterRange.first;
-        indexIterEnd = indexIterRange.second;
+        hashToIndexMap.prefetch(hf[currentHF].hashvalue);
         if (indexIter != indexIterEnd)
             return true;
     }
@@ -4,6 +4,7 @@
 
 #include "../pseudogenome/persistence/SeparatedPseudoGenomePersistence.h"
 #include "../pseudogenome/readslist/SeparatedExtendedReadsList.h"
+#include "../utils/mismatches.h"
 #include <omp.h>
 
 #ifdef __APPLE__
@@ -18,15 +19,51 @@
 namespace PgTools {
 
     uint8_t countMismatches(const char *pattern, const char *text, uint64_t length, uint8_t maxMismatches) {
-        uint8_t res = 0;
-        const char *patEnd = pattern + length;
-        while (pattern != patEnd) {
-            if (*pattern++ != *text++) {
-                if (res++ >= maxMismatches)
-                    return NOT_MATCHED_COUNT;
-            }
+        return PgHelpers::countSymbolsMismatches(pattern, text, length, maxMismatches);
+    }
+
+    static const int PARALLEL_SCAN_SEGMENTS_PER_THREAD = 4;
+    static const uint64_t SCAN_ORDER_MASK = (1ULL << 56) - 1;
+
+    static inline bool atomicUpdateMin(std::atomic<uint64_t> &target, const uint64_t value) {
+        uint64_t current = target.load(std::memory_order_relaxed);
+        while (value < current) {
+            if (target.compare_exchange_weak(current, value, std::memory_order_relaxed))
+                return true;
         }
-        return res;
+        return false;
+    }
+
+    // scans txt in segments (in parallel) reporting (txtPos, patternIdx, segmentStats) for all hash matches
+    template<class HashMatcher, typename MatchHandler>
+    static void parallelHashMatchesScan(HashMatcher* hashMatcher, const char* txt, const uint64_t txtLength,
+                                        const uint32_t patternSpan, uint64_t &stat1, uint64_t &stat2,
+                                        MatchHandler handler) {
+        hashMatcher->prepareIteration();
+        if (txtLength < patternSpan)
+            return;
+        const uint64_t positionsCount = txtLength - patternSpan + 1;
+        const int64_t segmentsCount = std::min<uint64_t>(positionsCount,
+                numberOfThreads == 1 ? 1 : numberOfThreads * PARALLEL_SCAN_SEGMENTS_PER_THREAD);
+        const uint64_t segmentLength = (positionsCount + segmentsCount - 1) / segmentsCount;
+        uint64_t s1 = 0, s2 = 0;
+        #pragma omp parallel for schedule(dynamic) reduction(+:s1,s2) num_threads(numberOfThreads)
+        for(int64_t k = 0; k < segmentsCount; k++) {
+            const uint64_t segBeg = k * segmentLength;
+            if (segBeg >= positionsCount)
+                continue;
+            const uint64_t segEnd = std::min(segBeg + segmentLength, positionsCount);
+            uint64_t segmentStats[2] = { 0, 0 };
+            typename HashMatcher::TextIterator iterator(*hashMatcher);
+            iterator.iterateOver(txt + segBeg, segEnd - segBeg + patternSpan - 1);
+            while (iterator.moveNext())
+                handler(segBeg + iterator.getHashMatchTextPosition(), iterator.getHashMatchPatternIndex(),
+                        segmentStats);
+            s1 += segmentStats[0];
+            s2 += segmentStats[1];
+        }
+        stat1 += s1;
+        stat2 += s2;
     }
 
     void reportMismatches(const char *read, const char *pgPart, const uint_read_len_max length, ofstream &mismatchesDest) {
@@ -198,30 +235,33 @@ namespace PgTools {
     void DefaultReadsExactMatcher::executeMatching(bool revCompMode) {
         time_checkpoint();
         cout << "Matching" << (revCompMode?" in Pg reverse":"") << "...\n" << endl;
-        hashMatcher->iterateOver(pgPtr, pgLength);
-
-        while (hashMatcher->moveNext()) {
-            const uint64_t matchPosition = hashMatcher->getHashMatchTextPosition();
-            const uint_reads_cnt_max matchReadIndex = hashMatcher->getHashMatchPatternIndex();
-
-            bool exactMatch = readsSet->compareReadWithPattern(matchReadIndex, pgPtr + matchPosition) == 0;
-            if (exactMatch) {
-                if (readMatchPos[matchReadIndex] == NOT_MATCHED_POSITION) {
-                    readMatchPos[matchReadIndex] = revCompMode?pgLength-(matchPosition+matchingLength):matchPosition;
-                    if (revCompMode) readMatchRC[matchReadIndex] = true;
-                    matchedReadsCount++;
-                } else
-                    betterMatchCount++;
+        // the leftmost exact match wins (previously matched reads are never updated) - as in a serial scan
+        vector<std::atomic<uint64_t>> matchKeys(readsCount);
+        #pragma omp parallel for num_threads(numberOfThreads)
+        for(int64_t i = 0; i < readsCount; i++)
+            matchKeys[i].store(readMatchPos[i] == NOT_MATCHED_POSITION ? UINT64_MAX : 0, std::memory_order_relaxed);
+
+        uint64_t exactMatchCount = 0;
+        parallelHashMatchesScan(hashMatcher, pgPtr, pgLength, matchingLength, exactMatchCount, falseMatchCount,
+                [&](const uint64_t matchPosition, const uint_reads_cnt_max matchReadIndex, uint64_t *stats) {
+            if (readsSet->compareReadWithPattern(matchReadIndex, pgPtr + matchPosition) == 0) {
+                stats[0]++;
+                atomicUpdateMin(matchKeys[matchReadIndex], matchPosition);
             } else
-                falseMatchCount++;
-/*            if (i++ < 1) {
-                cout << "Matched: " << matchReadIndex << "; " << matchPosition
-                    << "; " << (exactMatch?"positive":"false") << "; " << (revCompMode?"pair strand (RC)":"") << endl;
-                cout << matchedRead << endl;
-                const string pgPart(txt + (matchPosition), matchingLength);
-                cout << pgPart << endl;
-            }*/
+                stats[1]++;
+        });
+
+        uint_reads_cnt_max newlyMatchedCount = 0;
+        for(uint_reads_cnt_max i = 0; i < readsCount; i++) {
+            const uint64_t matchPosition = matchKeys[i].load(std::memory_order_relaxed);
+            if (matchPosition == UINT64_MAX || readMatchPos[i] != NOT_MATCHED_POSITION)
+                continue;
+            readMatchPos[i] = revCompMode?pgLength-(matchPosition+matchingLength):matchPosition;
+            if (revCompMode) readMatchRC[i] = true;
+            newlyMatchedCount++;
         }
+        matchedReadsCount += newlyMatchedCount;
+        betterMatchCount += exactMatchCount - newlyMatchedCount;
 
         cout << "... exact matching procedure completed in " << time_millis() << " msec. " << endl;
         cout << "Exact matched " << matchedReadsCount << " reads (" << (readsCount - matchedReadsCount)
@@ -264,6 +304,83 @@ namespace PgTools {
     }
 
 
+    // match keys order candidates like a serial scan: fewer mismatches (not below minMismatches) first,
+    // then earlier text position and (at the same position) pattern index descending
+    uint64_t AbstractReadsApproxMatcher::initialMatchKey(uint_reads_cnt_max readIdx) {
+        if (readMismatchesCount[readIdx] == NOT_MATCHED_COUNT)
+            return UINT64_MAX;
+        return ((uint64_t) std::max(readMismatchesCount[readIdx], minMismatches)) << 56;
+    }
+
+    template<typename PositionShift>
+    void AbstractReadsApproxMatcher::mergeMatchKeys(vector<std::atomic<uint64_t>> &matchKeys, bool revCompMode,
+                                                    PositionShift positionShift) {
+        const uint8_t partsCount = targetMismatches + 1;
+        vector<uint8_t> newMismatchesCount(readsCount, NOT_MATCHED_COUNT);
+        #pragma omp parallel for schedule(dynamic, 65536) num_threads(numberOfThreads)
+        for(int64_t i = 0; i < readsCount; i++) {
+            const uint64_t key = matchKeys[i].load(std::memory_order_relaxed);
+            if (key == initialMatchKey(i))
+                continue;
+            const uint64_t txtPos = (key & SCAN_ORDER_MASK) >> 8;
+            const uint8_t partIdx = partsCount - 1 - (key & UINT8_MAX);
+            const uint64_t matchPosition = txtPos - positionShift(partIdx);
+            newMismatchesCount[i] = readsSet->countMismatchesVsPattern(i, pgPtr + matchPosition, matchingLength,
+                                                                       maxMismatches);
+            readMatchPos[i] = revCompMode?pgLength-(matchPosition+matchingLength):matchPosition;
+        }
+        for(uint_reads_cnt_max i = 0; i < readsCount; i++) {
+            const uint8_t mismatchesCount = newMismatchesCount[i];
+            if (mismatchesCount == NOT_MATCHED_COUNT)
+                continue;
+            if (readMismatchesCount[i] == NOT_MATCHED_COUNT)
+                matchedReadsCount++;
+            matchedCountPerMismatches[readMismatchesCount[i]]--;
+            matchedCountPerMismatches[mismatchesCount]++;
+            readMatchRC[i] = revCompMode;
+            readMismatchesCount[i] = mismatchesCount;
+        }
+    }
+
+    template<class HashMatcher, typename PositionShift>
+    void AbstractReadsApproxMatcher::executeParallelMatching(HashMatcher *hashMatcher, uint32_t patternSpan,
+                                                             bool revCompMode, PositionShift positionShift) {
+        const uint8_t partsCount = targetMismatches + 1;
+        vector<std::atomic<uint64_t>> matchKeys(readsCount);
+        #pragma omp parallel for num_threads(numberOfThreads)
+        for(int64_t i = 0; i < readsCount; i++)
+            matchKeys[i].store(initialMatchKey(i), std::memory_order_relaxed);
+
+        uint64_t improvedMatchCount = 0;
+        parallelHashMatchesScan(hashMatcher, pgPtr, pgLength, patternSpan, improvedMatchCount, falseMatchCount,
+                [&](const uint64_t txtPos, const uint32_t matchPatternIndex, uint64_t *stats) {
+            const uint32_t matchReadIndex = matchPatternIndex / partsCount;
+            const uint8_t partIdx = matchPatternIndex % partsCount;
+            const uint64_t shift = positionShift(partIdx);
+            if (shift > txtPos || txtPos - shift + readLength > pgLength)
+                return;
+            const uint64_t order = (txtPos << 8) | (partsCount - 1 - partIdx);
+            uint64_t currentKey = matchKeys[matchReadIndex].load(std::memory_order_relaxed);
+            const uint8_t currentMismatches = currentKey >> 56;
+            const bool earlier = order < (currentKey & SCAN_ORDER_MASK);
+            if (!earlier && currentMismatches <= minMismatches)
+                return;
+            const uint8_t mismatchesLimit = std::min(earlier ? currentMismatches : (uint8_t) (currentMismatches - 1),
+                                                     maxMismatches);
+            const uint8_t mismatchesCount = readsSet->countMismatchesVsPattern(matchReadIndex,
+                    pgPtr + (txtPos - shift), matchingLength, mismatchesLimit);
+            if (mismatchesCount != NOT_MATCHED_COUNT && atomicUpdateMin(matchKeys[matchReadIndex],
+                    (((uint64_t) std::max(mismatchesCount, minMismatches)) << 56) | order))
+                stats[0]++;
+            else
+                stats[1]++;
+        });
+
+        const uint_reads_cnt_max matchedBeforeCount = matchedReadsCount;
+        mergeMatchKeys(matchKeys, revCompMode, positionShift);
+        betterMatchCount += improvedMatchCount - (matchedReadsCount - matchedBeforeCount);
+    }
+
     void AbstractReadsApproxMatcher::printApproxMatchingStats() {
         cout << "Matched " << matchedReadsCount << " reads (" << (readsCount - matchedReadsCount)
              << " left; " << betterMatchCount << " better-matches) in " << time_millis() << " msec.  False matches reported: " << falseMatchCount << "."
@@ -297,46 +414,9 @@ namespace PgTools {
     void DefaultReadsApproxMatcher::executeMatching(bool revCompMode) {
         time_checkpoint();
         cout << "Matching" << (revCompMode?" in Pg reverse":"") << "...\n" << endl;
-        hashMatcher->iterateOver(pgPtr, pgLength);
-        while (hashMatcher->moveNext()) {
-            const uint32_t matchPatternIndex = hashMatcher->getHashMatchPatternIndex();
-            uint32_t matchReadIndex = matchPatternIndex / (targetMismatches + 1);
-            if (readMismatchesCount[matchReadIndex] <= minMismatches)
-                continue;
-            uint64_t matchPosition = hashMatcher->getHashMatchTextPosition();
-            const uint_read_len_max positionShift = ((matchPatternIndex % (targetMismatches + 1)) * partLength);
-            if (positionShift > matchPosition)
-                continue;
-            matchPosition -= positionShift;
-            if (matchPosition + readLength > pgLength)
-                continue;
-            if (readMatchPos[matchReadIndex] == (revCompMode?pgLength-(matchPosition+matchingLength):matchPosition))
-                continue;
-            uint8_t currentMismatchesLimit = readMismatchesCount[matchReadIndex]==NOT_MATCHED_COUNT?maxMismatches
-                    :(readMismatchesCount[matchReadIndex] - 1);
-            const uint8_t mismatchesCount = readsSet->countMismatchesVsPattern(matchReadIndex, pgPtr + matchPosition,
-                                                            matchingLength, currentMismatchesLimit);
-            if (mismatchesCount < readMismatchesCount[matchReadIndex]) {
-                if (readMismatchesCount[matchReadIndex] == NOT_MATCHED_COUNT)
-                    matchedReadsCount++;
-                 else
-                    betterMatchCount++;
-                matchedCountPerMismatches[readMismatchesCount[matchReadIndex]]--;
-                matchedCountPerMismatches[mismatchesCount]++;
-                readMatchPos[matchReadIndex] = revCompMode?pgLength-(matchPosition+matchingLength):matchPosition;
-                readMatchRC[matchReadIndex] = revCompMode;
-                readMismatchesCount[matchReadIndex] = mismatchesCount;
-            } else
-                falseMatchCount++;
-
-/*            if (mismatchesCount < UINT8_MAX && i++ < 2) {
-                cout << "Matched: " << matchReadIndex << " (" << matchPatternIndex << "); "
-                     << matchPosition << "; " << (int) mismatchesCount << "; " << (revCompMode?"pair strand (RC)":"") << endl;
-                cout << matchedRead << endl;
-                const string pgPart(txt + matchPosition, matchingLength);
-                cout << pgPart << endl;
-            }*/
-        }
+        const uint_read_len_max partLength = this->partLength;
+        executeParallelMatching(hashMatcher, partLength, revCompMode,
+                [partLength](uint8_t partIdx) { return (uint64_t) partIdx * partLength; });
         this->printApproxMatchingStats();
     }
 
@@ -364,47 +444,8 @@ namespace PgTools {
     void InterleavedReadsApproxMatcher::executeMatching(bool revCompMode) {
         time_checkpoint();
         cout << "Matching" << (revCompMode?" in Pg reverse":"") << "...\n" << endl;
-        hashMatcher->iterateOver(pgPtr, pgLength);
-        while (hashMatcher->moveNext()) {
-            const uint32_t matchPatternIndex = hashMatcher->getHashMatchPatternIndex();
-            uint32_t matchReadIndex = matchPatternIndex / (targetMismatches + 1);
-            if (readMismatchesCount[matchReadIndex] <= minMismatches)
-                continue;
-            uint64_t matchPosition = hashMatcher->getHashMatchTextPosition();
-            const uint8_t positionShift = matchPatternIndex % (targetMismatches + 1);
-            if (positionShift > matchPosition)
-                continue;
-            matchPosition -= positionShift;
-            if (matchPosition + readLength > pgLength)
-                continue;
-            if (readMatchPos[matchReadIndex] == (revCompMode?pgLength-(matchPosition+matchingLength):matchPosition))
-                continue;
-            uint8_t currentMatchesLimit = readMismatchesCount[matchReadIndex]==NOT_MATCHED_COUNT?maxMismatches
-                    :(readMismatchesCount[matchReadIndex] - 1);
-            const uint8_t mismatchesCount = readsSet->countMismatchesVsPattern(matchReadIndex, pgPtr + matchPosition,
-                    matchingLength, currentMatchesLimit);
-            if (mismatchesCount < readMismatchesCount[matchReadIndex]) {
-                if (readMismatchesCount[matchReadIndex] == NOT_MATCHED_COUNT)
-                    matchedReadsCount++;
-                else
-                    betterMatchCount++;
-                matchedCountPerMismatches[readMismatchesCount[matchReadIndex]]--;
-                matchedCountPerMismatches[mismatchesCount]++;
-                readMatchPos[matchReadIndex] = revCompMode?pgLength-(matchPosition+matchingLength):matchPosition;
-                readMatchRC[matchReadIndex] = revCompMode;
-                readMismatchesCount[matchReadIndex] = mismatchesCount;
-            } else
-                falseMatchCount++;
-
-            //if (mismatchesCount < UINT8_MAX && i++ < 2) {
-/*            if (mismatchesCount < UINT8_MAX && mismatchesCount > 8) {
-                cout << "Matched: " << matchReadIndex << " (" << matchPatternIndex << "); "
-                     << matchPosition << "; " << (int) mismatchesCount << "; " << (revCompMode?"pair strand (RC)":"") << endl;
-                cout << matchedRead << endl;
-                const string pgPart(txt + matchPosition, matchingLength);
-                cout << pgPart << endl;
-            }*/
-        }
+        executeParallelMatching(hashMatcher, hashMatcher->getPatternSpan(), revCompMode,
+                [](uint8_t partIdx) { return (uint64_t) partIdx; });
         this->printApproxMatchingStats();
     }
 
@@ -597,7 +638,7 @@ namespace PgTools {
     void DefaultReadsMatcher::exportMatchesInOriginalOrder(SeparatedPseudoGenome *sPg, ostream &pgrcOut,
                                                            uint8_t compressionLevel, const string &outPgPrefix,
                                                            IndexesMapping *orgIndexesMapping, bool pairFileMode,
-                                                           bool revComplPairFile) {
+                                                           bool revComplPairFile, bool randomAccessMode) {
         time_checkpoint();
 
         uint_reads_cnt_std readsTotalCount = orgIndexesMapping->getReadsTotalCount();
@@ -666,7 +707,10 @@ namespace PgTools {
             }
         }
         builder->build(outPgPrefix);
-        builder->compressedBuild(pgrcOut, compressionLevel, true);
+        if (randomAccessMode)
+            builder->compressedBuildProps(pgrcOut, sPg->getReadsList());
+        else
+            builder->compressedBuild(pgrcOut, compressionLevel, true);
         delete(builder);
         closeEntryUpdating();
 
@@ -695,7 +739,8 @@ namespace PgTools {
                         uint_read_len_max matchPrefixLength, uint16_t preReadsExactMatchingChars,
                         uint16_t readsExactMatchingChars, uint16_t minCharsPerMismatch, char preMatchingMode,
                         char matchingMode, bool dumpInfo, ostream &pgrcOut, uint8_t compressionLevel,
-                        const string &pgDestFilePrefix, IndexesMapping* orgIndexesMapping) {
+                        const string &pgDestFilePrefix, IndexesMapping* orgIndexesMapping,
+                        bool randomAccessMode) {
         uint_read_len_max readLength = readsSet->maxReadLength();
         uint8_t maxMismatches = readLength / minCharsPerMismatch;
         if (readsExactMatchingChars > readLength)
@@ -785,7 +830,7 @@ namespace PgTools {
         if (matchPrefixLength == DefaultReadsMatcher::DISABLED_PREFIX_MODE) {
             if (preserveOrderMode)
                 matcher->exportMatchesInOriginalOrder(sPg, pgrcOut, compressionLevel, pgDestFilePrefix, orgIndexesMapping,
-                                                      pairFileMode, revComplPairFile);
+                                                      pairFileMode, revComplPairFile, randomAccessMode);
             else
                 matcher->exportMatchesInPgOrder(sPg, pgrcOut, compressionLevel, pgDestFilePrefix, orgIndexesMapping,
                                                 pairFileMode, revComplPairFile);
@@ -1,6 +1,7 @@
 #ifndef PGTOOLS_READSMATCHERS_H
 #define PGTOOLS_READSMATCHERS_H
 
+#include <atomic>
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -75,7 +76,7 @@ namespace PgTools {
                                     bool pairFileMode, bool revComplPairFile);
         void exportMatchesInOriginalOrder(SeparatedPseudoGenome* sPg, ostream &pgrcOut, uint8_t compressionLevel,
                                           const string &outPgPrefix, IndexesMapping *orgIndexesMapping,
-                                          bool pairFileMode, bool revComplPairFile);
+                                          bool pairFileMode, bool revComplPairFile, bool randomAccessMode = false);
 
         virtual const vector<bool> getMatchedReadsBitmap(uint8_t maxMismatches = NOT_MATCHED_COUNT - 1);
 
@@ -118,6 +119,14 @@ namespace PgTools {
         void writeMatchesInfo(ofstream &offsetsDest, ofstream &missedPatternsDest, ofstream &dumpDest) override;
         void printApproxMatchingStats();
 
+        uint64_t initialMatchKey(uint_reads_cnt_max readIdx);
+        template<typename PositionShift>
+        void mergeMatchKeys(vector<std::atomic<uint64_t>> &matchKeys, bool revCompMode, PositionShift positionShift);
+        // pseudogenome scanned in parallel segments; results are identical to a serial scan
+        template<class HashMatcher, typename PositionShift>
+        void executeParallelMatching(HashMatcher *hashMatcher, uint32_t patternSpan, bool revCompMode,
+                                     PositionShift positionShift);
+
         SeparatedPseudoGenomeOutputBuilder *createSeparatedPseudoGenomeOutputBuilder(
                 SeparatedPseudoGenome *sPg, bool allStreams = true) override;
         void initEntryUpdating() override;
@@ -204,7 +213,8 @@ namespace PgTools {
                         uint_read_len_max matchPrefixLength, uint16_t preReadsExactMatchingChars,
                         uint16_t readsExactMatchingChars, uint16_t minCharsPerMismatch, char preMatchingMode,
                         char matchingMode, bool dumpInfo, ostream& pgrcOut, uint8_t compressionLevel,
-                        const string &pgDestFilePrefix, IndexesMapping* orgIndexesMapping);
+                        const string &pgDestFilePrefix, IndexesMapping* orgIndexesMapping,
+                        bool randomAccessMode = false);
 
     uint8_t matchingCharsCorrection(size_t pgLength);
 }
@@ -174,6 +174,7 @@ namespace PgTools {
 
     void SimplePgMatcher::matchPgsInPg(string &hqPgSequence, string &lqPgSequence, string &nPgSequence,
                                         bool separateNReads, ostream &pgrcOut, uint8_t coder_level,
+                                        int pgSeqBlocksPerThread, size_t pgSeqPrimingLength,
                                         const string &hqPgPrefix, const string &lqPgPrefix, const string &nPgPrefix,
                                         uint_pg_len_max targetMatchLength, uint32_t minMatchLength) {
         chrono::steady_clock::time_point ref_start = chrono::steady_clock::now();
@@ -225,25 +226,30 @@ namespace PgTools {
         bool noNPgSequence = nPgSequence.empty();
         auto dnaCoderProps = getDefaultCoderProps(VARLEN_DNA_CODER, coder_level);
         auto pgSeqCoderProps = getVarLenEncodedPgCoderProps(coder_level);
-        auto compoundCoderProps = getCompoundCoderProps(dnaCoderProps.get(), pgSeqCoderProps.get());
+        unique_ptr<CoderProps> pgSeqBlocksCoderProps;
+        if (pgSeqBlocksPerThread)
+            pgSeqBlocksCoderProps = getParallelBlocksCoderProps(pgSeqCoderProps.get(),
+                    numberOfThreads * pgSeqBlocksPerThread, pgSeqPrimingLength);
+        auto compoundCoderProps = getCompoundCoderProps(dnaCoderProps.get(), pgSeqBlocksPerThread ?
+                pgSeqBlocksCoderProps.get() : pgSeqCoderProps.get());
         cJobs.emplace_back(string("Joined mapped sequences (good&bad") + (noNPgSequence ? "" : "&N") + ")... ",
                            (unsigned char*) comboPgSeq.data(), comboPgSeq.size(),
                            compoundCoderProps.get(), COMPRESSION_ESTIMATION_VAR_LEN_DNA);
         double estimated_pg_offset_ratio = simpleUintCompressionEstimate(refSequenceLength, isPgLengthStd ? UINT32_MAX : UINT64_MAX);
         const int pgrc_pg_offset_dataperiodcode = isPgLengthStd ? LZMA_DATAPERIODCODE_32_t : LZMA_DATAPERIODCODE_64_t;
-        auto hqMapOffCoderProps = getDefaultCoderProps(LZMA_CODER, coder_level, pgrc_pg_offset_dataperiodcode);
+        auto hqMapOffCoderProps = getPgMappingOffsetsCoderProps(coder_level, pgrc_pg_offset_dataperiodcode);
         cJobs.emplace_back("Good sequence mapping - offsets... ", (unsigned char*) hqPgMapOff.data(),
                            hqPgMapOff.size(), hqMapOffCoderProps.get(), estimated_pg_offset_ratio);
         auto hqMapLenCoderProps = getDefaultCoderProps(LZMA_CODER, coder_level, LZMA_DATAPERIODCODE_8_t);
         cJobs.emplace_back("lengths... ", (unsigned char*) hqPgMapLen.data(), hqPgMapLen.size(),
                            hqMapLenCoderProps.get());
-        auto lqMapOffCoderProps = getDefaultCoderProps(LZMA_CODER, coder_level, pgrc_pg_offset_dataperiodcode);
+        auto lqMapOffCoderProps = getPgMappingOffsetsCoderProps(coder_level, pgrc_pg_offset_dataperiodcode);
         cJobs.emplace_back("Bad sequence mapping - offsets... ", (unsigned char*) lqPgMapOff.data(),
                            lqPgMapOff.size(), lqMapOffCoderProps.get(), estimated_pg_offset_ratio);
         auto lqMapLenCoderProps = getDefaultFSECoderProps(12);
         cJobs.emplace_back("lengths... ", (unsigned char*) lqPgMapLen.data(), lqPgMapLen.size(),
                            lqMapLenCoderProps.get());
-        auto nMapOffCoderProps = getDefaultCoderProps(LZMA_CODER, coder_level, pgrc_pg_offset_dataperiodcode);
+        auto nMapOffCoderProps = getPgMappingOffsetsCoderProps(coder_level, pgrc_pg_offset_dataperiodcode);
         auto nMapLenCoderProps =  getDefaultFSECoderProps();
         if (separateNReads) {
             cJobs.emplace_back("N sequence mapping - offsets... ", (unsigned char*) nPgMapOff.data(),
@@ -256,94 +262,353 @@ namespace PgTools {
         CompressionJob::writeCompressedCollectiveParallel(pgrcOut, cJobs);
     }
 
+    void SimplePgMatcher::writePgsInBlocks(string &hqPgSequence, string &lqPgSequence, string &nPgSequence,
+                                           ostream &pgrcOut, uint8_t coder_level, uint32_t blockLength) {
+        chrono::steady_clock::time_point start_t = chrono::steady_clock::now();
+        string joinedPgSeq = std::move(hqPgSequence);
+        joinedPgSeq.reserve(joinedPgSeq.size() + lqPgSequence.size() + nPgSequence.size());
+        joinedPgSeq.append(lqPgSequence);
+        lqPgSequence.clear();
+        lqPgSequence.shrink_to_fit();
+        joinedPgSeq.append(nPgSequence);
+        nPgSequence.clear();
+        nPgSequence.shrink_to_fit();
+        const uint64_t blocksCount = (joinedPgSeq.size() + blockLength - 1) / blockLength;
+        auto getBlockLength = [&](uint64_t b) -> size_t {
+            return std::min<uint64_t>(blockLength, joinedPgSeq.size() - b * blockLength);
+        };
+
+        auto pgSeqCoderProps = getVarLenEncodedPgCoderProps(coder_level);
+        const bool primed = pgSeqCoderProps->getCoderType() == LZMA_CODER;
+        ostringstream blocksPropsOut;
+        PgHelpers::writeValue<uint32_t>(blocksPropsOut, blockLength);
+        PgHelpers::writeValue<uint8_t>(blocksPropsOut, primed);
+        string blocksProps = blocksPropsOut.str();
+        auto fseCoderProps = getDefaultFSECoderProps();
+        writeCompressed(pgrcOut, blocksProps, fseCoderProps.get());
+        if (primed) {
+            auto dnaCoderProps = getDefaultCoderProps(VARLEN_DNA_CODER, coder_level);
+            vector<string> varLenBlocks(blocksCount);
+            #pragma omp parallel for schedule(dynamic) num_threads(numberOfThreads)
+            for (uint64_t b = 0; b < blocksCount; b++) {
+                unsigned char* dest = nullptr;
+                size_t destLen = 0;
+                VarLenDNACoder::Compress(dest, destLen, (const unsigned char*) joinedPgSeq.data() + b * blockLength,
+                                         getBlockLength(b), (VarLenDNACoderProps*) dnaCoderProps.get());
+                varLenBlocks[b].assign((char*) dest, destLen);
+                delete[] dest;
+            }
+            joinedPgSeq.clear();
+            joinedPgSeq.shrink_to_fit();
+            vector<size_t> offsets(blocksCount + 1, 0);
+            for (uint64_t b = 0; b < blocksCount; b++)
+                offsets[b + 1] = offsets[b] + varLenBlocks[b].size();
+            string varLenSeq;
+            varLenSeq.reserve(offsets[blocksCount]);
+            for (string &block: varLenBlocks) {
+                varLenSeq.append(block);
+                string().swap(block);
+            }
+            if (blocksCount)
+                writePrimedBlocksCompressed(pgrcOut, (const unsigned char*) varLenSeq.data(), offsets,
+                                            pgSeqCoderProps.get());
+        } else {
+            // props are modified during compression (separate props for each block)
+            vector<unique_ptr<CoderProps>> dnaCoderProps(blocksCount), blockCoderProps(blocksCount),
+                    compoundCoderProps(blocksCount);
+            vector<CompressionJob> cJobs;
+            for (uint64_t b = 0; b < blocksCount; b++) {
+                dnaCoderProps[b] = getDefaultCoderProps(VARLEN_DNA_CODER, coder_level);
+                blockCoderProps[b] = getVarLenEncodedPgCoderProps(coder_level);
+                compoundCoderProps[b] = getCompoundCoderProps(dnaCoderProps[b].get(), blockCoderProps[b].get());
+                cJobs.emplace_back("Joined sequences block " + to_string(b) + "... ",
+                                   (unsigned char*) joinedPgSeq.data() + b * blockLength, getBlockLength(b),
+                                   compoundCoderProps[b].get(), COMPRESSION_ESTIMATION_VAR_LEN_DNA);
+            }
+            CompressionJob::writeCompressedCollectiveParallel(pgrcOut, cJobs);
+        }
+        *logout << "Compressed joined pseudogenomes in " << blocksCount << " blocks in "
+                << time_millis(start_t) << " msec. " << endl;
+    }
+
+    void SimplePgMatcher::readPgsBlocksProps(istream &pgrcIn, uint64_t joinedPgLength, PgsBlocks &pgsBlocks) {
+        string propsString;
+        readCompressed(pgrcIn, propsString);
+        istringstream propsIn(propsString);
+        uint8_t primed = 0;
+        PgHelpers::readValue<uint32_t>(propsIn, pgsBlocks.blockLength, false);
+        PgHelpers::readValue<uint8_t>(propsIn, primed, false);
+        if (!propsIn || pgsBlocks.blockLength == 0) {
+            fprintf(stderr, "Error reading pseudogenome blocks properties.\n");
+            exit(EXIT_FAILURE);
+        }
+        pgsBlocks.primed = primed;
+        pgsBlocks.joinedPgLength = joinedPgLength;
+        pgsBlocks.blocksCount = (joinedPgLength + pgsBlocks.blockLength - 1) / pgsBlocks.blockLength;
+        pgsBlocks.firstStreamId = skipPrefetchedStreams(pgsBlocks.blocksCount);
+    }
+
+    void SimplePgMatcher::readPgsBlocks(const IndexedArchive &archive, const PgsBlocks &pgsBlocks,
+                                        const vector<uint64_t> &blocks, string &blocksSequence) {
+        vector<size_t> offsets(blocks.size() + 1, 0);
+        for (size_t i = 0; i < blocks.size(); i++)
+            offsets[i + 1] = offsets[i] + std::min<uint64_t>(pgsBlocks.blockLength,
+                    pgsBlocks.joinedPgLength - blocks[i] * pgsBlocks.blockLength);
+        blocksSequence.resize(offsets[blocks.size()]);
+        string prime;
+        if (pgsBlocks.primed && !blocks.empty())
+            archive.readStream(pgsBlocks.firstStreamId, prime);
+        vector<ostringstream> logOuts(blocks.size());
+        #pragma omp parallel for schedule(dynamic) num_threads(numberOfThreads)
+        for (size_t i = 0; i < blocks.size(); i++) {
+            const uint32_t id = pgsBlocks.firstStreamId + blocks[i];
+            size_t blockLength = offsets[i + 1] - offsets[i];
+            string block;
+            if (!pgsBlocks.primed) {
+                archive.readStream(id, block, &logOuts[i]);
+                if (block.size() != blockLength) {
+                    fprintf(stderr, "Error reading pseudogenome block %u.\n", id);
+                    exit(EXIT_FAILURE);
+                }
+                memcpy((char*) blocksSequence.data() + offsets[i], block.data(), blockLength);
+                continue;
+            }
+            if (blocks[i])
+                archive.readPrimedStream(id, block, prime, &logOuts[i]);
+            const string &varLenBlock = blocks[i] ? block : prime;
+            // (decoding fails on unexpected length of the block)
+            VarLenDNACoder::Uncompress((unsigned char*) blocksSequence.data() + offsets[i], &blockLength,
+                                       (unsigned char*) varLenBlock.data(), varLenBlock.size());
+        }
+        for (size_t i = 0; i < blocks.size(); i++)
+            *PgHelpers::devout << "\t" << logOuts[i].str();
+    }
+
     void SimplePgMatcher::restoreMatchedPgs(istream &pgrcIn, uint_pg_len_max orgHqPgLen, string &hqPgSequence, string &lqPgSequence,
                                             string &nPgSequence, PgRCParams* params) {
-        uint_pg_len_max hqPgMappedLen, lqPgMappedLen, nPgMappedLen;
-        string hqPgMapOff, hqPgMapLen, lqPgMapOff, lqPgMapLen, nPgMapOff, nPgMapLen;
-        istringstream pgMapOffSrc, pgMapLenSrc;
+        MatchedPgsStreams matchedPgs;
+        readMatchedPgs(pgrcIn, matchedPgs, params);
+        restoreMatchedHqPg(matchedPgs, orgHqPgLen, hqPgSequence);
+        restoreMatchedLqAndNPgs(matchedPgs, hqPgSequence, orgHqPgLen, lqPgSequence, nPgSequence);
+    }
+
+    void SimplePgMatcher::readMatchedPgs(istream &pgrcIn, MatchedPgsStreams &matchedPgs, PgRCParams* params,
+                                         bool readLqPg, bool readNPg) {
         istream* propsIn = &pgrcIn;
         string propsString;
         if (params->isVersionAtLeast(1, 3)) {
             readCompressed(pgrcIn, propsString);
             propsIn = new istringstream(propsString);
         }
-        PgHelpers::readValue<uint_pg_len_max>(*propsIn, hqPgMappedLen, false);
-        PgHelpers::readValue<uint_pg_len_max>(*propsIn, lqPgMappedLen, false);
-        PgHelpers::readValue<uint_pg_len_max>(*propsIn, nPgMappedLen, false);
+        PgHelpers::readValue<uint_pg_len_max>(*propsIn, matchedPgs.hqPgMappedLen, false);
+        PgHelpers::readValue<uint_pg_len_max>(*propsIn, matchedPgs.lqPgMappedLen, false);
+        PgHelpers::readValue<uint_pg_len_max>(*propsIn, matchedPgs.nPgMappedLen, false);
         if (params->isVersionAtLeast(1, 3))
             delete propsIn;
-        string comboPgMapped;
         vector<string*> destStrings;
-        destStrings.push_back(&comboPgMapped);
-        destStrings.push_back(&hqPgMapOff);
-        destStrings.push_back(&hqPgMapLen);
-        destStrings.push_back(&lqPgMapOff);
-        destStrings.push_back(&lqPgMapLen);
-        if (nPgMappedLen) {
-            destStrings.push_back(&nPgMapOff);
-            destStrings.push_back(&nPgMapLen);
+        destStrings.push_back(&matchedPgs.comboPgMapped);
+        destStrings.push_back(&matchedPgs.hqPgMapOff);
+        destStrings.push_back(&matchedPgs.hqPgMapLen);
+        destStrings.push_back(readLqPg ? &matchedPgs.lqPgMapOff : nullptr);
+        destStrings.push_back(readLqPg ? &matchedPgs.lqPgMapLen : nullptr);
+        if (matchedPgs.nPgMappedLen) {
+            destStrings.push_back(readNPg ? &matchedPgs.nPgMapOff : nullptr);
+            destStrings.push_back(readNPg ? &matchedPgs.nPgMapLen : nullptr);
         }
         readCompressedCollectiveParallel(pgrcIn, destStrings, params->isVersion(1, 2) ? 0 : -1);
-        string nPgMapped(comboPgMapped, hqPgMappedLen + lqPgMappedLen);
-        comboPgMapped.resize(hqPgMappedLen + lqPgMappedLen);
-        {
-            string lqPgMapped(comboPgMapped, hqPgMappedLen);
-            comboPgMapped.resize(hqPgMappedLen);
-            comboPgMapped.shrink_to_fit();
-            {
-                string hqPgMapped = std::move(comboPgMapped);
-                pgMapOffSrc.str(hqPgMapOff);
-                pgMapLenSrc.str(hqPgMapLen);
-                hqPgSequence.clear();
-                hqPgSequence = SimplePgMatcher::restoreMatchedPg(hqPgSequence, orgHqPgLen, hqPgMapped, pgMapOffSrc, pgMapLenSrc,
-                                                                 true, false, true);
-            }
+        if (matchedPgs.comboPgMapped.length() !=
+            matchedPgs.hqPgMappedLen + matchedPgs.lqPgMappedLen + matchedPgs.nPgMappedLen) {
+            fprintf(stderr, "Error reading mapped pseudogenomes.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
 
-            pgMapOffSrc.str(lqPgMapOff);
-            pgMapLenSrc.str(lqPgMapLen);
-            lqPgSequence = SimplePgMatcher::restoreMatchedPg(hqPgSequence, orgHqPgLen, lqPgMapped, pgMapOffSrc, pgMapLenSrc,
+    void SimplePgMatcher::restoreMatchedHqPg(MatchedPgsStreams &matchedPgs, uint_pg_len_max orgHqPgLen,
+                                             string &hqPgSequence) {
+        istringstream pgMapOffSrc(matchedPgs.hqPgMapOff), pgMapLenSrc(matchedPgs.hqPgMapLen);
+        hqPgSequence.clear();
+        hqPgSequence = SimplePgMatcher::restoreMatchedPg(hqPgSequence, orgHqPgLen, matchedPgs.comboPgMapped.data(),
+                                                         matchedPgs.hqPgMappedLen, pgMapOffSrc, pgMapLenSrc,
+                                                         true, false, true);
+    }
+
+    void SimplePgMatcher::restoreMatchedLqAndNPgs(MatchedPgsStreams &matchedPgs, string &hqPgSequence,
+                                                  uint_pg_len_max orgHqPgLen, string &lqPgSequence,
+                                                  string &nPgSequence, bool restoreLqPg, bool restoreNPg) {
+        const char* lqPgMapped = matchedPgs.comboPgMapped.data() + matchedPgs.hqPgMappedLen;
+        if (restoreLqPg && matchedPgs.lqPgMappedLen) {
+            istringstream pgMapOffSrc(matchedPgs.lqPgMapOff), pgMapLenSrc(matchedPgs.lqPgMapLen);
+            lqPgSequence = SimplePgMatcher::restoreMatchedPg(hqPgSequence, orgHqPgLen, lqPgMapped,
+                                                             matchedPgs.lqPgMappedLen, pgMapOffSrc, pgMapLenSrc,
                                                              true, false);
         }
-        if (nPgMappedLen) {
-            pgMapOffSrc.str(nPgMapOff);
-            pgMapLenSrc.str(nPgMapLen);
-            nPgSequence = SimplePgMatcher::restoreMatchedPg(hqPgSequence, orgHqPgLen, nPgMapped, pgMapOffSrc, pgMapLenSrc,
+        if (restoreNPg && matchedPgs.nPgMappedLen) {
+            istringstream pgMapOffSrc(matchedPgs.nPgMapOff), pgMapLenSrc(matchedPgs.nPgMapLen);
+            nPgSequence = SimplePgMatcher::restoreMatchedPg(hqPgSequence, orgHqPgLen,
+                                                            lqPgMapped + matchedPgs.lqPgMappedLen,
+                                                            matchedPgs.nPgMappedLen, pgMapOffSrc, pgMapLenSrc,
                                                             true, false);
         }
+        string().swap(matchedPgs.comboPgMapped);
+    }
+
+    void SimplePgMatcher::findMatchMarks(const char *destPg, size_t destPgLength, vector<uint64_t> &markPos) {
+        const int chunksCount = numberOfThreads * 4;
+        vector<vector<uint64_t>> chunkMarkPos(chunksCount);
+        #pragma omp parallel for schedule(dynamic)
+        for (int c = 0; c < chunksCount; c++) {
+            const char* chunkEnd = destPg + destPgLength * (c + 1) / chunksCount;
+            const char* pos = destPg + destPgLength * c / chunksCount;
+            while ((pos = (const char*) memchr(pos, MATCH_MARK, chunkEnd - pos))) {
+                chunkMarkPos[c].push_back(pos - destPg);
+                pos++;
+            }
+        }
+        markPos.clear();
+        for (vector<uint64_t> &chunk: chunkMarkPos)
+            markPos.insert(markPos.end(), chunk.begin(), chunk.end());
+    }
+
+    void SimplePgMatcher::copyMatch(char *resPg, const char *srcPg, const RestoredMatch &match, bool revComplMatching) {
+        char* dest = resPg + match.resPos;
+        const char* src = srcPg + match.srcPos;
+        if (srcPg == resPg && match.srcPos + match.length > match.resPos) {
+            // overlapping copy (possible only when matching a sequence with itself without reverse complement)
+            for (uint64_t i = 0; i < match.length; i++)
+                dest[i] = src[i];
+        } else
+            memcpy(dest, src, match.length);
+        if (revComplMatching)
+            reverseComplementInPlace(dest, match.length);
+    }
+
+    void SimplePgMatcher::restoreSelfMatches(string &resPg, const vector<RestoredMatch> &matches, bool revComplMatching) {
+        // a match can be copied only after all matches overlapping its source are restored
+        const size_t matchesCount = matches.size();
+        vector<uint32_t> level(matchesCount, 0);
+        uint32_t maxLevel = 0;
+        for (size_t i = 0; i < matchesCount; i++) {
+            const uint64_t srcPos = matches[i].srcPos;
+            const uint64_t srcEnd = srcPos + matches[i].length;
+            size_t j = std::upper_bound(matches.begin(), matches.begin() + i, srcPos,
+                    [](uint64_t pos, const RestoredMatch &match) { return pos < match.resPos; }) - matches.begin();
+            if (j > 0 && matches[j - 1].resPos + matches[j - 1].length > srcPos)
+                j--;
+            for (; j < i && matches[j].resPos < srcEnd; j++)
+                level[i] = std::max(level[i], level[j] + 1);
+            maxLevel = std::max(maxLevel, level[i]);
+        }
+        vector<size_t> levelPos(maxLevel + 2, 0);
+        for (size_t i = 0; i < matchesCount; i++)
+            levelPos[level[i] + 1]++;
+        for (uint32_t l = 0; l <= maxLevel; l++)
+            levelPos[l + 1] += levelPos[l];
+        vector<size_t> levelOrder(matchesCount);
+        {
+            vector<size_t> nextPos(levelPos.begin(), levelPos.end() - 1);
+            for (size_t i = 0; i < matchesCount; i++)
+                levelOrder[nextPos[level[i]]++] = i;
+        }
+        char* res = (char*) resPg.data();
+        for (uint32_t l = 0; l <= maxLevel; l++) {
+            #pragma omp parallel for schedule(guided)
+            for (size_t k = levelPos[l]; k < levelPos[l + 1]; k++)
+                copyMatch(res, res, matches[levelOrder[k]], revComplMatching);
+        }
+        *logout << "Restored " << matchesCount << " self-matches in " << (maxLevel + 1) << " dependency levels" << endl;
+    }
+
+    static inline uint64_t readUIntByteFrugal(std::streambuf* src) {
+        uint64_t value = 0;
+        uint64_t base = 1;
+        int yByte;
+        do {
+            yByte = src->sbumpc();
+            if (yByte == std::streambuf::traits_type::eof()) {
+                fprintf(stderr, "Error reading pseudogenome mapping lengths.\n");
+                exit(EXIT_FAILURE);
+            }
+            value += base * (yByte % 128);
+            base *= 128;
+        } while (yByte >= 128);
+        return value;
     }
 
     string
     SimplePgMatcher::restoreMatchedPg(string &srcPg, size_t orgSrcLen, const string &destPg, istream &pgMapOffSrc, istream &pgMapLenSrc,
                                       bool revComplMatching, bool plainTextReadMode, bool srcIsDest) {
+        return restoreMatchedPg(srcPg, orgSrcLen, destPg.data(), destPg.length(), pgMapOffSrc, pgMapLenSrc,
+                                revComplMatching, plainTextReadMode, srcIsDest);
+    }
+
+    string
+    SimplePgMatcher::restoreMatchedPg(string &srcPg, size_t orgSrcLen, const char* destPg, size_t destPgLength,
+                                      istream &pgMapOffSrc, istream &pgMapLenSrc,
+                                      bool revComplMatching, bool plainTextReadMode, bool srcIsDest) {
         bool isPgLengthStd = orgSrcLen <= UINT32_MAX;
-        if (srcIsDest)
-            srcPg.resize(0);
-        string tmp;
-        string &resPg = srcIsDest ? srcPg : tmp;
-        uint64_t posDest = 0;
+        if (srcIsDest) {
+            srcPg.clear();
+            srcPg.shrink_to_fit();
+        }
         uint32_t minMatchLength = 0;
-
         PgHelpers::readUIntByteFrugal(pgMapLenSrc, minMatchLength);
-        uint64_t markPos = 0;
-        while ((markPos = destPg.find(MATCH_MARK, posDest)) != std::string::npos) {
-            resPg.append(destPg, posDest, markPos - posDest);
-            posDest = markPos + 1;
-            uint64_t matchSrcPos = 0;
-            if (isPgLengthStd) {
-                uint32_t tmp;
-                PgHelpers::readValue<uint32_t>(pgMapOffSrc, tmp, plainTextReadMode);
-                matchSrcPos = tmp;
-            } else
-                PgHelpers::readValue<uint64_t>(pgMapOffSrc, matchSrcPos, plainTextReadMode);
-            uint64_t matchLength = 0;
-            PgHelpers::readUIntByteFrugal(pgMapLenSrc, matchLength);
-            matchLength += minMatchLength;
-            if (revComplMatching)
-                resPg.append(reverseComplement(srcPg.substr(matchSrcPos, matchLength)));
-            else
-                resPg.append(srcPg.substr(matchSrcPos, matchLength));
+
+        vector<uint64_t> markPos;
+        findMatchMarks(destPg, destPgLength, markPos);
+        const size_t matchesCount = markPos.size();
+        vector<RestoredMatch> matches(matchesCount);
+        if (!plainTextReadMode && isPgLengthStd) {
+            vector<uint32_t> offsets(matchesCount);
+            pgMapOffSrc.read((char*) offsets.data(), matchesCount * sizeof(uint32_t));
+            for (size_t i = 0; i < matchesCount; i++)
+                matches[i].srcPos = offsets[i];
+        } else if (!plainTextReadMode) {
+            vector<uint64_t> offsets(matchesCount);
+            pgMapOffSrc.read((char*) offsets.data(), matchesCount * sizeof(uint64_t));
+            for (size_t i = 0; i < matchesCount; i++)
+                matches[i].srcPos = offsets[i];
+        } else {
+            for (size_t i = 0; i < matchesCount; i++) {
+                if (isPgLengthStd) {
+                    uint32_t tmp;
+                    PgHelpers::readValue<uint32_t>(pgMapOffSrc, tmp, plainTextReadMode);
+                    matches[i].srcPos = tmp;
+                } else
+                    PgHelpers::readValue<uint64_t>(pgMapOffSrc, matches[i].srcPos, plainTextReadMode);
+            }
+        }
+        // prefix sums of matches lengths give positions in the restored sequence
+        std::streambuf* lengthsBuf = pgMapLenSrc.rdbuf();
+        uint64_t matchedLength = 0;
+        for (size_t i = 0; i < matchesCount; i++) {
+            matches[i].length = readUIntByteFrugal(lengthsBuf) + minMatchLength;
+            matches[i].resPos = markPos[i] - i + matchedLength;
+            matchedLength += matches[i].length;
+        }
+        if (!pgMapOffSrc) {
+            fprintf(stderr, "Error reading pseudogenome mapping offsets.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        string resPg;
+        resPg.resize(destPgLength - matchesCount + matchedLength);
+        char* res = (char*) resPg.data();
+        #pragma omp parallel for schedule(guided)
+        for (size_t i = 0; i <= matchesCount; i++) {
+            const uint64_t destBeg = i ? markPos[i - 1] + 1 : 0;
+            const uint64_t destEnd = i < matchesCount ? markPos[i] : destPgLength;
+            const uint64_t resBeg = i ? matches[i - 1].resPos + matches[i - 1].length : 0;
+            memcpy(res + resBeg, destPg + destBeg, destEnd - destBeg);
+        }
+        markPos.clear();
+        markPos.shrink_to_fit();
+        if (srcIsDest)
+            restoreSelfMatches(resPg, matches, revComplMatching);
+        else {
+            #pragma omp parallel for schedule(guided)
+            for (size_t i = 0; i < matchesCount; i++)
+                copyMatch(res, srcPg.data(), matches[i], revComplMatching);
         }
-        resPg.append(destPg, posDest, destPg.length() - posDest);
 
         cout << "Restored Pg sequence of length: " << resPg.length() << endl;
 
@@ -29,6 +29,16 @@ namespace PgTools {
 
         string getTotalMatchStat(uint_pg_len_max totalMatchLength);
 
+        struct RestoredMatch {
+            uint64_t srcPos;
+            uint64_t resPos;
+            uint64_t length;
+        };
+
+        static void findMatchMarks(const char *destPg, size_t destPgLength, vector<uint64_t> &markPos);
+        static void copyMatch(char *resPg, const char *srcPg, const RestoredMatch &match, bool revComplMatching);
+        static void restoreSelfMatches(string &resPg, const vector<RestoredMatch> &matches, bool revComplMatching);
+
     public:
         SimplePgMatcher(const string& srcPg, uint32_t targetMatchLength,
                 uint32_t minMatchLength = UINT32_MAX);
@@ -41,16 +51,58 @@ namespace PgTools {
 
         static void matchPgsInPg(string &hqPgSequence, string &lqPgSequence, string &nPgSequence,
                                     bool separateNReads, ostream &pgrcOut, uint8_t coder_level,
+                                    int pgSeqBlocksPerThread, size_t pgSeqPrimingLength,
                                     const string &hqPgPrefix, const string &lqPgPrefix, const string &nPgPrefix,
                                     uint_pg_len_max targetMatchLength, uint32_t minMatchLength = UINT32_MAX);
 
+        // random access mode: the joined pseudogenome (not matched) is coded in blocks of blockLength bases
+        // (var-len coded blocks are primed with the first block when LZMA coded)
+        static void writePgsInBlocks(string &hqPgSequence, string &lqPgSequence, string &nPgSequence,
+                                     ostream &pgrcOut, uint8_t coder_level, uint32_t blockLength);
+
+        struct PgsBlocks {
+            uint64_t joinedPgLength;
+            uint32_t blockLength;
+            uint64_t blocksCount;
+            bool primed;
+            // id of the first block in the index of streams
+            uint32_t firstStreamId;
+        };
+
+        // streams of blocks are skipped (to be read through the index of streams)
+        static void readPgsBlocksProps(istream &pgrcIn, uint64_t joinedPgLength, PgsBlocks &pgsBlocks);
+        // concatenated bases of selected blocks (given in ascending order)
+        static void readPgsBlocks(const IndexedArchive &archive, const PgsBlocks &pgsBlocks,
+                                  const vector<uint64_t> &blocks, string &blocksSequence);
+
         static void restoreMatchedPgs(istream &pgrcIn, uint_pg_len_max orgHqPgLen,
                 string &hqPgSequence, string &lqPgSequence, string &nPgSequence, PgRCParams* params);
 
+        // staged restoration (allows using the HQ pseudogenome before LQ and N pseudogenomes are restored)
+        // mapped pseudogenomes are restored directly from the decompressed combo stream (HQ, LQ and N parts)
+        struct MatchedPgsStreams {
+            string comboPgMapped;
+            uint_pg_len_max hqPgMappedLen, lqPgMappedLen, nPgMappedLen;
+            string hqPgMapOff, hqPgMapLen, lqPgMapOff, lqPgMapLen, nPgMapOff, nPgMapLen;
+        };
+
+        // mapping streams of skipped LQ or N pseudogenomes are not decompressed
+        static void readMatchedPgs(istream &pgrcIn, MatchedPgsStreams &matchedPgs, PgRCParams* params,
+                bool readLqPg = true, bool readNPg = true);
+        static void restoreMatchedHqPg(MatchedPgsStreams &matchedPgs, uint_pg_len_max orgHqPgLen, string &hqPgSequence);
+        // releases matched pseudogenomes streams (skipped pseudogenomes are left empty)
+        static void restoreMatchedLqAndNPgs(MatchedPgsStreams &matchedPgs, string &hqPgSequence,
+                uint_pg_len_max orgHqPgLen, string &lqPgSequence, string &nPgSequence,
+                bool restoreLqPg = true, bool restoreNPg = true);
+
         static string restoreMatchedPg(string &srcPg, size_t orgSrcLen, const string& destPg,
                 istream &pgMapOffSrc, istream &pgMapLenSrc,
                 bool revComplMatching, bool plainTextReadMode, bool srcIsDest = false);
 
+        static string restoreMatchedPg(string &srcPg, size_t orgSrcLen, const char* destPg, size_t destPgLength,
+                istream &pgMapOffSrc, istream &pgMapLenSrc,
+                bool revComplMatching, bool plainTextReadMode, bool srcIsDest = false);
+
         static string restoreMatchedPg(string &srcPg, const string& destPgPrefix,
                                        bool revComplMatching, bool plainTextReadMode);
 
@@ -2,6 +2,11 @@
 
 #include "../matching/SimplePgMatcher.h"
 
+#include <charconv>
+#include <climits>
+#include <fcntl.h>
+#include <unistd.h>
+
 namespace PgTools {
 
     void PgRCDecoder::decompressPgRC() {
@@ -42,6 +47,8 @@ namespace PgTools {
             params->separateNReads = (bool) pgrcIn.get();
             if (pgrc_mode == PGRC_PE_MODE || pgrc_mode == PGRC_ORD_PE_MODE)
                 params->revComplPairFile = (bool) pgrcIn.get();
+            if ((pgrc_mode == PGRC_ORD_SE_MODE || pgrc_mode == PGRC_ORD_PE_MODE) && params->isVersionAtLeast(3, 1))
+                params->randomAccessMode = (bool) pgrcIn.get();
 
             pgrcIn >> tmpDirectoryPath;
             tmpDirectoryPath = tmpDirectoryPath + "/";
@@ -57,6 +64,18 @@ namespace PgTools {
         params->preserveOrderMode = pgrc_mode == PGRC_ORD_SE_MODE || pgrc_mode == PGRC_ORD_PE_MODE;
         params->ignorePairOrderInformation = pgrc_mode == PGRC_MIN_PE_MODE;
         params->singleReadsMode = pgrc_mode == PGRC_SE_MODE || pgrc_mode == PGRC_ORD_SE_MODE;
+        if (params->isReadsRangeSelected() && !params->preserveOrderMode) {
+            fprintf(stderr, "Selecting a range of reads requires an archive preserving the original order of reads.\n");
+            exit(EXIT_FAILURE);
+        }
+        if (params->randomAccessMode) {
+            decompressRandomAccessBlocks(pgrcIn);
+            uint64_t rangeBegin, rangeEnd;
+            getReadsRange(rangeBegin, rangeEnd);
+            cout << "Decompressed " << (rangeEnd - rangeBegin) * (params->singleReadsMode ? 1 : 2) << " reads in "
+                 << time_millis(start_t) << " msec." << endl;
+            return;
+        }
         if (pgrcIn)
             loadAllPgs(pgrcIn);
         else
@@ -74,15 +93,23 @@ namespace PgTools {
                 applyRevComplPairFileToPgs<uint_pg_len_max>(data.orgIdx2PgPos);
             }
         }
-        if (params->srcFastqFile.empty()) {
+        if (hqReadsStreaming.joinable()) {
+            finishStreamingReadsInSEMode();
+            cout << "Decompressed ";
+        } else if (params->srcFastqFile.empty()) {
             if (params->singleReadsMode && !params->preserveOrderMode) {
-                writeAllReadsInSEModeParallelWritingThreads(params->pgRCFileName);
+                writeAllReadsInSEModeParallelWritingThreads();
             } else if (!params->preserveOrderMode) {
-                writeAllReadsInPEModeParallelChunks(params->pgRCFileName);
+                writeAllReadsInPEModeParallelChunks();
             } else if (params->isJoinedPgLengthStd) {
-                writeAllReadsInORDModeParallelChunks<uint_pg_len_std>(params->pgRCFileName, data.orgIdx2StdPgPos);
+                writeAllReadsInORDModeParallelChunks<uint_pg_len_std>(data.orgIdx2StdPgPos);
             } else {
-                writeAllReadsInORDModeParallelChunks<uint_pg_len_max>(params->pgRCFileName, data.orgIdx2PgPos);
+                writeAllReadsInORDModeParallelChunks<uint_pg_len_max>(data.orgIdx2PgPos);
+            }
+            if (params->isReadsRangeSelected()) {
+                uint64_t rangeBegin, rangeEnd;
+                getReadsRange(rangeBegin, rangeEnd);
+                readsTotalCount = (rangeEnd - rangeBegin) * (params->singleReadsMode ? 1 : 2);
             }
             cout << "Decompressed ";
         } else {
@@ -97,49 +124,209 @@ namespace PgTools {
         data.disposeChainData();
     }
 
-    static constexpr timespec WRITE_THREAD_SLEEP_TIME[] {{0, 1000L}};
-
-    void PgRCDecoder::pushOutToQueue(string &out, bool pairFile) {
-        int id = pairFile ? 1 : 0;
-        while (out_queue[id].size() >= decodingThreadsCount * QUEUE_LIMIT_PER_DECODING_THREAD)
-            nanosleep(WRITE_THREAD_SLEEP_TIME, nullptr);
-        std::lock_guard<std::mutex> _(this->mut[id]);
-        out_queue[id].push(std::move(out));
-        data_cond[id].notify_one();
-        out.resize(0);
-        out.reserve(CHUNK_SIZE_IN_BYTES);
-    }
-
-    void PgRCDecoder::finishWritingParallel(bool pairFile) {
-        int id = pairFile ? 1 : 0;
-        std::lock_guard<std::mutex> _(this->mut[id]);
-        out_queue[id].push(std::move(""));
-        data_cond[id].notify_one();
-    }
-
-    void PgRCDecoder::writeFromQueue(const string outFileName, bool pairFile) {
-        int id = pairFile ? 1 : 0;
-        fstream fout(outFileName, ios_base::out | ios_base::binary | std::ios::trunc);
-        string out;
-        do {
-            std::unique_lock<std::mutex> lk(mut[id]);
-            data_cond[id].wait(
-                    lk, [&, this] { return !out_queue[id].empty(); });
-            out = out_queue[id].front();
-            out_queue[id].pop();
-            lk.unlock();
-            PgHelpers::writeArray(fout, (void*) out.data(), out.size());
-        } while (!out.empty());
-        fout.close();
-    }
-
-
-    void PgRCDecoder::writeAllReadsInSEModeParallelWritingThreads(const string &outPrefix) {
-        int threadsLimit = PARALLEL_DECODING_THREADS_LIMIT + 1;
-        threadsLimit = PgHelpers::numberOfThreads < threadsLimit? PgHelpers::numberOfThreads : threadsLimit;
-        decodingThreadsCount = threadsLimit - 1;
-        if (decodingThreadsCount <= 0 || dnaStreamSize() <= CHUNK_SIZE_IN_BYTES) {
-            writeAllReadsInSEModeSequential(outPrefix);
+    ReadsOutput::ReadsOutput(const string &outputName) {
+        if (outputName == STDOUT_OUTPUT_NAME) {
+            fd = STDOUT_FILENO;
+        } else if (outputName.compare(0, strlen(FD_OUTPUT_PREFIX), FD_OUTPUT_PREFIX) == 0) {
+            const char* fdStr = outputName.c_str() + strlen(FD_OUTPUT_PREFIX);
+            char* end;
+            long fdVal = strtol(fdStr, &end, 10);
+            if (end == fdStr || *end || fdVal < 0 || fdVal > INT_MAX || fcntl((int) fdVal, F_GETFD) == -1)
+                fd = -1;
+            else
+                fd = (int) fdVal;
+        } else {
+            fd = open(outputName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            ownDescriptor = true;
+        }
+        if (fd < 0) {
+            fprintf(stderr, "Error opening output %s.\n", outputName.c_str());
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    ReadsOutput::~ReadsOutput() {
+        if (ownDescriptor)
+            close(fd);
+    }
+
+    void ReadsOutput::write(const char *data, size_t length) {
+        while (length > 0) {
+            ssize_t written = ::write(fd, data, length);
+            if (written < 0) {
+                if (errno == EINTR)
+                    continue;
+                fprintf(stderr, "Error writing decompressed reads (%s).\n", strerror(errno));
+                exit(EXIT_FAILURE);
+            }
+            data += written;
+            length -= written;
+        }
+    }
+
+    bool ReadsOutput::isStream(const string &outputName) {
+        return outputName == STDOUT_OUTPUT_NAME ||
+               outputName.compare(0, strlen(FD_OUTPUT_PREFIX), FD_OUTPUT_PREFIX) == 0;
+    }
+
+    bool ReadsOutput::isStdout(const string &outputName) {
+        return outputName == STDOUT_OUTPUT_NAME || outputName == string(FD_OUTPUT_PREFIX) + "1";
+    }
+
+    ChunksRingWriter::ChunksRingWriter(const string &outputName, int slotsCount, size_t chunkCapacity) :
+            slotsCount(slotsCount), slots(new Slot[slotsCount]), writtenChunks(0), chunksCount(INT64_MAX),
+            out(outputName) {
+        for (int i = 0; i < slotsCount; i++) {
+            slots[i].readyChunk.store(-1, std::memory_order_relaxed);
+            slots[i].buffer.reserve(chunkCapacity);
+        }
+        writing = std::thread(&ChunksRingWriter::writeChunks, this);
+    }
+
+    ChunksRingWriter::~ChunksRingWriter() {
+        if (writing.joinable()) {
+            fprintf(stderr, "Error: output writing has not been finished.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    string &ChunksRingWriter::acquireChunk(int64_t chunk) {
+        if (writtenChunks.load(std::memory_order_acquire) + slotsCount <= chunk) {
+            std::unique_lock<std::mutex> lock(waitingMutex);
+            slotReleased.wait(lock, [&] { return writtenChunks.load(std::memory_order_acquire) + slotsCount > chunk; });
+        }
+        string &buffer = slots[chunk % slotsCount].buffer;
+        buffer.resize(0);
+        return buffer;
+    }
+
+    void ChunksRingWriter::publishChunk(int64_t chunk) {
+        slots[chunk % slotsCount].readyChunk.store(chunk, std::memory_order_release);
+        std::lock_guard<std::mutex> lock(waitingMutex);
+        chunkPublished.notify_one();
+    }
+
+    void ChunksRingWriter::finish(int64_t chunksCount) {
+        this->chunksCount.store(chunksCount, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(waitingMutex);
+            chunkPublished.notify_one();
+        }
+        writing.join();
+    }
+
+    void ChunksRingWriter::writeChunks() {
+        for (int64_t c = 0; ; c++) {
+            Slot &slot = slots[c % slotsCount];
+            if (slot.readyChunk.load(std::memory_order_acquire) != c) {
+                std::unique_lock<std::mutex> lock(waitingMutex);
+                chunkPublished.wait(lock, [&] { return slot.readyChunk.load(std::memory_order_acquire) == c ||
+                                                       chunksCount.load(std::memory_order_acquire) <= c; });
+                if (slot.readyChunk.load(std::memory_order_acquire) != c)
+                    return;
+            }
+            out.write(slot.buffer.data(), slot.buffer.size());
+            writtenChunks.store(c + 1, std::memory_order_release);
+            std::lock_guard<std::mutex> lock(waitingMutex);
+            slotReleased.notify_all();
+        }
+    }
+
+    string PgRCDecoder::getOutputName(bool pairedFiles, bool pairFile) const {
+        string name = params->outputName.empty() ? params->pgRCFileName + "_out" : params->outputName;
+        return pairedFiles ? name + (pairFile ? "_2" : "_1") : name;
+    }
+
+    bool PgRCDecoder::isInterleavedOutput() const {
+        return !params->singleReadsMode && ReadsOutput::isStream(params->outputName);
+    }
+
+    size_t PgRCDecoder::getMaxRecordLength() const {
+        const size_t readRecordLength = params->readLength + 1;
+        switch (params->outputFormat) {
+            case OUTPUT_FASTA_FORMAT:
+                return 1 + MAX_RECORD_ID_DIGITS + 1 + readRecordLength;
+            case OUTPUT_FASTQ_FORMAT:
+                return 1 + MAX_RECORD_ID_DIGITS + 1 + readRecordLength + 2 + readRecordLength;
+            default:
+                return readRecordLength;
+        }
+    }
+
+    inline char* PgRCDecoder::beginRecord(char *dest, uint64_t recordId) const {
+        if (params->outputFormat == OUTPUT_SEQ_FORMAT)
+            return dest;
+        *dest++ = params->outputFormat == OUTPUT_FASTQ_FORMAT ? '@' : '>';
+        dest = std::to_chars(dest, dest + MAX_RECORD_ID_DIGITS, recordId).ptr;
+        *dest++ = '\n';
+        return dest;
+    }
+
+    inline char* PgRCDecoder::endRecord(char *readDest) const {
+        char* dest = readDest + params->readLength;
+        *dest++ = '\n';
+        if (params->outputFormat == OUTPUT_FASTQ_FORMAT) {
+            *dest++ = '+';
+            *dest++ = '\n';
+            memset(dest, OUTPUT_FASTQ_QUALITY_SCORE, params->readLength);
+            dest += params->readLength;
+            *dest++ = '\n';
+        }
+        return dest;
+    }
+
+    void PgRCDecoder::getReadsRange(uint64_t &begin, uint64_t &end) const {
+        const uint64_t partReadsCount = params->readsTotalCount / (params->singleReadsMode ? 1 : 2);
+        end = std::min<uint64_t>(params->readsRangeEnd, partReadsCount);
+        begin = std::min<uint64_t>(params->readsRangeBegin, end);
+    }
+
+    template<typename uint_pg_len>
+    void PgRCDecoder::findPgsOfReadsRange(const vector<uint_pg_len> &orgIdx2PgPos, bool &lqPgRequired,
+                                          bool &nPgRequired) const {
+        uint64_t rangeBegin, rangeEnd;
+        getReadsRange(rangeBegin, rangeEnd);
+        const uint8_t parts = params->singleReadsMode ? 1 : 2;
+        const uint64_t partReadsCount = params->readsTotalCount / parts;
+        lqPgRequired = false;
+        nPgRequired = false;
+        for (uint8_t p = 0; p < parts; p++) {
+            for (uint64_t i = partReadsCount * p + rangeBegin; i < partReadsCount * p + rangeEnd; i++) {
+                if (orgIdx2PgPos[i] >= params->nonNPgLen)
+                    nPgRequired = true;
+                else if (orgIdx2PgPos[i] >= params->hqPgLen)
+                    lqPgRequired = true;
+            }
+        }
+    }
+
+    template void PgRCDecoder::findPgsOfReadsRange<uint_pg_len_std>(const vector<uint_pg_len_std> &orgIdx2PgPos,
+            bool &lqPgRequired, bool &nPgRequired) const;
+
+    template void PgRCDecoder::findPgsOfReadsRange<uint_pg_len_max>(const vector<uint_pg_len_max> &orgIdx2PgPos,
+            bool &lqPgRequired, bool &nPgRequired) const;
+
+    int PgRCDecoder::getParallelDecodingThreadsCount() const {
+        return PgHelpers::numberOfThreads - 1;
+    }
+
+    uint64_t PgRCDecoder::getReadsPerChunk(uint64_t readsCount) const {
+        const uint64_t recordLength = getMaxRecordLength();
+        uint64_t chunkSize = readsCount * recordLength / (decodingThreadsCount * CHUNKS_PER_DECODING_THREAD);
+        chunkSize = chunkSize < MIN_CHUNK_SIZE_IN_BYTES ? MIN_CHUNK_SIZE_IN_BYTES :
+                (chunkSize > MAX_CHUNK_SIZE_IN_BYTES ? MAX_CHUNK_SIZE_IN_BYTES : chunkSize);
+        return chunkSize < recordLength ? 1 : chunkSize / recordLength;
+    }
+
+    ChunksRingWriter* PgRCDecoder::createChunksRingWriter(const string &outputName, uint64_t readsPerChunk) const {
+        return new ChunksRingWriter(outputName, decodingThreadsCount * RING_SLOTS_PER_DECODING_THREAD,
+                                    readsPerChunk * getMaxRecordLength());
+    }
+
+    void PgRCDecoder::writeAllReadsInSEModeParallelWritingThreads() {
+        decodingThreadsCount = getParallelDecodingThreadsCount();
+        if (decodingThreadsCount <= 0 || dnaStreamSize() <= MIN_CHUNK_SIZE_IN_BYTES) {
+            writeAllReadsInSEModeSequential();
             return;
         }
         data.hqPg->getReadsList()->enableConstantAccess(true);
@@ -147,103 +334,109 @@ namespace PgTools {
         if (data.nPg) data.nPg->getReadsList()->enableConstantAccess(true);
         *PgHelpers::logout << "... enabled constant access (checkpoint: " << time_millis(start_t) << " msec.)" << endl;
 
-        std::thread writing(&PgRCDecoder::writeFromQueue, this, outPrefix + "_out", false);
-        string res, read;
-        read.resize(params->readLength);
-        uint64_t reads_per_chunk = CHUNK_SIZE_IN_BYTES / (params->readLength + 1);
-        uint64_t hq_full_chunks_count = params->hqReadsCount / reads_per_chunk;
-#pragma omp parallel for ordered schedule(static, 1) firstprivate(read, res) num_threads(decodingThreadsCount)
-        for (int64_t c = 0; c <= hq_full_chunks_count; c++) {
-            res.resize(0);
-            res.reserve(CHUNK_SIZE_IN_BYTES);
-            uint64_t i_guard = c == hq_full_chunks_count ? params->hqReadsCount : (c + 1) * reads_per_chunk;
-            for (uint_reads_cnt_max i = c * reads_per_chunk; i < i_guard; i++) {
-                data.hqPg->getRead_Unsafe(i, (char *) read.data());
-                res.append(read);
-                res.push_back('\n');
-            }
-            pushOutToQueue(res);
-        }
+        seModeWriter = createChunksRingWriter(getOutputName(), getReadsPerChunk(params->readsTotalCount));
+        seModeChunksCount = 0;
+        seModeReadsCount = 0;
+        pushReadsChunksInSEMode(data.hqPg, params->hqReadsCount, true);
+        pushReadsChunksInSEMode(data.lqPg, params->lqReadsCount, false);
+        if (data.nPg) pushReadsChunksInSEMode(data.nPg, params->nPgReadsCount, false);
 
-        uint64_t lq_full_chunks_count = params->lqReadsCount / reads_per_chunk;
-#pragma omp parallel for ordered schedule(static, 1) firstprivate(read, res) num_threads(decodingThreadsCount)
-        for (int64_t c = 0; c <= lq_full_chunks_count; c++) {
-            res.resize(0);
-            res.reserve(CHUNK_SIZE_IN_BYTES);
-            uint64_t i_guard = c == lq_full_chunks_count ? params->lqReadsCount : (c + 1) * reads_per_chunk;
-            for (uint_reads_cnt_max i = c * reads_per_chunk; i < i_guard; i++) {
-                data.lqPg->getRead_RawSequence(i, (char *) read.data());
-                res.append(read);
-                res.push_back('\n');
-            }
-            pushOutToQueue(res);
-        }
+        *PgHelpers::logout << "... finished loading queue (checkpoint: " << time_millis(start_t) << " msec.)" << endl;
+        seModeWriter->finish(seModeChunksCount);
+        delete (seModeWriter);
+        seModeWriter = nullptr;
+    }
 
-        uint64_t n_full_chunks_count = params->nPgReadsCount / reads_per_chunk;
-#pragma omp parallel for ordered schedule(static, 1) firstprivate(read, res) num_threads(decodingThreadsCount)
-        for (int64_t c = 0; c <= n_full_chunks_count; c++) {
-            res.resize(0);
-            res.reserve(CHUNK_SIZE_IN_BYTES);
-            uint64_t i_guard = c == n_full_chunks_count ? params->nPgReadsCount : (c + 1) * reads_per_chunk;
+    void PgRCDecoder::pushReadsChunksInSEMode(SeparatedPseudoGenome *pg, uint_reads_cnt_max readsCount, bool hqReads) {
+        const uint64_t reads_per_chunk = getReadsPerChunk(params->readsTotalCount);
+        const int64_t chunks_count = (readsCount + reads_per_chunk - 1) / reads_per_chunk;
+        const int64_t chunks_offset = seModeChunksCount;
+        const uint64_t first_record_id = seModeReadsCount + 1;
+        const size_t recordLength = getMaxRecordLength();
+#pragma omp parallel for schedule(dynamic, 1) num_threads(decodingThreadsCount)
+        for (int64_t c = 0; c < chunks_count; c++) {
+            const uint64_t i_guard = c == chunks_count - 1 ? readsCount : (c + 1) * reads_per_chunk;
+            string &res = seModeWriter->acquireChunk(chunks_offset + c);
+            res.resize((i_guard - c * reads_per_chunk) * recordLength);
+            char* recordPtr = (char*) res.data();
             for (uint_reads_cnt_max i = c * reads_per_chunk; i < i_guard; i++) {
-                data.nPg->getRead_RawSequence(i, (char *) read.data());
-                res.append(read);
-                res.push_back('\n');
+                char* readPtr = beginRecord(recordPtr, first_record_id + i);
+                if (hqReads)
+                    pg->getRead_Unsafe(i, readPtr);
+                else
+                    pg->getRead_RawSequence(i, readPtr);
+                recordPtr = endRecord(readPtr);
             }
-            pushOutToQueue(res);
+            res.resize(recordPtr - res.data());
+            seModeWriter->publishChunk(chunks_offset + c);
         }
-        pushOutToQueue(res);
+        seModeChunksCount += chunks_count;
+        seModeReadsCount += readsCount;
+    }
 
-        *PgHelpers::logout << "... finished loading queue (checkpoint: " << time_millis(start_t) << " msec.)" << endl;
-        finishWritingParallel();
-        writing.join();
+    bool PgRCDecoder::isSEModeStreamingApplicable() const {
+        return params->srcFastqFile.empty() && params->singleReadsMode && !params->preserveOrderMode &&
+               getParallelDecodingThreadsCount() > 0 &&
+               (uint64_t) params->readsTotalCount * (params->readLength + 1) > MIN_CHUNK_SIZE_IN_BYTES;
     }
 
+    void PgRCDecoder::streamHqReadsInSEMode() {
+        seModeWriter = createChunksRingWriter(getOutputName(), getReadsPerChunk(params->readsTotalCount));
+        seModeChunksCount = 0;
+        seModeReadsCount = 0;
+        data.hqPg->getReadsList()->enableConstantAccess(true);
+        *PgHelpers::logout << "... enabled HQ constant access (checkpoint: " << time_millis(start_t) << " msec.)" << endl;
+        pushReadsChunksInSEMode(data.hqPg, params->hqReadsCount, true);
+        *PgHelpers::logout << "... streamed HQ reads (checkpoint: " << time_millis(start_t) << " msec.)" << endl;
+    }
 
-    void PgRCDecoder::writeAllReadsInSEModeSequential(const string &outPrefix) const {
-        fstream fout(outPrefix + "_out", ios_base::out | ios_base::binary | std::ios::trunc);
-        string res, read;
-        read.resize(params->readLength);
-        uint64_t res_size_guard = CHUNK_SIZE_IN_BYTES;
-        uint64_t totalSize = dnaStreamSize();
-        res.reserve(totalSize < res_size_guard ? totalSize : res_size_guard + (params->readLength + 1));
-        for (uint_reads_cnt_max i = 0; i < params->hqReadsCount; i++) {
-            if (res.size() > res_size_guard) {
-                fout << res;
-                res.resize(0);
-            }
-            data.hqPg->getNextRead_Unsafe((char *) read.data());
-            res.append(read);
-            res.push_back('\n');
-        }
-        for (uint_reads_cnt_max i = 0; i < params->lqReadsCount; i++) {
-            if (res.size() > res_size_guard) {
-                fout << res;
-                res.resize(0);
-            }
-            data.lqPg->getNextRead_RawSequence((char *) read.data());
-            res.append(read);
-            res.push_back('\n');
-        }
-        for (uint_reads_cnt_max i = 0; i < params->nPgReadsCount; i++) {
-            if (res.size() > res_size_guard) {
-                fout << res;
-                res.resize(0);
+    void PgRCDecoder::finishStreamingReadsInSEMode() {
+        hqReadsStreaming.join();
+        // HQ pseudogenome is no longer needed (LQ and N pseudogenomes are already restored)
+        delete (data.hqPg);
+        data.hqPg = nullptr;
+        data.lqPg->getReadsList()->enableConstantAccess(true);
+        if (data.nPg) data.nPg->getReadsList()->enableConstantAccess(true);
+        *PgHelpers::logout << "... enabled LQ&N constant access (checkpoint: " << time_millis(start_t) << " msec.)" << endl;
+        pushReadsChunksInSEMode(data.lqPg, params->lqReadsCount, false);
+        if (data.nPg) pushReadsChunksInSEMode(data.nPg, params->nPgReadsCount, false);
+        *PgHelpers::logout << "... finished loading queue (checkpoint: " << time_millis(start_t) << " msec.)" << endl;
+        seModeWriter->finish(seModeChunksCount);
+        delete (seModeWriter);
+        seModeWriter = nullptr;
+    }
+
+    void PgRCDecoder::writeAllReadsInSEModeSequential() const {
+        ReadsOutput out(getOutputName());
+        string res;
+        res.resize(CHUNK_SIZE_IN_BYTES + getMaxRecordLength());
+        char* const resBeg = (char*) res.data();
+        char* const resGuard = resBeg + CHUNK_SIZE_IN_BYTES;
+        char* recordPtr = resBeg;
+        uint64_t recordId = 1;
+        SeparatedPseudoGenome* pgs[] = { data.hqPg, data.lqPg, data.nPg };
+        const uint_reads_cnt_max readsCounts[] = { params->hqReadsCount, params->lqReadsCount, params->nPgReadsCount };
+        for (int p = 0; p < 3; p++) {
+            for (uint_reads_cnt_max i = 0; i < readsCounts[p]; i++) {
+                if (recordPtr > resGuard) {
+                    out.write(resBeg, recordPtr - resBeg);
+                    recordPtr = resBeg;
+                }
+                char* readPtr = beginRecord(recordPtr, recordId++);
+                if (p == 0)
+                    data.hqPg->getNextRead_Unsafe(readPtr);
+                else
+                    pgs[p]->getNextRead_RawSequence(readPtr);
+                recordPtr = endRecord(readPtr);
             }
-            data.nPg->getNextRead_RawSequence((char *) read.data());
-            res.append(read);
-            res.push_back('\n');
         }
-        fout << res;
-        fout.close();
+        out.write(resBeg, recordPtr - resBeg);
     }
 
-    void PgRCDecoder::writeAllReadsInPEModeParallelChunks(const string &outPrefix) {
-        int threadsLimit = PARALLEL_DECODING_THREADS_LIMIT + 1;
-        threadsLimit = PgHelpers::numberOfThreads < threadsLimit? PgHelpers::numberOfThreads : threadsLimit;
-        decodingThreadsCount = threadsLimit - 1;
-        if (decodingThreadsCount < 4) {
-            writeAllReadsInPEModeEachFileSequentialWithWritingThreads(outPrefix);
+    void PgRCDecoder::writeAllReadsInPEModeParallelChunks() {
+        decodingThreadsCount = getParallelDecodingThreadsCount();
+        if (decodingThreadsCount <= 0) {
+            writeAllReadsInPEModeEachFileSequential();
             return;
         }
         data.hqPg->getReadsList()->enableConstantAccess(true);
@@ -251,21 +444,29 @@ namespace PgTools {
         if (data.nPg) data.nPg->getReadsList()->enableConstantAccess(true);
         *PgHelpers::logout << "... enabled constant access (checkpoint: " << time_millis(start_t) << " msec.)" << endl;
         const uint8_t PE_PARTS_COUNT = 2;
-        const uint64_t pe_reads_per_chunk = CHUNK_SIZE_IN_BYTES / (params->readLength + 1) * PE_PARTS_COUNT;
-        const uint64_t full_chunks_count = params->readsTotalCount / pe_reads_per_chunk;
-
-        for (uint8_t p = 0; p < PE_PARTS_COUNT; p++) {
-            bool pairFile = p == 1;
-            std::thread writing(&PgRCDecoder::writeFromQueue, this, outPrefix + "_out_" + (pairFile ? "2" : "1"), pairFile);
-            string res, read;
-            read.resize(params->readLength);
-#pragma omp parallel for ordered schedule(static, 1) firstprivate(read, res) num_threads(decodingThreadsCount)
-            for (int64_t c = 0; c <= full_chunks_count; c++) {
-                res.resize(0);
-                res.reserve(CHUNK_SIZE_IN_BYTES);
-                char *readPtr = (char *) read.data();
-                uint64_t i_guard = c == full_chunks_count ? params->readsTotalCount : p + (c + 1) * pe_reads_per_chunk;
-                for (uint_reads_cnt_max i = p + c * pe_reads_per_chunk; i < i_guard; i += PE_PARTS_COUNT) {
+        const bool interleaved = isInterleavedOutput();
+        const uint8_t files_count = interleaved ? 1 : PE_PARTS_COUNT;
+        // k-th record of a file is the i-th read in rlIdxOrder (i = k or i = 2 * k + f)
+        const uint64_t records_count = params->readsTotalCount / files_count;
+        const uint64_t records_per_chunk = getReadsPerChunk(records_count);
+        const int64_t chunks_count = (records_count + records_per_chunk - 1) / records_per_chunk;
+        const size_t recordLength = getMaxRecordLength();
+        const uint_read_len_max readLength = params->readLength;
+
+        for (uint8_t f = 0; f < files_count; f++) {
+            bool pairFile = f == 1;
+            ChunksRingWriter* writer = createChunksRingWriter(getOutputName(!interleaved, pairFile),
+                                                              records_per_chunk);
+#pragma omp parallel for schedule(dynamic, 1) num_threads(decodingThreadsCount)
+            for (int64_t c = 0; c < chunks_count; c++) {
+                uint64_t k_guard = c == chunks_count - 1 ? records_count : (c + 1) * records_per_chunk;
+                string &res = writer->acquireChunk(c);
+                res.resize((k_guard - c * records_per_chunk) * recordLength);
+                char *recordPtr = (char *) res.data();
+                for (uint64_t k = c * records_per_chunk; k < k_guard; k++) {
+                    const uint_reads_cnt_max i = interleaved ? k : k * PE_PARTS_COUNT + f;
+                    const uint8_t p = i % PE_PARTS_COUNT;
+                    char* readPtr = beginRecord(recordPtr, i / PE_PARTS_COUNT + 1);
                     uint_reads_cnt_std idx = data.rlIdxOrder[i];
                     if (idx < params->hqReadsCount)
                         data.hqPg->getRead(idx, readPtr);
@@ -275,49 +476,44 @@ namespace PgTools {
                         else
                             data.nPg->getRead_RawSequence(idx - params->nonNPgReadsCount, readPtr);
                         if (p)
-                            PgHelpers::reverseComplementInPlace(readPtr, params->readLength);
+                            PgHelpers::reverseComplementInPlace(readPtr, readLength);
                     }
-                    res.append(read);
-                    res.push_back('\n');
+                    recordPtr = endRecord(readPtr);
                 }
-#pragma omp ordered
-                pushOutToQueue(res, pairFile);
+                res.resize(recordPtr - res.data());
+                writer->publishChunk(c);
             }
             *PgHelpers::logout << "... finished loading queue " << (pairFile ? "2" : "1") << " (checkpoint: " << time_millis(start_t) << " msec.)" << endl;
-            finishWritingParallel(pairFile);
-            writing.join();
+            writer->finish(chunks_count);
+            delete (writer);
         }
     }
 
-    void PgRCDecoder::writeAllReadsInPEModeEachFileSequentialWithWritingThreads(const string &outPrefix) {
-        if (PgHelpers::numberOfThreads < 4) {
-            writeAllReadsInPEModeEachFileSequential(outPrefix);
-            return;
-        }
-        decodingThreadsCount = 1;
-
+    void PgRCDecoder::writeAllReadsInPEModeEachFileSequential() const {
         data.hqPg->getReadsList()->enableConstantAccess(true);
         data.lqPg->getReadsList()->enableConstantAccess(true);
         if (data.nPg) data.nPg->getReadsList()->enableConstantAccess(true);
         *PgHelpers::logout << "... enabled constant access (checkpoint: " << time_millis(start_t) << " msec.)" << endl;
         const uint8_t PE_PARTS_COUNT = 2;
+        const bool interleaved = isInterleavedOutput();
+        const uint8_t files_count = interleaved ? 1 : PE_PARTS_COUNT;
+        const uint8_t step = interleaved ? 1 : PE_PARTS_COUNT;
 
 #pragma omp parallel for
-        for (uint8_t p = 0; p < PE_PARTS_COUNT; p++) {
-            bool pairFile = p == 1;
-            std::thread writing(&PgRCDecoder::writeFromQueue, this, outPrefix + "_out_" + (pairFile ? "2" : "1"), pairFile);
-            string res, read;
-            read.resize(params->readLength);
-            char *readPtr = (char *) read.data();
-            uint64_t res_size_guard = CHUNK_SIZE_IN_BYTES;
-            uint64_t totalSize = dnaStreamSize();
-            res.reserve(totalSize < res_size_guard ? totalSize : res_size_guard + (params->readLength + 1));
-            uint_reads_cnt_max i = 0;
-            for (i = p; i < params->readsTotalCount; i += PE_PARTS_COUNT) {
-                if (res.size() > res_size_guard) {
-                    pushOutToQueue(res, pairFile);
-                    res.resize(0);
+        for (uint8_t f = 0; f < files_count; f++) {
+            ReadsOutput out(getOutputName(!interleaved, f == 1));
+            string res;
+            res.resize(CHUNK_SIZE_IN_BYTES + getMaxRecordLength());
+            char* const resBeg = (char*) res.data();
+            char* const resGuard = resBeg + CHUNK_SIZE_IN_BYTES;
+            char* recordPtr = resBeg;
+            for (uint_reads_cnt_max i = f; i < params->readsTotalCount; i += step) {
+                if (recordPtr > resGuard) {
+                    out.write(resBeg, recordPtr - resBeg);
+                    recordPtr = resBeg;
                 }
+                const uint8_t p = i % PE_PARTS_COUNT;
+                char* readPtr = beginRecord(recordPtr, i / PE_PARTS_COUNT + 1);
                 uint_reads_cnt_std idx = data.rlIdxOrder[i];
                 if (idx < params->hqReadsCount)
                     data.hqPg->getRead(idx, readPtr);
@@ -329,184 +525,109 @@ namespace PgTools {
                     if (p)
                         PgHelpers::reverseComplementInPlace(readPtr, params->readLength);
                 }
-                res.append(read);
-                res.push_back('\n');
+                recordPtr = endRecord(readPtr);
             }
-            pushOutToQueue(res, pairFile);
-            *PgHelpers::logout << "... finished loading queue " << (pairFile ? "2" : "1") << " (checkpoint: " << time_millis(start_t) << " msec.)" << endl;
-            finishWritingParallel(pairFile);
-            writing.join();
-        }
-    }
-
-    void PgRCDecoder::writeAllReadsInPEModeEachFileSequential(const string &outPrefix) const {
-        data.hqPg->getReadsList()->enableConstantAccess(true);
-        data.lqPg->getReadsList()->enableConstantAccess(true);
-        if (data.nPg) data.nPg->getReadsList()->enableConstantAccess(true);
-        *PgHelpers::logout << "... enabled constant access (checkpoint: " << time_millis(start_t) << " msec.)" << endl;
-        const uint8_t PE_PARTS_COUNT = 2;
-
-#pragma omp parallel for
-        for (uint8_t p = 0; p < PE_PARTS_COUNT; p++) {
-            fstream fout(outPrefix + "_out" + "_" + toString(p + 1),
-                         ios_base::out | ios_base::binary | std::ios::trunc);
-            string res, read;
-            read.resize(params->readLength);
-            char *readPtr = (char *) read.data();
-            uint64_t res_size_guard = CHUNK_SIZE_IN_BYTES;
-            uint64_t totalSize = dnaStreamSize();
-            res.reserve(totalSize < res_size_guard ? totalSize : res_size_guard + (params->readLength + 1));
-            uint_reads_cnt_max i = 0;
-            for (i = p; i < params->readsTotalCount; i += PE_PARTS_COUNT) {
-                if (res.size() > res_size_guard) {
-                    PgHelpers::writeArray(fout, (void*) res.data(), res.size());
-                    res.resize(0);
-                }
-                uint_reads_cnt_std idx = data.rlIdxOrder[i];
-                if (idx < params->hqReadsCount)
-                    data.hqPg->getRead(idx, readPtr);
-                else {
-                    if (idx < params->nonNPgReadsCount)
-                        data.lqPg->getRead_RawSequence(idx - params->hqReadsCount, readPtr);
-                    else
-                        data.nPg->getRead_RawSequence(idx - params->nonNPgReadsCount, readPtr);
-                    if (p)
-                        PgHelpers::reverseComplementInPlace(readPtr, params->readLength);
-                }
-                res.append(read);
-                res.push_back('\n');
-            }
-            PgHelpers::writeArray(fout, (void*) res.data(), res.size());
-            fout.close();
+            out.write(resBeg, recordPtr - resBeg);
         }
     }
 
     template<typename uint_pg_len>
-    void PgRCDecoder::writeAllReadsInORDModeParallelChunks(const string &outPrefix, vector<uint_pg_len> &orgIdx2PgPos)  {
+    void PgRCDecoder::writeAllReadsInORDModeParallelChunks(vector<uint_pg_len> &orgIdx2PgPos)  {
         uint8_t parts = params->singleReadsMode ? 1 : 2;
-        int threadsLimit = PARALLEL_DECODING_THREADS_LIMIT + 1;
-        threadsLimit = PgHelpers::numberOfThreads < threadsLimit? PgHelpers::numberOfThreads : threadsLimit;
-        decodingThreadsCount = threadsLimit - 1;
-        if (decodingThreadsCount < 2) {
-            writeAllReadsInORDModeWithWritingThreads<uint_pg_len>(outPrefix, orgIdx2PgPos);
-            return;
+        const bool interleaved = isInterleavedOutput();
+        decodingThreadsCount = getParallelDecodingThreadsCount();
+        if (decodingThreadsCount <= 0) {
+            if (!interleaved && !params->isReadsRangeSelected()) {
+                writeAllReadsInORDMode<uint_pg_len>(orgIdx2PgPos);
+                return;
+            }
+            decodingThreadsCount = 1;
         }
+        uint64_t range_begin, range_end;
+        getReadsRange(range_begin, range_end);
+        const uint64_t range_count = range_end - range_begin;
+        const uint64_t part_reads_count = params->readsTotalCount / parts;
         data.hqPg->getReadsList()->enableConstantAccess(true, true);
-        data.rlIdxOrder.resize(params->readsTotalCount);
+        // HQ reads list indexes are stored only for reads in the selected range (range_count * p + pair index offset)
+        data.rlIdxOrder.resize(range_count * parts);
         uint_reads_cnt_max idx = 0;
-        for (uint_reads_cnt_max i = 0; i < params->readsTotalCount; i++) {
-            uint_pg_len pos = orgIdx2PgPos[i];
-            if (pos < params->hqPgLen)
-                data.rlIdxOrder[i] = idx++;
+        for (uint8_t p = 0; p < parts; p++) {
+            const uint64_t part_begin = part_reads_count * p;
+            for (uint64_t i = part_begin; i < part_begin + part_reads_count; i++) {
+                uint_pg_len pos = orgIdx2PgPos[i];
+                if (pos < params->hqPgLen) {
+                    if (i - part_begin >= range_begin && i - part_begin < range_end)
+                        data.rlIdxOrder[range_count * p + (i - part_begin - range_begin)] = idx;
+                    idx++;
+                }
+            }
         }
         *PgHelpers::logout << "... enabled constant access (checkpoint: " << time_millis(start_t) << " msec.)" << endl;
 
-        const uint64_t reads_per_chunk = CHUNK_SIZE_IN_BYTES / (params->readLength + 1);
-        const uint64_t full_chunks_count = params->readsTotalCount / reads_per_chunk / parts;
-        for (uint8_t p = 0; p < parts; p++) {
-            bool pairFile = p == 1;
-            std::thread writing(&PgRCDecoder::writeFromQueue, this, outPrefix + "_out" + (parts == 1 ? "" : (pairFile ? "_2" : "_1")), pairFile);
-            string res, read;
-            read.resize(params->readLength);
-#pragma omp parallel for ordered schedule(static, 1) firstprivate(read, res) num_threads(decodingThreadsCount)
-            for (int64_t c = 0; c <= full_chunks_count; c++) {
-                res.resize(0);
-                res.reserve(CHUNK_SIZE_IN_BYTES);
-                char *readPtr = (char *) read.data();
-                uint_reads_cnt_std begI = (params->readsTotalCount / parts) * p;
-                uint_reads_cnt_std endI = (params->readsTotalCount / parts) * (p + 1);
-                uint64_t i_guard = c == full_chunks_count ? endI : begI + (c + 1) * reads_per_chunk;
-                for (uint_reads_cnt_max i = begI + c * reads_per_chunk; i < i_guard; i++) {
+        const uint8_t files_count = interleaved ? 1 : parts;
+        // k-th record of a file is the i-th read in the original order (i = part_reads_count * p + pair index)
+        const uint64_t records_count = range_count * parts / files_count;
+        const uint64_t records_per_chunk = getReadsPerChunk(records_count);
+        const int64_t chunks_count = (records_count + records_per_chunk - 1) / records_per_chunk;
+        const size_t recordLength = getMaxRecordLength();
+        const uint_read_len_max readLength = params->readLength;
+        for (uint8_t f = 0; f < files_count; f++) {
+            bool pairFile = f == 1;
+            ChunksRingWriter* writer = createChunksRingWriter(getOutputName(files_count > 1, pairFile),
+                                                              records_per_chunk);
+#pragma omp parallel for schedule(dynamic, 1) num_threads(decodingThreadsCount)
+            for (int64_t c = 0; c < chunks_count; c++) {
+                uint64_t k_guard = c == chunks_count - 1 ? records_count : (c + 1) * records_per_chunk;
+                string &res = writer->acquireChunk(c);
+                res.resize((k_guard - c * records_per_chunk) * recordLength);
+                char *recordPtr = (char *) res.data();
+                for (uint64_t k = c * records_per_chunk; k < k_guard; k++) {
+                    const uint8_t p = interleaved ? k % parts : f;
+                    const uint64_t rangeIdx = interleaved ? k / parts : k;
+                    const uint64_t pairIdx = range_begin + rangeIdx;
+                    const uint_reads_cnt_max i = part_reads_count * p + pairIdx;
+                    char* readPtr = beginRecord(recordPtr, pairIdx + 1);
                     uint_pg_len pos = orgIdx2PgPos[i];
                     if (pos < params->hqPgLen) {
-                        idx = data.rlIdxOrder[i];
-                        data.hqPg->getRead_Unsafe(idx, pos, readPtr);
+                        data.hqPg->getRead_Unsafe(data.rlIdxOrder[range_count * p + rangeIdx], pos, readPtr);
                     } else {
                         if (pos < params->nonNPgLen)
                             data.lqPg->getRawSequenceOfReadLength(readPtr, pos - params->hqPgLen);
                         else
                             data.nPg->getRawSequenceOfReadLength(readPtr, pos - params->nonNPgLen);
                         if (p)
-                            PgHelpers::reverseComplementInPlace(readPtr, params->readLength);
+                            PgHelpers::reverseComplementInPlace(readPtr, readLength);
                     }
-                    res.append(read);
-                    res.push_back('\n');
-                }
-#pragma omp ordered
-                pushOutToQueue(res, pairFile);
-            }
-            pushOutToQueue(res, pairFile);
-            *PgHelpers::logout << "... finished loading queue" <<  (parts == 1 ? "" : (pairFile ? "2 " : "1 ")) << " (checkpoint: " << time_millis(start_t) << " msec.)" << endl;
-            finishWritingParallel(pairFile);
-            writing.join();
-        }
-    }
-
-    template<typename uint_pg_len>
-    void PgRCDecoder::writeAllReadsInORDModeWithWritingThreads(const string &outPrefix, vector<uint_pg_len> &orgIdx2PgPos)  {
-        uint8_t parts = params->singleReadsMode ? 1 : 2;
-
-        if (PgHelpers::numberOfThreads < 2) {
-            writeAllReadsInORDMode<uint_pg_len>(outPrefix, orgIdx2PgPos);
-            return;
-        }
-        decodingThreadsCount = 1;
-
-        for (uint8_t p = 0; p < parts; p++) {
-            bool pairFile = p == 1;
-            std::thread writing(&PgRCDecoder::writeFromQueue, this, outPrefix + "_out" + (parts == 1 ? "" : (pairFile ? "_2" : "_1")), pairFile);
-            string res, read;
-            read.resize(params->readLength);
-            char *readPtr = (char *) read.data();
-            uint64_t res_size_guard = CHUNK_SIZE_IN_BYTES;
-            uint64_t totalSize = dnaStreamSize();
-            res.reserve(totalSize < res_size_guard ? totalSize : res_size_guard + (params->readLength + 1));
-            uint_reads_cnt_std endI = (params->readsTotalCount / parts) * (p + 1);
-            for (uint_reads_cnt_max i = (params->readsTotalCount / parts) * p; i < endI; i++) {
-                if (res.size() > res_size_guard) {
-                    pushOutToQueue(res, pairFile);
-                    res.resize(0);
+                    recordPtr = endRecord(readPtr);
                 }
-                uint_pg_len pos = orgIdx2PgPos[i];
-                if (pos < params->hqPgLen)
-                    data.hqPg->getNextRead_Unsafe(readPtr, pos);
-                else {
-                    if (pos < params->nonNPgLen)
-                        data.lqPg->getRawSequenceOfReadLength(readPtr, pos - params->hqPgLen);
-                    else
-                        data.nPg->getRawSequenceOfReadLength(readPtr, pos - params->nonNPgLen);
-                    if (p)
-                        PgHelpers::reverseComplementInPlace(readPtr, params->readLength);
-                }
-                res.append(read);
-                res.push_back('\n');
+                res.resize(recordPtr - res.data());
+                writer->publishChunk(c);
             }
-            pushOutToQueue(res, pairFile);
-            *PgHelpers::logout << "... finished loading queue" <<  (parts == 1 ? "" : (pairFile ? "2 " : "1 ")) << " (checkpoint: " << time_millis(start_t) << " msec.)" << endl;
-            finishWritingParallel(pairFile);
-            writing.join();
+            *PgHelpers::logout << "... finished loading queue" <<  (files_count == 1 ? "" : (pairFile ? "2 " : "1 ")) << " (checkpoint: " << time_millis(start_t) << " msec.)" << endl;
+            writer->finish(chunks_count);
+            delete (writer);
         }
     }
 
     template<typename uint_pg_len>
-    void PgRCDecoder::writeAllReadsInORDMode(const string &outPrefix, vector<uint_pg_len> &orgIdx2PgPos) const {
+    void PgRCDecoder::writeAllReadsInORDMode(vector<uint_pg_len> &orgIdx2PgPos) const {
         uint8_t parts = params->singleReadsMode ? 1 : 2;
 
         for (uint8_t p = 0; p < parts; p++) {
-            fstream fout(outPrefix + "_out" + (params->singleReadsMode ? "" : ("_" + toString(p + 1))),
-                         ios_base::out | ios_base::binary | std::ios::trunc);
-            string res, read;
-            read.resize(params->readLength);
-            char *readPtr = (char *) read.data();
-            uint64_t res_size_guard = CHUNK_SIZE_IN_BYTES;
-            uint64_t totalSize = dnaStreamSize();
-            res.reserve(totalSize < res_size_guard ? totalSize : res_size_guard + (params->readLength + 1));
-            uint_reads_cnt_std endI = (params->readsTotalCount / parts) * (p + 1);
-            for (uint_reads_cnt_max i = (params->readsTotalCount / parts) * p; i < endI; i++) {
-                if (res.size() > res_size_guard) {
-                    fout << res;
-                    res.resize(0);
+            ReadsOutput out(getOutputName(parts > 1, p == 1));
+            string res;
+            res.resize(CHUNK_SIZE_IN_BYTES + getMaxRecordLength());
+            char* const resBeg = (char*) res.data();
+            char* const resGuard = resBeg + CHUNK_SIZE_IN_BYTES;
+            char* recordPtr = resBeg;
+            const uint_reads_cnt_std begI = (params->readsTotalCount / parts) * p;
+            const uint_reads_cnt_std endI = (params->readsTotalCount / parts) * (p + 1);
+            for (uint_reads_cnt_max i = begI; i < endI; i++) {
+                if (recordPtr > resGuard) {
+                    out.write(resBeg, recordPtr - resBeg);
+                    recordPtr = resBeg;
                 }
+                char* readPtr = beginRecord(recordPtr, i - begI + 1);
                 uint_pg_len pos = orgIdx2PgPos[i];
                 if (pos < params->hqPgLen)
                     data.hqPg->getNextRead_Unsafe(readPtr, pos);
@@ -518,31 +639,19 @@ namespace PgTools {
                     if (p)
                         PgHelpers::reverseComplementInPlace(readPtr, params->readLength);
                 }
-                res.append(read);
-                res.push_back('\n');
+                recordPtr = endRecord(readPtr);
             }
-            fout << res;
-            fout.close();
+            out.write(resBeg, recordPtr - resBeg);
         }
     }
 
-    template void PgRCDecoder::writeAllReadsInORDModeParallelChunks<uint_pg_len_std>(const string &outPrefix,
-                                                                                         vector<uint_pg_len_std> &orgIdx2PgPos);
-
-    template void PgRCDecoder::writeAllReadsInORDModeParallelChunks<uint_pg_len_max>(const string &outPrefix,
-                                                                                         vector<uint_pg_len_max> &orgIdx2PgPos);
+    template void PgRCDecoder::writeAllReadsInORDModeParallelChunks<uint_pg_len_std>(vector<uint_pg_len_std> &orgIdx2PgPos);
 
-    template void PgRCDecoder::writeAllReadsInORDModeWithWritingThreads<uint_pg_len_std>(const string &outPrefix,
-                                                                       vector<uint_pg_len_std> &orgIdx2PgPos);
+    template void PgRCDecoder::writeAllReadsInORDModeParallelChunks<uint_pg_len_max>(vector<uint_pg_len_max> &orgIdx2PgPos);
 
-    template void PgRCDecoder::writeAllReadsInORDModeWithWritingThreads<uint_pg_len_max>(const string &outPrefix,
-                                                                       vector<uint_pg_len_max> &orgIdx2PgPos);
+    template void PgRCDecoder::writeAllReadsInORDMode<uint_pg_len_std>(vector<uint_pg_len_std> &orgIdx2PgPos) const;
 
-    template void PgRCDecoder::writeAllReadsInORDMode<uint_pg_len_std>(const string &outPrefix,
-                                                                       vector<uint_pg_len_std> &orgIdx2PgPos) const;
-
-    template void PgRCDecoder::writeAllReadsInORDMode<uint_pg_len_max>(const string &outPrefix,
-                                                                       vector<uint_pg_len_max> &orgIdx2PgPos) const;
+    template void PgRCDecoder::writeAllReadsInORDMode<uint_pg_len_max>(vector<uint_pg_len_max> &orgIdx2PgPos) const;
 
     uint_reads_cnt_max PgRCDecoder::dnaStreamSize() const {
         return (data.hqPg->getReadsSetProperties()->readsCount + data.lqPg->getReadsSetProperties()->readsCount
@@ -733,7 +842,7 @@ namespace PgTools {
             char basesOrder[5];
             PgHelpers::readArray(pgrcIn, basesOrder, sizeof(basesOrder));
             PgHelpers::reorderSymAndVal(basesOrder);
-            prefetchCompressedCollectiveParallel(pgrcIn);
+            prefetchArchiveStreams(pgrcIn);
             readCompressed(pgrcIn, propsString);
             propsIn = new istringstream(propsString);
         }
@@ -801,6 +910,8 @@ namespace PgTools {
 
         params->hqPgLen = hqPgh.getPseudoGenomeLength();
         params->nonNPgLen = params->hqPgLen + lqPgh.getPseudoGenomeLength();
+        bool lqPgRequired = true;
+        bool nPgRequired = true;
         if (params->preserveOrderMode) {
             params->isJoinedPgLengthStd = params->nonNPgLen + nPgh.getPseudoGenomeLength() <= UINT32_MAX;
             if (params->isJoinedPgLengthStd)
@@ -811,6 +922,12 @@ namespace PgTools {
                 SeparatedPseudoGenomePersistence::decompressReadsPgPositions<uint_pg_len_max>(pgrcIn,
                                                                                               data.orgIdx2PgPos,
                                                                                               params);
+            if (params->isReadsRangeSelected() && params->srcFastqFile.empty()) {
+                if (params->isJoinedPgLengthStd)
+                    findPgsOfReadsRange<uint_pg_len_std>(data.orgIdx2StdPgPos, lqPgRequired, nPgRequired);
+                else
+                    findPgsOfReadsRange<uint_pg_len_max>(data.orgIdx2PgPos, lqPgRequired, nPgRequired);
+            }
         } else {
             SeparatedPseudoGenomePersistence::decompressReadsOrder(pgrcIn, data.rlIdxOrder,
                                                                    params->preserveOrderMode,
@@ -819,13 +936,223 @@ namespace PgTools {
         }
         cout << "... loaded Pgs Reads Lists (checkpoint: " << time_millis(start_t) << " msec.)" << endl;
         string hqPgSeq, lqPgSeq, nPgSeq;
-        SimplePgMatcher::restoreMatchedPgs(pgrcIn, params->hqPgLen, hqPgSeq, lqPgSeq, nPgSeq,
-                                           params);
+        SimplePgMatcher::MatchedPgsStreams matchedPgs;
+        SimplePgMatcher::readMatchedPgs(pgrcIn, matchedPgs, params, lqPgRequired, nPgRequired);
+        delete(lazyStreamsMapping);
+        lazyStreamsMapping = nullptr;
+        lazyStreams = IndexedArchive();
+        SimplePgMatcher::restoreMatchedHqPg(matchedPgs, params->hqPgLen, hqPgSeq);
         data.hqPg = new SeparatedPseudoGenome(move(hqPgSeq), hqCaeRl, &hqRsProp);
+        if (isSEModeStreamingApplicable()) {
+            decodingThreadsCount = getParallelDecodingThreadsCount();
+            hqReadsStreaming = std::thread(&PgRCDecoder::streamHqReadsInSEMode, this);
+        }
+        // pseudogenomes without reads in the selected range are not restored
+        SimplePgMatcher::restoreMatchedLqAndNPgs(matchedPgs, data.hqPg->getPgSequence(), params->hqPgLen,
+                                                 lqPgSeq, nPgSeq, lqPgRequired, nPgRequired);
         data.lqPg = new SeparatedPseudoGenome(move(lqPgSeq), lqCaeRl, &lqRsProp);
         data.nPg = new SeparatedPseudoGenome(move(nPgSeq), nCaeRl, &nRsProp);
     }
 
+    void PgRCDecoder::readRandomAccessPgProps(istream &pgrcIn, PseudoGenomeHeader &pgh, ReadsSetProperties &rsProp) {
+        string propsString;
+        readCompressed(pgrcIn, propsString);
+        istringstream propsIn(propsString);
+        pgh = PseudoGenomeHeader(propsIn);
+        rsProp = ReadsSetProperties(propsIn);
+        if (confirmTextReadMode(propsIn)) {
+            cout << "Reads list text mode unsupported during decompression." << endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    void PgRCDecoder::decompressRandomAccessBlocks(istream &pgrcIn) {
+        if (!params->srcFastqFile.empty()) {
+            fprintf(stderr, "Validation of random access archives is unsupported.\n");
+            exit(EXIT_FAILURE);
+        }
+        char basesOrder[5];
+        PgHelpers::readArray(pgrcIn, basesOrder, sizeof(basesOrder));
+        PgHelpers::reorderSymAndVal(basesOrder);
+        prefetchArchiveStreams(pgrcIn);
+        PseudoGenomeHeader hqPgh, lqPgh, nPgh;
+        ReadsSetProperties hqRsProp, lqRsProp, nRsProp;
+        readRandomAccessPgProps(pgrcIn, hqPgh, hqRsProp);
+        readRandomAccessPgProps(pgrcIn, lqPgh, lqRsProp);
+        if (params->separateNReads)
+            readRandomAccessPgProps(pgrcIn, nPgh, nRsProp);
+        params->readLength = hqRsProp.maxReadLength;
+        params->hqReadsCount = hqRsProp.readsCount;
+        params->lqReadsCount = lqRsProp.readsCount;
+        params->nonNPgReadsCount = params->hqReadsCount + params->lqReadsCount;
+        params->nPgReadsCount = params->separateNReads ? nRsProp.readsCount : 0;
+        params->readsTotalCount = params->nonNPgReadsCount + params->nPgReadsCount;
+        params->hqPgLen = hqPgh.getPseudoGenomeLength();
+        params->nonNPgLen = params->hqPgLen + lqPgh.getPseudoGenomeLength();
+        const uint_pg_len_max joinedPgLength = params->nonNPgLen + nPgh.getPseudoGenomeLength();
+        params->isJoinedPgLengthStd = joinedPgLength <= UINT32_MAX;
+
+        string blocksProps;
+        readCompressed(pgrcIn, blocksProps);
+        istringstream blocksPropsIn(blocksProps);
+        uint32_t readsPerBlock = 0;
+        PgHelpers::readValue<uint32_t>(blocksPropsIn, readsPerBlock, false);
+        if (!blocksPropsIn || readsPerBlock == 0) {
+            fprintf(stderr, "Error reading reads blocks properties.\n");
+            exit(EXIT_FAILURE);
+        }
+        const uint8_t parts = params->singleReadsMode ? 1 : 2;
+        const uint64_t partReadsCount = params->readsTotalCount / parts;
+        const uint64_t readsBlocksCount = (partReadsCount + readsPerBlock - 1) / readsPerBlock;
+        const uint32_t firstReadsStreamId = skipPrefetchedStreams(2 * readsBlocksCount);
+        SimplePgMatcher::PgsBlocks pgsBlocks;
+        SimplePgMatcher::readPgsBlocksProps(pgrcIn, joinedPgLength, pgsBlocks);
+
+        uint64_t rangeBegin, rangeEnd;
+        getReadsRange(rangeBegin, rangeEnd);
+        const uint64_t firstBlock = rangeBegin / readsPerBlock;
+        const uint64_t blocksCount = (rangeEnd + readsPerBlock - 1) / readsPerBlock - firstBlock;
+        vector<vector<uint_pg_len_max>> blocksPgPos(blocksCount);
+        vector<vector<uint32_t>> blocksHqRlIdx(blocksCount);
+        vector<unique_ptr<ExtendedReadsListWithConstantAccessOption>> blocksHqRl(blocksCount);
+        vector<ostringstream> logOuts(blocksCount);
+        #pragma omp parallel for schedule(dynamic) num_threads(numberOfThreads)
+        for (uint64_t c = 0; c < blocksCount; c++) {
+            const uint64_t b = firstBlock + c;
+            const uint64_t blockPartReadsCount = std::min<uint64_t>(readsPerBlock, partReadsCount - b * readsPerBlock);
+            string pgPosBlock, hqRlBlock;
+            lazyStreams.readStream(firstReadsStreamId + 2 * b, pgPosBlock, &logOuts[c]);
+            lazyStreams.readStream(firstReadsStreamId + 2 * b + 1, hqRlBlock, &logOuts[c]);
+            blocksHqRl[c].reset(new ExtendedReadsListWithConstantAccessOption(params->readLength));
+            if (params->isJoinedPgLengthStd)
+                SeparatedPseudoGenomePersistence::decompressReadsPgPositionsBlock<uint_pg_len_std>(pgPosBlock,
+                        hqRlBlock, blockPartReadsCount, parts, params->hqPgLen, params->revComplPairFile,
+                        blocksPgPos[c], blocksHqRlIdx[c], *blocksHqRl[c]);
+            else
+                SeparatedPseudoGenomePersistence::decompressReadsPgPositionsBlock<uint_pg_len_max>(pgPosBlock,
+                        hqRlBlock, blockPartReadsCount, parts, params->hqPgLen, params->revComplPairFile,
+                        blocksPgPos[c], blocksHqRlIdx[c], *blocksHqRl[c]);
+        }
+        for (uint64_t c = 0; c < blocksCount; c++)
+            *PgHelpers::devout << "\t" << logOuts[c].str();
+        *PgHelpers::logout << "... decoded " << blocksCount << " of " << readsBlocksCount << " reads blocks (checkpoint: "
+                           << time_millis(start_t) << " msec.)" << endl;
+
+        const uint_read_len_max readLength = params->readLength;
+        auto getPgPos = [&](uint8_t p, uint64_t pairIdx, uint64_t &c, uint64_t &k) -> uint_pg_len_max {
+            c = pairIdx / readsPerBlock - firstBlock;
+            k = (blocksPgPos[c].size() / parts) * p + pairIdx % readsPerBlock;
+            return blocksPgPos[c][k];
+        };
+        vector<bool> isPgBlockRequired(pgsBlocks.blocksCount, false);
+        for (uint8_t p = 0; p < parts; p++) {
+            for (uint64_t i = rangeBegin; i < rangeEnd; i++) {
+                uint64_t c, k;
+                const uint_pg_len_max pos = getPgPos(p, i, c, k);
+                if (pos + readLength > joinedPgLength) {
+                    fprintf(stderr, "Invalid position of a read (corrupted archive).\n");
+                    exit(EXIT_FAILURE);
+                }
+                for (uint64_t b = pos / pgsBlocks.blockLength; b <= (pos + readLength - 1) / pgsBlocks.blockLength; b++)
+                    isPgBlockRequired[b] = true;
+            }
+        }
+        // required blocks are concatenated (bases of a read are contiguous as all blocks covering it are required)
+        vector<uint64_t> pgBlocks;
+        vector<uint64_t> pgBlockOffset(pgsBlocks.blocksCount, 0);
+        for (uint64_t b = 0; b < pgsBlocks.blocksCount; b++) {
+            if (!isPgBlockRequired[b])
+                continue;
+            pgBlockOffset[b] = pgBlocks.size() * (uint64_t) pgsBlocks.blockLength;
+            pgBlocks.push_back(b);
+        }
+        string pgBlocksSeq;
+        SimplePgMatcher::readPgsBlocks(lazyStreams, pgsBlocks, pgBlocks, pgBlocksSeq);
+        delete(lazyStreamsMapping);
+        lazyStreamsMapping = nullptr;
+        lazyStreams = IndexedArchive();
+        *PgHelpers::logout << "... decoded " << pgBlocks.size() << " of " << pgsBlocks.blocksCount
+                           << " pseudogenome blocks (checkpoint: " << time_millis(start_t) << " msec.)" << endl;
+
+        const bool interleaved = isInterleavedOutput();
+        decodingThreadsCount = getParallelDecodingThreadsCount();
+        if (decodingThreadsCount <= 0)
+            decodingThreadsCount = 1;
+        const uint8_t files_count = interleaved ? 1 : parts;
+        const uint64_t records_count = (rangeEnd - rangeBegin) * parts / files_count;
+        const uint64_t records_per_chunk = getReadsPerChunk(records_count);
+        const int64_t chunks_count = (records_count + records_per_chunk - 1) / records_per_chunk;
+        const size_t recordLength = getMaxRecordLength();
+        for (uint8_t f = 0; f < files_count; f++) {
+            bool pairFile = f == 1;
+            ChunksRingWriter* writer = createChunksRingWriter(getOutputName(files_count > 1, pairFile),
+                                                              records_per_chunk);
+#pragma omp parallel for schedule(dynamic, 1) num_threads(decodingThreadsCount)
+            for (int64_t ch = 0; ch < chunks_count; ch++) {
+                uint64_t k_guard = ch == chunks_count - 1 ? records_count : (ch + 1) * records_per_chunk;
+                string &res = writer->acquireChunk(ch);
+                res.resize((k_guard - ch * records_per_chunk) * recordLength);
+                char *recordPtr = (char *) res.data();
+                for (uint64_t r = ch * records_per_chunk; r < k_guard; r++) {
+                    const uint8_t p = interleaved ? r % parts : f;
+                    const uint64_t pairIdx = rangeBegin + (interleaved ? r / parts : r);
+                    char* readPtr = beginRecord(recordPtr, pairIdx + 1);
+                    uint64_t c, k;
+                    const uint_pg_len_max pos = getPgPos(p, pairIdx, c, k);
+                    const uint64_t pgBlock = pos / pgsBlocks.blockLength;
+                    memcpy(readPtr, pgBlocksSeq.data() + pgBlockOffset[pgBlock] + (pos - pgBlock * pgsBlocks.blockLength),
+                           readLength);
+                    if (pos < params->hqPgLen) {
+                        ExtendedReadsListWithConstantAccessOption &hqRl = *blocksHqRl[c];
+                        const uint32_t idx = blocksHqRlIdx[c][k];
+                        if (hqRl.revComp[idx])
+                            PgHelpers::reverseComplementInPlace(readPtr, readLength);
+                        for (uint8_t i = 0; i < hqRl.getMisCount(idx); i++) {
+                            const uint8_t misPos = hqRl.getMisOff(idx, i);
+                            readPtr[misPos] = PgHelpers::code2mismatch(readPtr[misPos], hqRl.getMisSymCode(idx, i));
+                        }
+                    } else if (p)
+                        PgHelpers::reverseComplementInPlace(readPtr, readLength);
+                    recordPtr = endRecord(readPtr);
+                }
+                res.resize(recordPtr - res.data());
+                writer->publishChunk(ch);
+            }
+            writer->finish(chunks_count);
+            delete (writer);
+        }
+    }
+
+    void PgRCDecoder::prefetchArchiveStreams(istream &pgrcIn) {
+        const bool indexedArchive = params->isVersionAtLeast(3, 0);
+        const uint64_t streamsOffset = pgrcIn.tellg();
+        PgHelpers::MemoryMappedFile* archive = PgHelpers::MemoryMappedFile::open(params->pgRCFileName, false);
+        if (!archive && !indexedArchive) {
+            prefetchCompressedCollectiveParallel(pgrcIn);
+            return;
+        }
+        IndexedArchive archiveStreams;
+        archiveStreams.archive = archive ? archive->begin() : nullptr;
+        archiveStreams.verifyChecksums = indexedArchive;
+        vector<StreamIndexEntry> &index = archiveStreams.index;
+        bool validIndex = archive && (indexedArchive ?
+                readStreamsIndex(archive->begin(), archive->length(), index) &&
+                (index.empty() || index[0].offset == streamsOffset) :
+                scanStreamsIndex(archive->begin(), streamsOffset, archive->length(), index));
+        if (!validIndex) {
+            fprintf(stderr, "Error reading streams index of archive %s.\n", params->pgRCFileName.c_str());
+            exit(EXIT_FAILURE);
+        }
+        if ((params->isReadsRangeSelected() || params->randomAccessMode) && params->srcFastqFile.empty()) {
+            lazyStreamsMapping = archive;
+            lazyStreams = std::move(archiveStreams);
+            prefetchCompressedCollectiveParallel(lazyStreams, true);
+        } else {
+            prefetchCompressedCollectiveParallel(archiveStreams);
+            delete(archive);
+        }
+    }
+
     void PgRCDecoder::loadAllPgs() {
         string hqPgSeq = SimplePgMatcher::restoreAutoMatchedPg(params->pgSeqFinalHqPrefix, true);
         PseudoGenomeHeader *pgh = nullptr;
@@ -4,13 +4,62 @@
 #include "pgrc-params.h"
 #include "pgrc-data.h"
 
+#include <atomic>
 #include <condition_variable>
-#include <queue>
+#include <memory>
 #include <mutex>
 #include <thread>
 
 namespace PgTools {
 
+    // destination of decompressed reads: a file, stdout ("-") or an opened file descriptor ("fd:N")
+    class ReadsOutput {
+    private:
+        int fd;
+        bool ownDescriptor = false;
+
+    public:
+        ReadsOutput(const string &outputName);
+        ~ReadsOutput();
+
+        void write(const char* data, size_t length);
+
+        static bool isStream(const string &outputName);
+        static bool isStdout(const string &outputName);
+    };
+
+    // writes chunks produced concurrently in the order of their indexes
+    // (chunks are passed to the writing thread through a ring of preallocated buffers;
+    // threads waiting for a buffer or a chunk are blocked on condition variables)
+    class ChunksRingWriter {
+    private:
+        struct alignas(64) Slot {
+            std::atomic<int64_t> readyChunk;
+            string buffer;
+        };
+
+        const int slotsCount;
+        std::unique_ptr<Slot[]> slots;
+        alignas(64) std::atomic<int64_t> writtenChunks;
+        alignas(64) std::atomic<int64_t> chunksCount;
+        std::mutex waitingMutex;
+        std::condition_variable slotReleased, chunkPublished;
+        ReadsOutput out;
+        std::thread writing;
+
+        void writeChunks();
+
+    public:
+        ChunksRingWriter(const string &outputName, int slotsCount, size_t chunkCapacity);
+        ~ChunksRingWriter();
+
+        // waits until a buffer for the chunk is available (returned empty)
+        string& acquireChunk(int64_t chunk);
+        void publishChunk(int64_t chunk);
+        // all chunks with lower indexes have to be published
+        void finish(int64_t chunksCount);
+    };
+
     class PgRCDecoder {
     private:
 
@@ -23,34 +72,65 @@ namespace PgTools {
         template<typename uint_pg_len>
         void applyRevComplPairFileToPgs(vector<uint_pg_len> &orgIdx2PgPos);
 
+        // archive is memory mapped and streams are decompressed directly from the mapping
+        // (using the index of streams since version 3.0)
+        // (in filtered decompression streams are decompressed lazily, so unused streams are skipped)
+        void prefetchArchiveStreams(istream &pgrcIn);
+        // lazily fetched streams (the archive stays mapped until the pseudogenomes are read)
+        PgHelpers::MemoryMappedFile* lazyStreamsMapping = nullptr;
+        IndexedArchive lazyStreams;
         void loadAllPgs(istream &pgrcIn);
         void loadAllPgs();
-
-        void writeAllReadsInSEModeSequential(const string &outPrefix) const;
-        void writeAllReadsInPEModeEachFileSequential(const string &outPrefix) const;
+        // random access archives: only blocks of reads (with their positions and HQ reads list entries)
+        // and blocks of the joined pseudogenome covering the range of reads are decoded
+        void decompressRandomAccessBlocks(istream &pgrcIn);
+        void readRandomAccessPgProps(istream &pgrcIn, PseudoGenomeHeader &pgh, ReadsSetProperties &rsProp);
+
+        string getOutputName(bool pairedFiles = false, bool pairFile = false) const;
+        // clamped range of original indexes of reads in each part (pair indexes in PE mode)
+        void getReadsRange(uint64_t &begin, uint64_t &end) const;
+        template<typename uint_pg_len>
+        void findPgsOfReadsRange(const vector<uint_pg_len> &orgIdx2PgPos, bool &lqPgRequired, bool &nPgRequired) const;
+        bool isInterleavedOutput() const;
+
+        static const int MAX_RECORD_ID_DIGITS = 20;
+        size_t getMaxRecordLength() const;
+        // returns the destination of the read sequence
+        char* beginRecord(char* dest, uint64_t recordId) const;
+        // returns the end of the record
+        char* endRecord(char* readDest) const;
+
+        void writeAllReadsInSEModeSequential() const;
+        void writeAllReadsInPEModeEachFileSequential() const;
         template<typename uint_pg_len>
-        void writeAllReadsInORDMode(const string &outPrefix, vector<uint_pg_len> &orgIdx2PgPos) const;
+        void writeAllReadsInORDMode(vector<uint_pg_len> &orgIdx2PgPos) const;
 
-        static const int PARALLEL_DECODING_THREADS_LIMIT = 4;
         const size_t CHUNK_SIZE_IN_BYTES = 1 << 17;
+        const size_t MIN_CHUNK_SIZE_IN_BYTES = 1 << 17;
+        const size_t MAX_CHUNK_SIZE_IN_BYTES = 1 << 21;
+        const int CHUNKS_PER_DECODING_THREAD = 16;
+        const int RING_SLOTS_PER_DECODING_THREAD = 2;
 
         int decodingThreadsCount;
-        const int QUEUE_LIMIT_PER_DECODING_THREAD = 2;
-        std::mutex mut[2];
-        std::queue<string> out_queue[2];
-        std::condition_variable data_cond[2];
-
-        void writeAllReadsInSEModeParallelWritingThreads(const string &outPrefix);
-        void writeAllReadsInPEModeParallelChunks(const string &outPrefix);
-        void writeAllReadsInPEModeEachFileSequentialWithWritingThreads(const string &outPrefix);
+        int getParallelDecodingThreadsCount() const;
+        uint64_t getReadsPerChunk(uint64_t readsCount) const;
+        ChunksRingWriter* createChunksRingWriter(const string &outputName, uint64_t readsPerChunk) const;
+
+        void writeAllReadsInSEModeParallelWritingThreads();
+        void pushReadsChunksInSEMode(SeparatedPseudoGenome *pg, uint_reads_cnt_max readsCount, bool hqReads);
+
+        // SE mode streaming: HQ reads are emitted while LQ and N pseudogenomes are being restored
+        ChunksRingWriter* seModeWriter = nullptr;
+        int64_t seModeChunksCount = 0;
+        uint64_t seModeReadsCount = 0;
+        std::thread hqReadsStreaming;
+        bool isSEModeStreamingApplicable() const;
+        void streamHqReadsInSEMode();
+        void finishStreamingReadsInSEMode();
+
+        void writeAllReadsInPEModeParallelChunks();
         template<typename uint_pg_len>
-        void writeAllReadsInORDModeWithWritingThreads(const string &outPrefix, vector<uint_pg_len> &orgIdx2PgPos);
-        template<typename uint_pg_len>
-        void writeAllReadsInORDModeParallelChunks(const string &outPrefix, vector<uint_pg_len> &orgIdx2PgPos);
-
-        void pushOutToQueue(string &out, bool pairFile = false);
-        void finishWritingParallel(bool pairFile = false);
-        void writeFromQueue(const string outFileName, bool pairFile = false);
+        void writeAllReadsInORDModeParallelChunks(vector<uint_pg_len> &orgIdx2PgPos);
 
         void validateAllPgs();
         void validatePgsOrder();
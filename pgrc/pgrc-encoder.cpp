@@ -13,6 +13,7 @@
 namespace PgTools {
 
     uint_read_len_max probeReadsLength(const string &srcFastqFile);
+    uint64_t getFilesSizeInBytes(const string &srcFile, const string &pairFile);
 
     time_t getTimeInSec(chrono::steady_clock::time_point end_t, chrono::steady_clock::time_point begin_t) {
         chrono::nanoseconds time_span = chrono::duration_cast<chrono::nanoseconds>(end_t - begin_t);
@@ -28,9 +29,16 @@ namespace PgTools {
         params->initCompressionParameters();
         params->qualityDivision = params->error_limit_in_promils < 1000;
         params->generatorDivision = params->gen_quality_coef > 0;
-        params->readLength = probeReadsLength(params->srcFastqFile);
+        // reads length is determined during the first pass over input (unless the division stage is skipped)
+        params->readLength = params->skipStages > 0 ? probeReadsLength(params->srcFastqFile) : 0;
         if (params->pairFastqFile.empty() && !params->preserveOrderMode)
             params->singleReadsMode = true;
+        if (params->randomAccessMode && (!params->preserveOrderMode || params->skipStages > 0 ||
+                params->endAtStage < STAGES_COUNT || params->disableInMemoryMode)) {
+            fprintf(stderr, "Random access mode requires preserving the order of reads and a complete in-memory "
+                            "compression chain.\n");
+            exit(EXIT_FAILURE);
+        }
 
         if (std::ifstream(params->pgRCFileName))
             fprintf(stderr, "Warning: file %s already exists\n", params->pgRCFileName.data());
@@ -52,6 +60,8 @@ namespace PgTools {
                 params->revComplPairFile = true;
             pgrcOut.put(params->revComplPairFile);
         }
+        if (params->preserveOrderMode)
+            pgrcOut.put(params->randomAccessMode);
 
         string tmpDirectoryName = params->pgRCFileName;
         if (params->qualityDivision)
@@ -91,6 +101,8 @@ namespace PgTools {
         }
         pgrcOut.write(tmpDirectoryName.data(), tmpDirectoryName.length());
         pgrcOut << endl;
+        // streams follow the order of 5 mismatched symbols (written with the HQ reads list)
+        streamsOffset = (uint64_t) pgrcOut.tellp() + 5;
 
         params->lqDivisionFile = tmpDirectoryName + "/" + BAD_INFIX + DIVISION_EXTENSION;
         params->nDivisionFile = tmpDirectoryName + "/" + N_INFIX + DIVISION_EXTENSION;
@@ -108,6 +120,7 @@ namespace PgTools {
     void PgRCEncoder::executePgRCChain() {
         start_t = chrono::steady_clock::now();
         prepareChainData();
+        resetPeakResidentMemory();
         uint8_t stageCount = 0;
         if (params->skipStages < ++stageCount && params->qualityDivision) {
             runQualityBasedDivision();
@@ -115,6 +128,7 @@ namespace PgTools {
                 persistReadsQualityDivision();
                 data.disposeChainData();
             }
+            completeStage(stageCount);
         }
         div_t = chrono::steady_clock::now();
         if (params->skipStages < ++stageCount && params->endAtStage >= stageCount) {
@@ -125,7 +139,7 @@ namespace PgTools {
                 persistReadsQualityDivision();
                 data.disposeChainData();
             }
-
+            completeStage(stageCount);
         }
         pgDiv_t = chrono::steady_clock::now();
         if (params->skipStages < ++stageCount && params->endAtStage >= stageCount) {
@@ -136,6 +150,7 @@ namespace PgTools {
                 persistReadsQualityDivision();
                 data.disposeChainData();
             }
+            completeStage(stageCount);
         }
         good_t = chrono::steady_clock::now();
         if (params->skipStages < ++stageCount && params->endAtStage >= stageCount) {
@@ -154,11 +169,18 @@ namespace PgTools {
                     else
                         data.rlIdxOrder = std::move(data.hqPg->getReadsList()->orgIdx);
                 }
-                data.hqPg->disposeReadsList();
+                // in random access mode HQ reads list is coded with reads positions
+                if (!params->randomAccessMode)
+                    data.hqPg->disposeReadsList();
             }
+            completeStage(stageCount);
         }
         match_t = chrono::steady_clock::now();
         if (params->skipStages < ++stageCount && params->endAtStage >= stageCount) {
+            if (!params->disableInMemoryMode && params->endAtStage >= STAGES_COUNT && isMemoryBudgetApproached()) {
+                spillOrderInfo();
+                spillPgSequences();
+            }
             prepareForLQPgAndNPgGeneration();
             runLQPgGeneration();
             if (params->disableInMemoryMode || params->endAtStage == stageCount) {
@@ -169,6 +191,7 @@ namespace PgTools {
                 compressLQPgReadsList();
             }
             if (!params->singleReadsMode) {
+                restoreOrderInfo();
                 if (params->preserveOrderMode) {
                     ExtendedReadsListWithConstantAccessOption *const pgRl = data.lqPg->getReadsList();
                     uint_pg_len_max pos = data.hqPg->getPseudoGenomeLength();
@@ -204,26 +227,40 @@ namespace PgTools {
             }
             delete(data.divReadsSets);
             data.divReadsSets = nullptr;
+            completeStage(stageCount);
         }
         bad_t = chrono::steady_clock::now();
         if (!params->singleReadsMode && params->skipStages < ++stageCount && params->endAtStage >= stageCount) {
+            if (params->endAtStage >= STAGES_COUNT && isMemoryBudgetApproached())
+                spillPgSequences();
             if (params->preserveOrderMode) {
                 const uint_pg_len_max joinedPgLength =
                         data.hqPg->getPseudoGenomeLength() + data.lqPg->getPseudoGenomeLength() +
                         data.nPg->getPseudoGenomeLength();
                 bool isJoinedPgLengthStd = joinedPgLength <= UINT32_MAX;
-                if (isJoinedPgLengthStd)
+                if (params->randomAccessMode) {
+                    if (isJoinedPgLengthStd)
+                        SeparatedPseudoGenomePersistence::compressReadsPgPositionsInBlocks<uint_pg_len_std>(pgrcOut,
+                                data.orgIdx2PgPos, data.hqPg->getReadsList(), data.hqPg->getPseudoGenomeLength(),
+                                joinedPgLength, RANDOM_ACCESS_READS_BLOCK_LENGTH, params->compressionLevel,
+                                params->pairFastqFile.empty());
+                    else
+                        SeparatedPseudoGenomePersistence::compressReadsPgPositionsInBlocks<uint_pg_len_max>(pgrcOut,
+                                data.orgIdx2PgPos, data.hqPg->getReadsList(), data.hqPg->getPseudoGenomeLength(),
+                                joinedPgLength, RANDOM_ACCESS_READS_BLOCK_LENGTH, params->compressionLevel,
+                                params->pairFastqFile.empty());
+                    data.hqPg->disposeReadsList();
+                } else if (isJoinedPgLengthStd)
                     SeparatedPseudoGenomePersistence::compressReadsPgPositions<uint_pg_len_std>(pgrcOut,
                             data.orgIdx2PgPos, joinedPgLength, params->compressionLevel, params->pairFastqFile.empty());
                 else
                     SeparatedPseudoGenomePersistence::compressReadsPgPositions<uint_pg_len_max>(pgrcOut,
                             data.orgIdx2PgPos, joinedPgLength, params->compressionLevel, params->pairFastqFile.empty());
-                data.orgIdx2PgPos.clear();
             } else {
                 SeparatedPseudoGenomePersistence::compressReadsOrder(pgrcOut, data.rlIdxOrder,
                         params->compressionLevel, params->preserveOrderMode, params->ignorePairOrderInformation,
                         params->pairFastqFile.empty());
-                data.rlIdxOrder.clear();
+                vector<uint_reads_cnt_std>().swap(data.rlIdxOrder);
             }
             if (params->extraFilesForValidation) {
                 if (params->separateNReads)
@@ -232,17 +269,27 @@ namespace PgTools {
                 else
                     SeparatedPseudoGenomePersistence::dumpPgPairs({params->pgMappedHqPrefix, params->pgMappedLqPrefix});
             }
+            completeStage(stageCount);
         }
         order_t = chrono::steady_clock::now();
         if (params->skipStages < ++stageCount && params->endAtStage >= stageCount) {
+            restorePgSequences();
             prepareForPgMatching();
             string emptySequence;
-            SimplePgMatcher::matchPgsInPg(data.hqPg->getPgSequence(), data.lqPg->getPgSequence(),
+            if (params->randomAccessMode)
+                SimplePgMatcher::writePgsInBlocks(data.hqPg->getPgSequence(), data.lqPg->getPgSequence(),
+                        params->separateNReads?data.nPg->getPgSequence():emptySequence, pgrcOut,
+                        params->compressionLevel, RANDOM_ACCESS_PG_BLOCK_LENGTH);
+            else
+                SimplePgMatcher::matchPgsInPg(data.hqPg->getPgSequence(), data.lqPg->getPgSequence(),
                     params->separateNReads?data.nPg->getPgSequence():emptySequence, params->separateNReads,
-                    pgrcOut, params->compressionLevel, params->extraFilesForValidation?params->pgSeqFinalHqPrefix:"",
+                    pgrcOut, params->compressionLevel, params->pgSeqBlocksPerThread,
+                    (size_t) params->pgSeqBlocksPrimingLengthInMB << 20,
+                    params->extraFilesForValidation?params->pgSeqFinalHqPrefix:"",
                     params->extraFilesForValidation?params->pgSeqFinalLqPrefix:"",
                     params->extraFilesForValidation?params->pgNPrefix:"",
                     params->targetPgMatchLength);
+            completeStage(stageCount);
         }
         finalizeCompression();
         data.disposeChainData();
@@ -252,13 +299,27 @@ namespace PgTools {
     }
 
     void PgRCEncoder::runQualityBasedDivision() {
-        ReadsSourceIteratorTemplate<uint_read_len_max> *allReadsIterator = ReadsSetPersistence::createManagedReadsIterator(
-                params->srcFastqFile, params->pairFastqFile, params->revComplPairFile);
-        data.divReadsSets =
-                DividedPCLReadsSets::getQualityDivisionBasedReadsSets(allReadsIterator, params->readLength,
-                        params->error_limit_in_promils / 1000.0, params->simplified_suffix_mode,
-                        params->separateNReads, params->nReadsLQ);
-        delete (allReadsIterator);
+        ReadsSetPersistence::ManagedReadsChunks* readsChunks = nullptr;
+        if (numberOfThreads > 1 && ReadsSetPersistence::memoryMappedFASTQMode)
+            readsChunks = ReadsSetPersistence::createManagedReadsChunks(params->srcFastqFile, params->pairFastqFile,
+                    params->revComplPairFile, numberOfThreads * QUALITY_DIVISION_CHUNKS_PER_THREAD);
+        if (readsChunks) {
+            data.divReadsSets =
+                    DividedPCLReadsSets::getQualityDivisionBasedReadsSets(readsChunks, params->readLength,
+                            params->error_limit_in_promils / 1000.0, params->simplified_suffix_mode,
+                            params->separateNReads, params->nReadsLQ);
+            delete (readsChunks);
+        } else {
+            ReadsSourceIteratorTemplate<uint_read_len_max> *allReadsIterator = ReadsSetPersistence::createManagedReadsIterator(
+                    params->srcFastqFile, params->pairFastqFile, params->revComplPairFile);
+            data.divReadsSets =
+                    DividedPCLReadsSets::getQualityDivisionBasedReadsSets(allReadsIterator, params->readLength,
+                            params->error_limit_in_promils / 1000.0, params->simplified_suffix_mode,
+                            params->separateNReads, params->nReadsLQ,
+                            getFilesSizeInBytes(params->srcFastqFile, params->pairFastqFile));
+            delete (allReadsIterator);
+        }
+        params->readLength = data.divReadsSets->getHqReadsSet()->maxReadLength();
     }
 
     void PgRCEncoder::persistReadsQualityDivision() {
@@ -277,9 +338,11 @@ namespace PgTools {
                         params->separateNReads ? params->nDivisionFile : "");
             } else {
                 data.divReadsSets = DividedPCLReadsSets::getSimpleDividedPCLReadsSets(allReadsIterator, params->readLength,
-                        params->separateNReads, params->nReadsLQ);
+                        params->separateNReads, params->nReadsLQ,
+                        getFilesSizeInBytes(params->srcFastqFile, params->pairFastqFile));
             }
             delete (allReadsIterator);
+            params->readLength = data.divReadsSets->getHqReadsSet()->maxReadLength();
         }
     }
 
@@ -363,7 +426,7 @@ namespace PgTools {
                 params->preReadsExactMatchingChars, params->readsExactMatchingChars,
                 params->minCharsPerMismatch, params->preMatchingMode, params->matchingMode,
                 dumpInfoFlag, pgrcOut, params->compressionLevel,
-                params->extraFilesForValidation?params->pgMappedHqPrefix:"", mapping);
+                params->extraFilesForValidation?params->pgMappedHqPrefix:"", mapping, params->randomAccessMode);
         uint_reads_cnt_max nBegIdx = data.divReadsSets->getLqReadsSet()->readsCount();
         data.divReadsSets->removeReadsFromLqReadsSet(isReadMappedIntoHqPg);
         if (params->separateNReads) {
@@ -459,6 +522,79 @@ namespace PgTools {
     }
 
 
+    void PgRCEncoder::completeStage(uint8_t stage) {
+        releaseFreedMemory();
+        stagePeakMemory[stage - 1] = getPeakResidentMemory();
+        *logout << "... stage " << (int) stage << " peak memory: " << toMB(stagePeakMemory[stage - 1], 1) << " MB"
+                << " (resident after stage: " << toMB(getResidentMemory(), 1) << " MB)." << endl;
+        resetPeakResidentMemory();
+    }
+
+    // the next stage working memory is assumed to be comparable to the resident chain data
+    bool PgRCEncoder::isMemoryBudgetApproached() {
+        return params->maxMemoryInMB && getResidentMemory() > (size_t) params->maxMemoryInMB * 1000000 / 2;
+    }
+
+    string PgRCEncoder::getSpillFileName(const string &dataName) {
+        return params->pgRCFileName + "_" + dataName + TEMPORARY_FILE_SUFFIX;
+    }
+
+    void PgRCEncoder::spillOrderInfo() {
+        if (isOrderInfoSpilled)
+            return;
+        isOrderInfoSpilled = params->preserveOrderMode ? spillToFile(data.orgIdx2PgPos, getSpillFileName("pos")) :
+                spillToFile(data.rlIdxOrder, getSpillFileName("order"));
+        if (isOrderInfoSpilled)
+            *logout << "Spilled reads order info to disk (resident memory: " << toMB(getResidentMemory(), 1)
+                    << " MB)." << endl;
+    }
+
+    void PgRCEncoder::restoreOrderInfo() {
+        if (!isOrderInfoSpilled)
+            return;
+        if (params->preserveOrderMode)
+            restoreSpilledFile(data.orgIdx2PgPos, getSpillFileName("pos"));
+        else
+            restoreSpilledFile(data.rlIdxOrder, getSpillFileName("order"));
+        isOrderInfoSpilled = false;
+    }
+
+    void PgRCEncoder::spillPgSequences() {
+        bool spilled = false;
+        if (data.hqPg && !isHqPgSequenceSpilled)
+            spilled |= isHqPgSequenceSpilled = spillToFile(data.hqPg->getPgSequence(), getSpillFileName(GOOD_INFIX));
+        if (data.lqPg && !isLqPgSequenceSpilled)
+            spilled |= isLqPgSequenceSpilled = spillToFile(data.lqPg->getPgSequence(), getSpillFileName(BAD_INFIX));
+        if (data.nPg && !isNPgSequenceSpilled)
+            spilled |= isNPgSequenceSpilled = spillToFile(data.nPg->getPgSequence(), getSpillFileName(N_INFIX));
+        if (spilled)
+            *logout << "Spilled pseudogenome sequences to disk (resident memory: " << toMB(getResidentMemory(), 1)
+                    << " MB)." << endl;
+    }
+
+    void PgRCEncoder::restorePgSequences() {
+        if (isHqPgSequenceSpilled)
+            restoreSpilledFile(data.hqPg->getPgSequence(), getSpillFileName(GOOD_INFIX));
+        if (isLqPgSequenceSpilled)
+            restoreSpilledFile(data.lqPg->getPgSequence(), getSpillFileName(BAD_INFIX));
+        if (isNPgSequenceSpilled)
+            restoreSpilledFile(data.nPg->getPgSequence(), getSpillFileName(N_INFIX));
+        isHqPgSequenceSpilled = isLqPgSequenceSpilled = isNPgSequenceSpilled = false;
+    }
+
+    void PgRCEncoder::reportStagesPeakMemory() {
+        ostream* out = params->maxMemoryInMB ? &cout : logout;
+        *out << "Peak memory per stage [MB]:";
+        for (uint8_t i = 0; i < STAGES_COUNT; i++)
+            if (stagePeakMemory[i])
+                *out << " " << (int) (i + 1) << ":" << toMB(stagePeakMemory[i], 0);
+        *out << endl;
+        for (uint8_t i = 0; i < STAGES_COUNT; i++)
+            if (params->maxMemoryInMB && stagePeakMemory[i] > (size_t) params->maxMemoryInMB * 1000000)
+                fprintf(stderr, "Warning: peak memory of stage %d (%s MB) exceeded the budget (%u MB).\n",
+                        i + 1, toMB(stagePeakMemory[i], 0).c_str(), params->maxMemoryInMB);
+    }
+
     void PgRCEncoder::compressMEMMappedPgSequences() {
         cout << "Error: unimplemented standalone compressMEMMappedPgSequences!" << endl;
         exit(EXIT_FAILURE);
@@ -494,10 +630,26 @@ namespace PgTools {
         fout << getTimeInSec(chrono::steady_clock::now(), order_t, 2) << endl;
     }
 
+    void PgRCEncoder::writeStreamsIndex() {
+        pgrcOut.flush();
+        string pgRCTempFileName = params->pgRCFileName + TEMPORARY_FILE_SUFFIX;
+        PgHelpers::MemoryMappedFile* archive = PgHelpers::MemoryMappedFile::open(pgRCTempFileName, false);
+        vector<StreamIndexEntry> index;
+        if (!archive || !scanStreamsIndex(archive->begin(), streamsOffset, archive->length(), index)) {
+            fprintf(stderr, "Error indexing streams of file: %s\n", pgRCTempFileName.c_str());
+            exit(EXIT_FAILURE);
+        }
+        calculateStreamsChecksums(archive->begin(), index);
+        delete(archive);
+        ::writeStreamsIndex(pgrcOut, index);
+    }
+
     void PgRCEncoder::finalizeCompression() {
+        writeStreamsIndex();
         pgRCSize = pgrcOut.tellp();
         cout << endl << "Created PgRC of size " << pgRCSize << " bytes in "
              << toString((double) time_millis(start_t ) / 1000, 2) << " s." << endl;
+        reportStagesPeakMemory();
         pgrcOut.close();
         string pgRCTempFileName = params->pgRCFileName + TEMPORARY_FILE_SUFFIX;
         if (std::ifstream(params->pgRCFileName))
@@ -517,5 +669,15 @@ namespace PgTools {
         return readsLength;
     }
 
+    uint64_t getFilesSizeInBytes(const string &srcFile, const string &pairFile) {
+        uint64_t size = 0;
+        struct stat st;
+        if (stat(srcFile.c_str(), &st) == 0 && S_ISREG(st.st_mode))
+            size += st.st_size;
+        if (!pairFile.empty() && stat(pairFile.c_str(), &st) == 0 && S_ISREG(st.st_mode))
+            size += st.st_size;
+        return size;
+    }
+
 
 }
\ No newline at end of file
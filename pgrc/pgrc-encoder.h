@@ -13,6 +13,10 @@ namespace PgTools {
         PgRCParams* params;
         PgRCData data;
         fstream pgrcOut;
+        // streams written to the archive from the offset are indexed when finalizing compression
+        uint64_t streamsOffset = 0;
+
+        static const int QUALITY_DIVISION_CHUNKS_PER_THREAD = 4;
 
         // TESTING&REPORTING
         chrono::steady_clock::time_point start_t;
@@ -26,6 +30,23 @@ namespace PgTools {
 
         void generateReport();
 
+        // MEMORY MANAGEMENT
+        static const uint8_t STAGES_COUNT = 7;
+        size_t stagePeakMemory[STAGES_COUNT] = {};
+        bool isOrderInfoSpilled = false;
+        bool isHqPgSequenceSpilled = false;
+        bool isLqPgSequenceSpilled = false;
+        bool isNPgSequenceSpilled = false;
+
+        void completeStage(uint8_t stage);
+        bool isMemoryBudgetApproached();
+        string getSpillFileName(const string &dataName);
+        void spillOrderInfo();
+        void restoreOrderInfo();
+        void spillPgSequences();
+        void restorePgSequences();
+        void reportStagesPeakMemory();
+
         // CHAIN METHODS
         void prepareChainData();
 
@@ -73,6 +94,7 @@ namespace PgTools {
 
         void prepareForPgMatching();
 
+        void writeStreamsIndex();
         void finalizeCompression();
 
     public:
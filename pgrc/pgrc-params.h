@@ -15,9 +15,9 @@ namespace PgTools {
     static const char PGRC_MIN_PE_MODE = 4;
 
     static const char PGRC_VERSION_MODE = '#';
-    static const char PGRC_VERSION_MAJOR = 2;
-    static const char PGRC_VERSION_MINOR = 0;
-    static const char PGRC_VERSION_REVISION = 2;
+    static const char PGRC_VERSION_MAJOR = 3;
+    static const char PGRC_VERSION_MINOR = 1;
+    static const char PGRC_VERSION_REVISION = 0;
 
     static const char *const BAD_INFIX = "bad";
     static const char *const GOOD_INFIX = "good";
@@ -29,6 +29,17 @@ namespace PgTools {
     static const int MIN_CHARS_PER_PGMATCH = 20;
     static const int MIN_CHARS_PER_MISMATCH = 2;
     static const int MIN_READS_EXACT_MATCHING_CHARS = 20;
+    static const int DEFAULT_PG_SEQ_BLOCKS_PRIMING_LENGTH_IN_MB = 16;
+    // blocks of the random access mode: reads (pairs in PE mode) in the original order and pseudogenome bases
+    static const uint32_t RANDOM_ACCESS_READS_BLOCK_LENGTH = 1 << 14;
+    static const uint32_t RANDOM_ACCESS_PG_BLOCK_LENGTH = 1 << 18;
+
+    static const char OUTPUT_SEQ_FORMAT = 's';
+    static const char OUTPUT_FASTA_FORMAT = 'a';
+    static const char OUTPUT_FASTQ_FORMAT = 'q';
+    static const char OUTPUT_FASTQ_QUALITY_SCORE = 'I';
+    static const char *const STDOUT_OUTPUT_NAME = "-";
+    static const char *const FD_OUTPUT_PREFIX = "fd:";
 
     static const char DEFAULT_CHAR_PARAM = CHAR_MAX;
     static const uint16_t DEFAULT_UINT16_PARAM = UINT16_MAX;
@@ -50,6 +61,16 @@ namespace PgTools {
         string srcFastqFile = "";
         string pairFastqFile = "";
 
+        // DECOMPRESSION PARAMETERS
+        string outputName = "";
+        char outputFormat = OUTPUT_SEQ_FORMAT;
+        // range of original indexes (of pairs in PE mode) of written reads: [readsRangeBegin, readsRangeEnd)
+        // (only blocks covering the range are decoded from random access archives; otherwise the output
+        // is filtered - archive streams are decoded entirely, except for mappings of LQ and N pseudogenomes
+        // without reads in the range)
+        uint64_t readsRangeBegin = 0;
+        uint64_t readsRangeEnd = UINT64_MAX;
+
         // COMPRESSION PARAMETERS
         uint8_t compressionLevel = CODER_LEVEL_NORMAL;
         bool forceConstantParamsMode = true;
@@ -63,6 +84,14 @@ namespace PgTools {
         char preMatchingMode = CHAR_MAX;
         char matchingMode = CHAR_MAX;
         uint16_t targetPgMatchLength = DEFAULT_UINT16_PARAM;
+        // pseudogenome sequences coded in parallel blocks (0 - disabled) primed with the shared prefix
+        uint16_t pgSeqBlocksPerThread = 0;
+        uint32_t pgSeqBlocksPrimingLengthInMB = DEFAULT_PG_SEQ_BLOCKS_PRIMING_LENGTH_IN_MB;
+        // resident memory budget (0 - unlimited); idle chain data is spilled to disk when approaching it
+        uint32_t maxMemoryInMB = 0;
+        // positions, HQ reads list and pseudogenome sequence coded in independently decodable blocks
+        // (order preserving modes only; pseudogenomes are not matched)
+        bool randomAccessMode = false;
 
         // CHAIN MANAGEMENT
         uint8_t skipStages = 0;
@@ -116,15 +145,14 @@ namespace PgTools {
             setPreMatchingMode('c');
             switch (compressionLevel) {
                 case CODER_LEVEL_FAST:
-/*                    setQualityBasedDivisionErrorLimitInPromils(1);
-                    disableSimplifiedSuffixMode4QualityBasedDivision();
-                    setPgGeneratorBasedDivisionOverlapThreshold_str("0");
-                    setMatchingMode('C');
+                    setQualityBasedDivisionErrorLimitInPromils(120);
+                    setPgGeneratorBasedDivisionOverlapThreshold_str("65");
                     setPreReadsExactMatchingChars(0);
-                    setReadSeedLength(54);
-                    setMinCharsPerMismatch(2);
-                    setMinimalPgReverseComplementedRepeatLength(25);
-                    break;*/
+                    setMatchingMode('C');
+                    setReadSeedLength(38);
+                    setMinCharsPerMismatch(3);
+                    setMinimalPgReverseComplementedRepeatLength(45);
+                    break;
                 case CODER_LEVEL_MAX:
 /*                    setQualityBasedDivisionErrorLimitInPromils(200);
                     disableSimplifiedSuffixMode4QualityBasedDivision();
@@ -280,6 +308,75 @@ namespace PgTools {
             PgRCParams::targetPgMatchLength = targetPgMatchLength;
         }
 
+        void setPgSeqParallelBlocks(const string &blocksParams) {
+            char* end;
+            long blocksPerThread = strtol(blocksParams.c_str(), &end, 10);
+            long primingLengthInMB = DEFAULT_PG_SEQ_BLOCKS_PRIMING_LENGTH_IN_MB;
+            if (*end == ':')
+                primingLengthInMB = strtol(end + 1, &end, 10);
+            if (*end || end == blocksParams.c_str() || blocksPerThread < 0 || blocksPerThread > UINT8_MAX
+                || primingLengthInMB < 0 || primingLengthInMB > (MAX_PARALLEL_BLOCKS_PRIMING_LENGTH >> 20)) {
+                fprintf(stderr, "Invalid pseudogenome parallel blocks parameters: %s "
+                                "(expected blocksPerThread[:primingLengthInMB]).\n", blocksParams.c_str());
+                exit(EXIT_FAILURE);
+            }
+            PgRCParams::pgSeqBlocksPerThread = blocksPerThread;
+            PgRCParams::pgSeqBlocksPrimingLengthInMB = primingLengthInMB;
+        }
+
+        void setRandomAccessMode() {
+            PgRCParams::randomAccessMode = true;
+        }
+
+        void setMaxMemory(const string &maxMemoryInMB) {
+            char* end;
+            long value = strtol(maxMemoryInMB.c_str(), &end, 10);
+            if (*end || end == maxMemoryInMB.c_str() || value <= 0 || value > UINT32_MAX) {
+                fprintf(stderr, "Invalid memory budget: %s (expected a positive number of MB).\n",
+                        maxMemoryInMB.c_str());
+                exit(EXIT_FAILURE);
+            }
+            PgRCParams::maxMemoryInMB = value;
+        }
+
+        void setOutputName(const string &outputName) {
+            PgRCParams::outputName = outputName;
+        }
+
+        void setOutputFormat(char outputFormat) {
+            if (outputFormat != OUTPUT_SEQ_FORMAT && outputFormat != OUTPUT_FASTA_FORMAT &&
+                outputFormat != OUTPUT_FASTQ_FORMAT) {
+                fprintf(stderr, "Unknown output format: %c.\n", outputFormat);
+                exit(EXIT_FAILURE);
+            }
+            PgRCParams::outputFormat = outputFormat;
+        }
+
+        // range of 1-based record numbers "first[:last]" (inclusive; an open range when last is omitted)
+        void setReadsRange(const string &range) {
+            char* end;
+            uint64_t first = strtoull(range.c_str(), &end, 10);
+            uint64_t last = UINT64_MAX;
+            if (*end == ':' && *(end + 1))
+                last = strtoull(end + 1, &end, 10);
+            else if (*end == ':')
+                end++;
+            if (*end || range.find_first_not_of("0123456789:") != string::npos || first == 0 || last < first) {
+                fprintf(stderr, "Invalid reads range: %s (expected first[:last]).\n", range.c_str());
+                exit(EXIT_FAILURE);
+            }
+            setReadsRange(first - 1, last);
+        }
+
+        void setReadsRange(uint64_t begin, uint64_t end) {
+            PgRCParams::readsRangeBegin = begin;
+            PgRCParams::readsRangeEnd = end;
+        }
+
+        bool isReadsRangeSelected() const {
+            return readsRangeBegin > 0 || readsRangeEnd != UINT64_MAX;
+        }
+
         void setPgRCFileName(const string &pgRCFileName) {
             PgRCParams::pgRCFileName = pgRCFileName;
         }
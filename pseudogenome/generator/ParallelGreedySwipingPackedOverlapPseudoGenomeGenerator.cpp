@@ -2,16 +2,8 @@
 #include "../../readsset/persistance/ReadsSetPersistence.h"
 #include "AbstractOverlapPseudoGenomeGenerator.h"
 
-#ifdef __APPLE__
-#define PSTLD_HEADER_ONLY
-#include "../../utils/pstld.h"
-#define parallel_algorithm pstld
-#else
-#include <parallel/algorithm>
-#define parallel_algorithm __gnu_parallel
-#endif
-
 #include <cassert>
+#include <omp.h>
 
 using namespace PgReadsSet;
 using namespace PgHelpers;
@@ -20,11 +12,37 @@ using namespace PgHelpers;
 
 namespace PgIndex {
 
+    bool BlocksWorkStealingScheduler::takeBlock(ThreadRange &threadRange, bool fromFront, uint16_t &block) {
+        uint64_t range = threadRange.range.load(std::memory_order_relaxed);
+        while (true) {
+            const uint32_t next = range >> 32;
+            const uint32_t end = (uint32_t) range;
+            if (next >= end)
+                return false;
+            const uint64_t updated = fromFront ? range + (1ULL << 32) : range - 1;
+            if (threadRange.range.compare_exchange_weak(range, updated, std::memory_order_relaxed)) {
+                block = fromFront ? next : end - 1;
+                return true;
+            }
+        }
+    }
+
+    bool BlocksWorkStealingScheduler::nextBlock(int thread, uint16_t &block) {
+        if (takeBlock(ranges[thread % threadsCount], true, block))
+            return true;
+        for (int i = 1; i < threadsCount; i++) {
+            if (takeBlock(ranges[(thread + i) % threadsCount], false, block))
+                return true;
+        }
+        return false;
+    }
+
     template<typename uint_read_len, typename uint_reads_cnt>
     ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::ParallelGreedySwipingPackedOverlapGeneratorTemplate(
             PackedConstantLengthReadsSet* orgReadsSet, bool ownReadsSet):
         packedReadsSet(orgReadsSet), symbolsCount(orgReadsSet->getReadsSetProperties()->symbolsCount),
-        ownReadsSet(ownReadsSet)
+        ownReadsSet(ownReadsSet), blockPrefixLength(selectBlockPrefixLength(
+                orgReadsSet->getReadsSetProperties()->symbolsCount, orgReadsSet->maxReadLength()))
     {
         if (!orgReadsSet->isReadLengthConstant())
             cout << "Unsupported: variable length reads :(";
@@ -36,6 +54,28 @@ namespace PgIndex {
             delete(this->packedReadsSet);
     }
     
+    template<typename uint_read_len, typename uint_reads_cnt>
+    uint8_t ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::selectBlockPrefixLength(
+            uint_symbols_cnt symbolsCount, uint_read_len_max readLength) {
+        uint8_t prefixLength = ParallelGreedySwipingPackedOverlapPseudoGenomeGeneratorFactory::blockPrefixLength;
+        if (prefixLength) {
+            if (prefixLength > MAX_BLOCK_PREFIX_LENGTH || prefixLength >= readLength) {
+                fprintf(stderr, "Unsupported block prefix length: %d (max %d and less than reads length)\n",
+                        (int) prefixLength, (int) MAX_BLOCK_PREFIX_LENGTH);
+                exit(EXIT_FAILURE);
+            }
+            return prefixLength;
+        }
+        // longer prefixes (more blocks) for more threads
+        prefixLength = DEFAULT_BLOCK_PREFIX_LENGTH;
+        while (prefixLength < MAX_BLOCK_PREFIX_LENGTH &&
+                powuint(symbolsCount, prefixLength) < (uint64_t) MIN_BLOCKS_PER_THREAD * numberOfThreads)
+            prefixLength++;
+        while (prefixLength > 1 && prefixLength >= readLength)
+            prefixLength--;
+        return prefixLength;
+    }
+
     template<typename uint_read_len, typename uint_reads_cnt>
     string ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::getReadUpToOverlap(uint_reads_cnt incIdx) {
         return packedReadsSet->getReadPrefix(incIdx - 1, this->overlap[incIdx]);
@@ -117,28 +157,117 @@ namespace PgIndex {
 
 
     template<typename uint_read_len, typename uint_reads_cnt>
-    void ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::prepareSortedReadsBlocks() {
-        for (uint_reads_cnt i = 1; i <= packedReadsSet->readsCount(); i++)
-            sortedReadsIdxs.push_back(i);
-        PackedReadsComparator comparePacked = PackedReadsComparator(this);
-        parallel_algorithm::sort(sortedReadsIdxs.begin(), sortedReadsIdxs.end(), comparePacked);
+    void ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::radixSortReadsBucket(
+            uint_reads_cnt *idxs, uint_reads_cnt *tmpIdxs, uint_reads_cnt count, uchar elementPos) {
+        const uint_ps_element_min* packedReads = packedReadsSet->getPackedRead(0);
+        const uchar packedLength = packedReadsSet->getPackedLength();
+        // skipping elements shared by all reads in a bucket (e.g. duplicates)
+        while (elementPos < packedLength && count > RADIX_SORT_COMPARISON_SORT_THRESHOLD) {
+            const uint_ps_element_min value = packedReads[(idxs[0] - 1) * (size_t) packedLength + elementPos];
+            uint_reads_cnt i = 1;
+            while (i < count && packedReads[(idxs[i] - 1) * (size_t) packedLength + elementPos] == value)
+                i++;
+            if (i < count)
+                break;
+            elementPos++;
+        }
+        if (count <= RADIX_SORT_COMPARISON_SORT_THRESHOLD || elementPos == packedLength) {
+            // packed elements order is consistent with the symbols order (duplicates are ordered by index)
+            std::sort(idxs, idxs + count, [&](uint_reads_cnt lIncIdx, uint_reads_cnt rIncIdx) {
+                int cmp = memcmp(packedReads + (lIncIdx - 1) * (size_t) packedLength + elementPos,
+                                 packedReads + (rIncIdx - 1) * (size_t) packedLength + elementPos,
+                                 packedLength - elementPos);
+                return cmp < 0 || (cmp == 0 && lIncIdx < rIncIdx);
+            });
+            return;
+        }
+        uint_reads_cnt bucketPos[UINT8_MAX + 2] = { 0 };
+        for (uint_reads_cnt i = 0; i < count; i++)
+            bucketPos[packedReads[(idxs[i] - 1) * (size_t) packedLength + elementPos] + 1]++;
+        for (int v = 0; v <= UINT8_MAX; v++)
+            bucketPos[v + 1] += bucketPos[v];
+        uint_reads_cnt nextPos[UINT8_MAX + 1];
+        memcpy(nextPos, bucketPos, sizeof(nextPos));
+        for (uint_reads_cnt i = 0; i < count; i++)
+            tmpIdxs[nextPos[packedReads[(idxs[i] - 1) * (size_t) packedLength + elementPos]]++] = idxs[i];
+        memcpy(idxs, tmpIdxs, count * sizeof(uint_reads_cnt));
+        for (int v = 0; v <= UINT8_MAX; v++) {
+            uint_reads_cnt bucketCount = bucketPos[v + 1] - bucketPos[v];
+            if (bucketCount < 2)
+                continue;
+            uint_reads_cnt* bucketIdxs = idxs + bucketPos[v];
+            uint_reads_cnt* bucketTmpIdxs = tmpIdxs + bucketPos[v];
+            if (bucketCount >= RADIX_SORT_PARALLEL_TASK_THRESHOLD) {
+                #pragma omp task
+                radixSortReadsBucket(bucketIdxs, bucketTmpIdxs, bucketCount, elementPos + 1);
+            } else
+                radixSortReadsBucket(bucketIdxs, bucketTmpIdxs, bucketCount, elementPos + 1);
+        }
+    }
 
+    template<typename uint_read_len, typename uint_reads_cnt>
+    void ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::prepareSortedReadsBlocks() {
+        const uint_reads_cnt readsCount = packedReadsSet->readsCount();
+        const uint_ps_element_min* packedReads = packedReadsSet->getPackedRead(0);
+        const uchar packedLength = packedReadsSet->getPackedLength();
+        const uchar symbolsPerElement = packedReadsSet->sPacker->getSymbolsPerElement();
         blocksCount = pow(symbolsCount, blockPrefixLength);
+        // block prefix of a read is determined by its first two packed elements
+        const uint32_t elementValuesCount = pow(symbolsCount, symbolsPerElement);
+        const uint32_t blockDivisor = pow(symbolsCount, 2 * symbolsPerElement - blockPrefixLength);
+        const int threadsCount = numberOfThreads;
+        vector<uint_reads_cnt> threadsElementPos(threadsCount * (size_t) (UINT8_MAX + 1), 0);
+        vector<uint_reads_cnt> blockCounts(threadsCount * (size_t) blocksCount, 0);
         #pragma omp parallel for
-        for (uint16_t b = 0; b < blocksCount; b++) {
-            char *prefix = blockPrefixes[b];
-            uint16_t val = b;
-            for (uint8_t j = 0; j < blockPrefixLength; j++) {
-                uint8_t div = val % symbolsCount;
-                prefix[blockPrefixLength - j - 1] = packedReadsSet->getReadsSetProperties()->symbolsList[div];
-                val = val / symbolsCount;
+        for (int t = 0; t < threadsCount; t++) {
+            uint_reads_cnt* threadElementCounts = threadsElementPos.data() + t * (size_t) (UINT8_MAX + 1);
+            uint_reads_cnt* threadBlockCounts = blockCounts.data() + t * (size_t) blocksCount;
+            const uint_reads_cnt end = (uint_reads_cnt) ((uint64_t) readsCount * (t + 1) / threadsCount);
+            for (uint_reads_cnt i = (uint64_t) readsCount * t / threadsCount; i < end; i++) {
+                const uint_ps_element_min* read = packedReads + i * (size_t) packedLength;
+                threadElementCounts[read[0]]++;
+                const uint32_t prefixValue = read[0] * elementValuesCount + (packedLength > 1 ? read[1] : 0);
+                threadBlockCounts[prefixValue / blockDivisor]++;
             }
-            PackedReadVsPatternComparator comparePackedWithPattern = PackedReadVsPatternComparator(this, prefix);
-            sortedReadsBlockPos[b] = lower_bound(sortedReadsIdxs.begin(), sortedReadsIdxs.end(),
-                                                 comparePackedWithPattern.PATTERN_INDEX,
-                                                 comparePackedWithPattern) - sortedReadsIdxs.begin();
         }
-        sortedReadsBlockPos[blocksCount] = packedReadsSet->readsCount();
+        uint_reads_cnt bucketPos[UINT8_MAX + 2];
+        uint_reads_cnt pos = 0;
+        for (int v = 0; v <= UINT8_MAX; v++) {
+            bucketPos[v] = pos;
+            for (int t = 0; t < threadsCount; t++) {
+                uint_reads_cnt count = threadsElementPos[t * (size_t) (UINT8_MAX + 1) + v];
+                threadsElementPos[t * (size_t) (UINT8_MAX + 1) + v] = pos;
+                pos += count;
+            }
+        }
+        bucketPos[UINT8_MAX + 1] = pos;
+        pos = 0;
+        for (uint16_t b = 0; b < blocksCount; b++) {
+            sortedReadsBlockPos[b] = pos;
+            for (int t = 0; t < threadsCount; t++)
+                pos += blockCounts[t * (size_t) blocksCount + b];
+        }
+        sortedReadsBlockPos[blocksCount] = readsCount;
+
+        sortedReadsIdxs.resize(readsCount);
+        vector<uint_reads_cnt> tmpIdxs(readsCount);
+        #pragma omp parallel for
+        for (int t = 0; t < threadsCount; t++) {
+            uint_reads_cnt* threadElementPos = threadsElementPos.data() + t * (size_t) (UINT8_MAX + 1);
+            const uint_reads_cnt end = (uint_reads_cnt) ((uint64_t) readsCount * (t + 1) / threadsCount);
+            for (uint_reads_cnt i = (uint64_t) readsCount * t / threadsCount; i < end; i++)
+                sortedReadsIdxs[threadElementPos[packedReads[i * (size_t) packedLength]]++] = i + 1;
+        }
+        #pragma omp parallel
+        #pragma omp single
+        for (int v = 0; v <= UINT8_MAX; v++) {
+            uint_reads_cnt bucketCount = bucketPos[v + 1] - bucketPos[v];
+            if (bucketCount < 2)
+                continue;
+            #pragma omp task
+            radixSortReadsBucket(sortedReadsIdxs.data() + bucketPos[v], tmpIdxs.data() + bucketPos[v],
+                                 bucketCount, 1);
+        }
     }
 
     template<typename uint_read_len, typename uint_reads_cnt>
@@ -146,22 +275,15 @@ namespace PgIndex {
     void ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::initAndFindDuplicates() {
         auto start_t = chrono::steady_clock::now();
         prepareSortedReadsBlocks();
-        uint16_t b = 0;
-        threadStartBlock[UINT8_MAX] = 0;
-        for(uint8_t t = 1; t <= numberOfThreads; t++) {
-            uint_reads_cnt threshold = ((double) t / numberOfThreads) * this->readsLeft;
-            while (sortedReadsBlockPos[b] < threshold) {
-                b++;
-            }
-            threadStartBlock[t] = b;
-        }
-        threadStartBlock[numberOfThreads] = blocksCount;
+        BlocksWorkStealingScheduler scheduler(numberOfThreads, blocksCount, [this](uint16_t b) {
+            return sortedReadsBlockPos[b + 1] - sortedReadsBlockPos[b];
+        });
         uint_reads_cnt sortedSuffixesLeftCount[MAX_BLOCKS_COUNT] = { 0 };
         uint_reads_cnt duplicatesCount = 0;
-        #pragma omp parallel for reduction(+:sortedSuffixesLeftCount[0:MAX_BLOCKS_COUNT]) reduction(+:duplicatesCount)
-        for(uint8_t t = 0; t < numberOfThreads; t++)
+        #pragma omp parallel reduction(+:sortedSuffixesLeftCount[0:blocksCount]) reduction(+:duplicatesCount)
         {
-            for (uint16_t b = threadStartBlock[t]; b < threadStartBlock[t + 1]; b++)
+            uint16_t b;
+            while (scheduler.nextBlock(omp_get_thread_num(), b))
             {
                 sortedReadsCount[b] = sortedReadsBlockPos[b + 1] - sortedReadsBlockPos[b];
                 uchar curSymOrder = 0;
@@ -192,7 +314,13 @@ namespace PgIndex {
         this->readsLeft -= duplicatesCount;
         assert(accumulate(sortedSuffixesLeftCount, sortedSuffixesLeftCount + blocksCount, 0) == this->readsLeft);
         cout << "Found " << (readsTotal() - this->readsLeft) << " duplicates (..." << time_millis() << " msec)" << endl;
-        sortedSuffixIdxs.resize(this->readsLeft, 0);
+        sortedSuffixIdxs.resize(this->readsLeft);
+        sortedSuffixLeftIdxs.resize(this->readsLeft);
+        #pragma omp parallel for schedule(static)
+        for (uint_reads_cnt i = 0; i < this->readsLeft; i++) {
+            sortedSuffixIdxs[i] = 0;
+            sortedSuffixLeftIdxs[i] = 0;
+        }
         mergeSortOfLeftSuffixes(1, sortedSuffixesLeftCount, sortedSuffixIdxs.data(), sortedReadsIdxs.data());
 
         #pragma omp parallel for schedule(guided)
@@ -218,35 +346,41 @@ namespace PgIndex {
             sortedSuffixBlockPos[b] = sortedSuffixBlockPos[b - 1] + sortedSuffixesLeftCount[b - 1];
 
         this->sortedSuffixIdxsPtr = sortedSuffixIdxsPtr;
-        #pragma omp parallel for schedule(guided)
-        for(uint16_t b = 0; b < blocksCount; b++)
+        BlocksWorkStealingScheduler scheduler(numberOfThreads, blocksCount, [sortedSuffixesLeftCount](uint16_t b) {
+            return sortedSuffixesLeftCount[b];
+        });
+        #pragma omp parallel
         {
-            uint16_t prevYoungestBlock = b / symbolsCount;
-            uint8_t lastPrefixSymbolOrder = b % symbolsCount;
-            uint_reads_cnt ssiSymbolIdx[MAX_SYMBOLS_COUNT];
-            uint_reads_cnt ssiSymbolEnd[MAX_SYMBOLS_COUNT];
-            for (uint8_t j = 0; j < symbolsCount; j++) {
-                ssiSymbolIdx[j] = sortedSuffixBlockPlusSymbolPos[prevYoungestBlock + (blocksCount / symbolsCount) * j]
-                [lastPrefixSymbolOrder];
-                ssiSymbolEnd[j] = sortedSuffixBlockPlusSymbolPos[prevYoungestBlock + (blocksCount / symbolsCount) * j]
-                [lastPrefixSymbolOrder + 1];
-            }
-            deque<uchar> ssiOrder;
-            for (uint8_t j = 0; j < symbolsCount; j++) {
-                while (ssiSymbolIdx[j] < ssiSymbolEnd[j] &&
-                       this->nextRead[sortedSuffixIdxsPtr[ssiSymbolIdx[j]]] != 0)
-                    ssiSymbolIdx[j]++;
-                updateSuffixQueue(j, offset + blockPrefixLength, ssiSymbolIdx, ssiSymbolEnd, ssiOrder);
-            }
-            uint_reads_cnt curPos = sortedSuffixBlockPos[b];
-            while (!ssiOrder.empty()) {
-                uchar j = ssiOrder.front();
-                uint_reads_cnt sufIdx = sortedSuffixIdxsPtr[ssiSymbolIdx[j]];
-                sortedSuffixLeftIdxsPtr[curPos++] = sufIdx;
-                ssiOrder.pop_front();
-                while (++ssiSymbolIdx[j] < ssiSymbolEnd[j] &&
-                        this->nextRead[sortedSuffixIdxsPtr[ssiSymbolIdx[j]]] != 0);
-                updateSuffixQueue(j, offset + blockPrefixLength, ssiSymbolIdx, ssiSymbolEnd, ssiOrder);
+            uint16_t b;
+            while (scheduler.nextBlock(omp_get_thread_num(), b))
+            {
+                uint16_t prevYoungestBlock = b / symbolsCount;
+                uint8_t lastPrefixSymbolOrder = b % symbolsCount;
+                uint_reads_cnt ssiSymbolIdx[MAX_SYMBOLS_COUNT];
+                uint_reads_cnt ssiSymbolEnd[MAX_SYMBOLS_COUNT];
+                for (uint8_t j = 0; j < symbolsCount; j++) {
+                    ssiSymbolIdx[j] = sortedSuffixBlockPlusSymbolPos[prevYoungestBlock + (blocksCount / symbolsCount) * j]
+                    [lastPrefixSymbolOrder];
+                    ssiSymbolEnd[j] = sortedSuffixBlockPlusSymbolPos[prevYoungestBlock + (blocksCount / symbolsCount) * j]
+                    [lastPrefixSymbolOrder + 1];
+                }
+                deque<uchar> ssiOrder;
+                for (uint8_t j = 0; j < symbolsCount; j++) {
+                    while (ssiSymbolIdx[j] < ssiSymbolEnd[j] &&
+                           this->nextRead[sortedSuffixIdxsPtr[ssiSymbolIdx[j]]] != 0)
+                        ssiSymbolIdx[j]++;
+                    updateSuffixQueue(j, offset + blockPrefixLength, ssiSymbolIdx, ssiSymbolEnd, ssiOrder);
+                }
+                uint_reads_cnt curPos = sortedSuffixBlockPos[b];
+                while (!ssiOrder.empty()) {
+                    uchar j = ssiOrder.front();
+                    uint_reads_cnt sufIdx = sortedSuffixIdxsPtr[ssiSymbolIdx[j]];
+                    sortedSuffixLeftIdxsPtr[curPos++] = sufIdx;
+                    ssiOrder.pop_front();
+                    while (++ssiSymbolIdx[j] < ssiSymbolEnd[j] &&
+                            this->nextRead[sortedSuffixIdxsPtr[ssiSymbolIdx[j]]] != 0);
+                    updateSuffixQueue(j, offset + blockPrefixLength, ssiSymbolIdx, ssiSymbolEnd, ssiOrder);
+                }
             }
         }
     }
@@ -264,10 +398,10 @@ namespace PgIndex {
             if (i < packedReadsSet->maxReadLength() - blockPrefixLength) {
                 uint_reads_cnt sortedSuffixesLeftCount[MAX_BLOCKS_COUNT] = {0};
                 overlapSortedReadsAndSuffixes<false>(i, sortedSuffixesLeftCount);
-                vector<uint_reads_cnt> sortedSuffixLeft(this->readsLeft, 0);
-                mergeSortOfLeftSuffixes(i + 1, sortedSuffixesLeftCount, sortedSuffixLeft.data(),
+                sortedSuffixLeftIdxs.resize(this->readsLeft);
+                mergeSortOfLeftSuffixes(i + 1, sortedSuffixesLeftCount, sortedSuffixLeftIdxs.data(),
                                         sortedSuffixIdxs.data());
-                sortedSuffixIdxs.swap(sortedSuffixLeft);
+                sortedSuffixIdxs.swap(sortedSuffixLeftIdxs);
             } else {
                 blockPrefixOverlapSortedReadsAndSuffixesWithAfterSuffixMerge<false>(i, curBlocksCount);
                 curBlocksCount /= symbolsCount;
@@ -281,6 +415,8 @@ namespace PgIndex {
         sortedReadsIdxs.shrink_to_fit();
         sortedSuffixIdxs.clear();
         sortedSuffixIdxs.shrink_to_fit();
+        sortedSuffixLeftIdxs.clear();
+        sortedSuffixLeftIdxs.shrink_to_fit();
 
         if (pgGenerationMode) {
             this->removeCyclesAndPrepareComponents();
@@ -295,28 +431,19 @@ namespace PgIndex {
     template<bool avoidCyclesMode>
     void ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>::
             overlapSortedReadsAndSuffixes(uint_read_len suffixesOffset, uint_reads_cnt *sortedSuffixesLeftCount) {
-        uint8_t threadsInIteration = suffixesOffset<25?2:(suffixesOffset<40?4:numberOfThreads);
+        int threadsInIteration = suffixesOffset<25?2:(suffixesOffset<40?4:numberOfThreads);
         if (!avoidCyclesMode || threadsInIteration > numberOfThreads)
             threadsInIteration = numberOfThreads;
 
-        uint16_t b = 0;
-        uint_reads_cnt readsAndSuffixesCount = 0;
-        threadStartBlock[UINT8_MAX] = 0;
-        for(uint8_t t = 1; t <= threadsInIteration; t++) {
-            uint_reads_cnt threshold = ((double) t / threadsInIteration) * this->readsLeft * 2;
-            while (readsAndSuffixesCount < threshold) {
-                readsAndSuffixesCount += sortedReadsCount[b] + sortedSuffixBlockPos[b + 1] - sortedSuffixBlockPos[b];
-                b++;
-            }
-            threadStartBlock[t] = b;
-        }
-        threadStartBlock[numberOfThreads] = blocksCount;
+        BlocksWorkStealingScheduler scheduler(threadsInIteration, blocksCount, [this](uint16_t b) {
+            return sortedReadsCount[b] + sortedSuffixBlockPos[b + 1] - sortedSuffixBlockPos[b];
+        });
         uint_reads_cnt overlapsCount = 0;
-#pragma omp parallel for reduction(+:sortedSuffixesLeftCount[0:MAX_BLOCKS_COUNT]) num_threads(threadsInIteration) \
+#pragma omp parallel reduction(+:sortedSuffixesLeftCount[0:blocksCount]) num_threads(threadsInIteration) \
                         reduction(+:overlapsCount)
-        for(uint8_t t = 0; t < threadsInIteration; t++)
         {
-            for (uint16_t b = threadStartBlock[t]; b < threadStartBlock[t + 1]; b++)
+            uint16_t b;
+            while (scheduler.nextBlock(omp_get_thread_num(), b))
             {
                 uchar curSymOrder = 0;
                 sortedSuffixBlockPlusSymbolPos[b][curSymOrder] = sortedSuffixBlockPos[b];
@@ -398,7 +525,7 @@ namespace PgIndex {
     blockPrefixOverlapSortedReadsAndSuffixesWithAfterSuffixMerge(uint_read_len suffixesOffset, uint16_t curBlocksCount) {
         uint_reads_cnt sortedSuffixesLeftCount[MAX_BLOCKS_COUNT] = {0};
         uint_reads_cnt overlapsCount = 0;
-#pragma omp parallel for schedule(guided) reduction(+:sortedSuffixesLeftCount[0:MAX_BLOCKS_COUNT]) reduction(+:overlapsCount)
+#pragma omp parallel for schedule(guided) reduction(+:sortedSuffixesLeftCount[0:curBlocksCount]) reduction(+:overlapsCount)
         for (uint16_t b = 0; b < curBlocksCount; b++)
         {
             uint16_t nextSuffixBlock = (b % (curBlocksCount / symbolsCount));
@@ -485,10 +612,10 @@ namespace PgIndex {
             for(uint16_t b = 1; b <= curBlocksCount / symbolsCount; b++)
                 sortedSuffixBlockPos[b] = sortedSuffixBlockPos[b - 1] + sortedSuffixesLeftCount[b - 1];
 
-            vector<uint_reads_cnt> sortedSuffixLeft(this->readsLeft, 0);
+            sortedSuffixLeftIdxs.resize(this->readsLeft);
 #pragma omp parallel for schedule(guided)
             for (uint16_t b = 0; b < curBlocksCount / symbolsCount; b++) {
-                auto leftIt = sortedSuffixLeft.begin() + sortedSuffixBlockPos[b];
+                auto leftIt = sortedSuffixLeftIdxs.begin() + sortedSuffixBlockPos[b];
                 for (uint16_t b2 = b; b2 < curBlocksCount; b2 += (curBlocksCount / symbolsCount)) {
                     auto it = sortedSuffixIdxs.begin() + sortedSuffixBlockPlusSymbolPos[b2][0];
                     const auto &endIt = sortedSuffixIdxs.begin() + sortedSuffixBlockPlusSymbolPos[b2 + 1][0];
@@ -499,7 +626,7 @@ namespace PgIndex {
                     }
                 }
             }
-            sortedSuffixIdxs.swap(sortedSuffixLeft);
+            sortedSuffixIdxs.swap(sortedSuffixLeftIdxs);
         }
     }
 
@@ -519,6 +646,8 @@ namespace PgIndex {
 
     // FACTORY
 
+    uint8_t ParallelGreedySwipingPackedOverlapPseudoGenomeGeneratorFactory::blockPrefixLength = 0;
+
     template<typename uint_read_len, typename uint_reads_cnt>
     PseudoGenomeGeneratorBase* ParallelGreedySwipingPackedOverlapPseudoGenomeGeneratorFactory::getGeneratorFullTemplate(PackedConstantLengthReadsSet* readsSet, bool ownReadsSet) {
         return new ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>(readsSet, ownReadsSet);
@@ -5,17 +5,58 @@
 #include "AbstractOverlapPseudoGenomeGenerator.h"
 #include "../../readsset/PackedConstantLengthReadsSet.h"
 #include <algorithm>
+#include <atomic>
 #include <deque>
 
-#define MAX_BLOCK_PREFIX_LENGTH 4
+#define DEFAULT_BLOCK_PREFIX_LENGTH 3
+#define MAX_BLOCK_PREFIX_LENGTH 6
 #define MAX_SYMBOLS_COUNT 5
-#define MAX_BLOCKS_COUNT 625 // MAX_SYMBOLS_COUNT^MAX_BLOCK_PREFIX_LENGTH
+#define MAX_BLOCKS_COUNT 15625 // MAX_SYMBOLS_COUNT^MAX_BLOCK_PREFIX_LENGTH
+#define MIN_BLOCKS_PER_THREAD 8
 #define PARALLEL_PG_GENERATION_READS_COUNT_THRESHOLD 50000
+#define RADIX_SORT_COMPARISON_SORT_THRESHOLD 64
+#define RADIX_SORT_PARALLEL_TASK_THRESHOLD 65536
 
 using namespace PgReadsSet;
 
 namespace PgIndex {
 
+    // blocks are split into contiguous ranges of similar weight (one range per thread);
+    // a thread that completed its range steals blocks from the ends of other threads' ranges
+    class BlocksWorkStealingScheduler {
+    private:
+        struct alignas(64) ThreadRange {
+            std::atomic<uint64_t> range; // next block (high 32 bits), end block (low 32 bits)
+        };
+
+        const int threadsCount;
+        std::unique_ptr<ThreadRange[]> ranges;
+
+        static bool takeBlock(ThreadRange &threadRange, bool fromFront, uint16_t &block);
+
+    public:
+        template<typename BlockWeightFunc>
+        BlocksWorkStealingScheduler(int threadsCount, uint16_t blocksCount, BlockWeightFunc blockWeight):
+                threadsCount(threadsCount), ranges(new ThreadRange[threadsCount]) {
+            uint64_t totalWeight = 0;
+            for (uint16_t b = 0; b < blocksCount; b++)
+                totalWeight += blockWeight(b);
+            uint16_t b = 0;
+            uint64_t weight = 0;
+            for (int t = 0; t < threadsCount; t++) {
+                const uint16_t begin = b;
+                const uint64_t threshold = t + 1 == threadsCount ? totalWeight :
+                        (uint64_t) ((double) (t + 1) / threadsCount * totalWeight);
+                while (b < blocksCount && (weight < threshold || t + 1 == threadsCount))
+                    weight += blockWeight(b++);
+                ranges[t].range.store(((uint64_t) begin << 32) | b, std::memory_order_relaxed);
+            }
+        }
+
+        // returns false if all blocks have been taken
+        bool nextBlock(int thread, uint16_t &block);
+    };
+
     template < typename uint_read_len, typename uint_reads_cnt >
     class ParallelGreedySwipingPackedOverlapGeneratorTemplate: public AbstractOverlapPseudoGenomeGeneratorTemplate<uint_read_len, uint_reads_cnt>
     {
@@ -26,11 +67,12 @@ namespace PgIndex {
         const uint_symbols_cnt symbolsCount;
 
         vector<uint_reads_cnt> sortedReadsIdxs;
-        vector<uint_reads_cnt> sortedSuffixIdxs;
+        // suffix buffers are reused between iterations (and first-touched by the worker threads)
+        vector<uint_reads_cnt, PgHelpers::DefaultInitAllocator<uint_reads_cnt>> sortedSuffixIdxs;
+        vector<uint_reads_cnt, PgHelpers::DefaultInitAllocator<uint_reads_cnt>> sortedSuffixLeftIdxs;
         const uint_reads_cnt* sortedSuffixIdxsPtr;
 
-        const uint8_t blockPrefixLength = 3;
-        char blockPrefixes[MAX_BLOCKS_COUNT][MAX_SYMBOLS_COUNT] = { 0 };
+        const uint8_t blockPrefixLength;
         uint16_t blocksCount;
 
         uint_reads_cnt sortedReadsBlockPos[MAX_BLOCKS_COUNT + 1];
@@ -39,35 +81,6 @@ namespace PgIndex {
         uint_reads_cnt sortedSuffixBlockPlusSymbolPos[MAX_BLOCKS_COUNT + 1][MAX_SYMBOLS_COUNT + 1];
         uint_reads_cnt sortedSuffixBlockPos[MAX_BLOCKS_COUNT + 1];
 
-        uint16_t threadStartBlock[UINT8_MAX + 1] = { 0 };
-
-        struct PackedReadsComparator {
-            ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>* myGenerator;
-            PackedReadsComparator(ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>* generator) : myGenerator(generator) {};
-
-            bool operator() (uint_reads_cnt lIncIdx, uint_reads_cnt rIncIdx) const {
-                return myGenerator->compareReads(lIncIdx, rIncIdx) < 0;
-            }
-        };
-
-        struct PackedReadVsPatternComparator {
-            const uint_reads_cnt PATTERN_INDEX = -1;
-
-            ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>* myGenerator;
-            char* pattern;
-            int patLength;
-            PackedReadVsPatternComparator(ParallelGreedySwipingPackedOverlapGeneratorTemplate<uint_read_len, uint_reads_cnt>* generator,
-                    char* pattern) : myGenerator(generator), pattern(pattern), patLength(strlen(pattern)) {};
-
-            bool operator() (uint_reads_cnt lIncIdx, uint_reads_cnt rIncIdx) const {
-                if (lIncIdx == PATTERN_INDEX)
-                    return myGenerator->packedReadsSet->compareReadWithPattern(rIncIdx - 1, pattern, patLength) >= 0;
-                else if (rIncIdx == PATTERN_INDEX)
-                    return myGenerator->packedReadsSet->compareReadWithPattern(lIncIdx - 1, pattern, patLength) < 0;
-                return myGenerator->compareReads(lIncIdx, rIncIdx) < 0;
-            }
-        };
-
         int compareReads(uint_reads_cnt lIncIdx, uint_reads_cnt rIncIdx);
 
         uchar getSymbolOrderFromRead(uint_reads_cnt incIdx, uint_read_len offset);
@@ -87,9 +100,13 @@ namespace PgIndex {
 
         bool isGenerationCyclesAware(bool pgGenerationMode) override { return false; };
 
+        static uint8_t selectBlockPrefixLength(uint_symbols_cnt symbolsCount, uint_read_len_max readLength);
+
         template<bool pgGenerationMode>
         void initAndFindDuplicates();
         void prepareSortedReadsBlocks();
+        void radixSortReadsBucket(uint_reads_cnt *idxs, uint_reads_cnt *tmpIdxs, uint_reads_cnt count,
+                uchar elementPos);
         void mergeSortOfLeftSuffixes(uint_read_len offset, const uint_reads_cnt *sortedSuffixesLeftCount,
                 uint_reads_cnt *sortedSuffixLeftIdxsPtr, const uint_reads_cnt *sortedSuffixIdxsPtr);
 
@@ -129,6 +146,9 @@ namespace PgIndex {
 
     public:
 
+        // number of initial symbols splitting reads into blocks processed in parallel (0 - selected automatically)
+        static uint8_t blockPrefixLength;
+
         ParallelGreedySwipingPackedOverlapPseudoGenomeGeneratorFactory() {};
 
         PseudoGenomeGeneratorBase* getGenerator(ReadsSourceIteratorTemplate<uint_read_len_max> *readsIterator) override;
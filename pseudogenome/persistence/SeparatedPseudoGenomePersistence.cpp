@@ -4,16 +4,7 @@
 #include "../SeparatedPseudoGenomeBase.h"
 #include "../../coders/PropsLibrary.h"
 #include <memory>
-
-#ifdef __APPLE__
-#define PSTLD_HEADER_ONLY
-#include "../../utils/pstld.h"
-#define parallel_algorithm pstld
-#else
-#include <parallel/algorithm>
-#define parallel_algorithm __gnu_parallel
-#endif
-
+#include <limits>
 #include <cassert>
 
 namespace PgTools {
@@ -217,6 +208,120 @@ namespace PgTools {
         *logout << "... dumping pairs completed in " << time_millis() << " msec. " << endl;
     }
 
+    // state of coding pair relative offsets (exceeding the offsets range) as deltas to the reference offset
+    template <typename int_delta>
+    struct PairOffsetDeltaCodingState {
+        int64_t refPrev = 0;
+        int64_t prev = 0;
+        bool match = false;
+
+        PairOffsetDeltaCodingState() = default;
+
+        PairOffsetDeltaCodingState(int64_t refPrev, int64_t prev, bool match)
+                : refPrev(refPrev), prev(prev), match(match) { }
+
+        bool isDeltaInRange(int64_t pairRelativeOffset) const {
+            const int64_t delta = pairRelativeOffset - refPrev;
+            return delta <= numeric_limits<int_delta>::max() && delta >= numeric_limits<int_delta>::min();
+        }
+
+        void update(int64_t pairRelativeOffset, bool isDeltaInRange) {
+            if (isDeltaInRange) {
+                match = true;
+                refPrev = pairRelativeOffset;
+            } else {
+                if (!match || refPrev != prev)
+                    refPrev = pairRelativeOffset;
+                match = false;
+            }
+            prev = pairRelativeOffset;
+        }
+    };
+
+    // Each state reachable at a chunk boundary is determined by one of the three cases below
+    // and the last two offsets (p1 and p2) preceding the boundary.
+    enum PairOffsetDeltaCodingCase {
+        AFTER_MATCH, // refPrev == prev == p1; match
+        REF_LAST, // refPrev == prev == p1; !match
+        REF_SECOND_LAST, // refPrev == p2, prev == p1; !match
+        PAIR_OFFSET_DELTA_CODING_CASES_COUNT
+    };
+
+    // delta coding state at the beginning of a chunk of pairs coded in parallel
+    struct PairOffsetDeltaCodingBoundary {
+        int64_t p1 = 0;
+        int64_t p2 = 0;
+        uint8_t beginCase = REF_LAST;
+        uint8_t endCase[PAIR_OFFSET_DELTA_CODING_CASES_COUNT];
+        size_t deltasCount[PAIR_OFFSET_DELTA_CODING_CASES_COUNT];
+
+        template <typename int_delta>
+        PairOffsetDeltaCodingState<int_delta> getState(uint8_t codingCase) const {
+            switch (codingCase) {
+                case AFTER_MATCH: return PairOffsetDeltaCodingState<int_delta>(p1, p1, true);
+                case REF_LAST: return PairOffsetDeltaCodingState<int_delta>(p1, p1, false);
+                default: return PairOffsetDeltaCodingState<int_delta>(p2, p1, false);
+            }
+        }
+    };
+
+    // resolves begin cases and numbers of coded deltas of all chunks
+    // (nonOffsets(c) returns offsets exceeding the offsets range in the chunk c)
+    template <typename int_delta, typename NonOffsetsGetter>
+    void resolvePairOffsetDeltaCodingBoundaries(vector<PairOffsetDeltaCodingBoundary> &boundaries,
+            NonOffsetsGetter nonOffsets) {
+        const size_t chunksCount = boundaries.size();
+        // last (backIdx = 0) or second last (backIdx = 1) non-offset value up to the end of the chunk
+        auto getLast = [&](size_t c, size_t backIdx) -> int64_t {
+            const size_t count = nonOffsets(c).size();
+            if (count > backIdx)
+                return nonOffsets(c)[count - 1 - backIdx];
+            return backIdx - count ? boundaries[c].p2 : boundaries[c].p1;
+        };
+        for (size_t c = 1; c < chunksCount; c++) {
+            boundaries[c].p1 = getLast(c - 1, 0);
+            boundaries[c].p2 = getLast(c - 1, 1);
+        }
+        #pragma omp parallel for schedule(dynamic) num_threads(numberOfThreads)
+        for (size_t c = 0; c < chunksCount; c++) {
+            PairOffsetDeltaCodingBoundary &boundary = boundaries[c];
+            const int64_t last = getLast(c, 0);
+            for (uint8_t codingCase = 0; codingCase < PAIR_OFFSET_DELTA_CODING_CASES_COUNT; codingCase++) {
+                if (c == 0 && codingCase != boundary.beginCase)
+                    continue;
+                PairOffsetDeltaCodingState<int_delta> state = boundary.getState<int_delta>(codingCase);
+                size_t deltasCount = 0;
+                for (const auto pairRelativeOffset : nonOffsets(c)) {
+                    const bool isDeltaInRange = state.isDeltaInRange(pairRelativeOffset);
+                    deltasCount += isDeltaInRange;
+                    state.update(pairRelativeOffset, isDeltaInRange);
+                }
+                boundary.deltasCount[codingCase] = deltasCount;
+                boundary.endCase[codingCase] = state.match ? AFTER_MATCH :
+                        (state.refPrev == last ? REF_LAST : REF_SECOND_LAST);
+            }
+        }
+        for (size_t c = 1; c < chunksCount; c++)
+            boundaries[c].beginCase = boundaries[c - 1].endCase[boundaries[c - 1].beginCase];
+    }
+
+    const static uint_reads_cnt_std MIN_PAIR_CODING_CHUNK_LENGTH = 1 << 16;
+    const static int PAIR_CODING_CHUNKS_PER_THREAD = 4;
+
+    uint_reads_cnt_std getPairCodingChunksCount(uint_reads_cnt_std length) {
+        return std::max<uint_reads_cnt_std>(1, std::min<uint_reads_cnt_std>(length / MIN_PAIR_CODING_CHUNK_LENGTH,
+                numberOfThreads * PAIR_CODING_CHUNKS_PER_THREAD));
+    }
+
+    struct PairReadsOrderChunk {
+        vector<uint8_t> offsetInUint8Flag;
+        vector<uint8_t> offsetInUint8Value;
+        vector<uint8_t> offsetPairBaseFileFlag;
+        vector<uint8_t> nonOffsetPairBaseFileFlag;
+        vector<uint_reads_cnt_std> nonOffset;
+        vector<uint_reads_cnt_std> basePairIdx;
+    };
+
     void SeparatedPseudoGenomePersistence::compressReadsOrder(ostream &pgrcOut,
             const vector<uint_reads_cnt_std>& orgIdxs, uint8_t coder_level,
             bool completeOrderInfo, bool ignorePairOrderInformation, bool singleFileMode) {
@@ -224,6 +329,7 @@ namespace PgTools {
         uint_reads_cnt_std readsCount = orgIdxs.size();
         int lzma_reads_dataperiod_param = readsCount <= UINT32_MAX ? LZMA_DATAPERIODCODE_32_t : LZMA_DATAPERIODCODE_64_t;
         vector<uint_reads_cnt_std> rev(readsCount);
+        #pragma omp parallel for num_threads(numberOfThreads)
         for (uint_reads_cnt_std i = 0; i < readsCount; i++)
             rev[orgIdxs[i]] = i;
         if (completeOrderInfo && singleFileMode) {
@@ -232,68 +338,105 @@ namespace PgTools {
             writeCompressed(pgrcOut, (char *) rev.data(), rev.size() * sizeof(uint_reads_cnt_std),
                     revIdxCoderProps.get());
         } else {
-            // absolute pair base index of original pair
+            const bool fileFlagsMode = !completeOrderInfo && !ignorePairOrderInformation;
+            const uint_reads_cnt_std chunksCount = getPairCodingChunksCount(readsCount);
+            const uint64_t chunkLength = ((uint64_t) readsCount + chunksCount - 1) / chunksCount;
+            vector<PairReadsOrderChunk> chunks(chunksCount);
+            // absolute pair base index of original pair (chunk relative until the chunks are joined)
             vector<uint_reads_cnt_std> revPairBaseOrgIdx;
             if (completeOrderInfo)
                 revPairBaseOrgIdx.resize(readsCount / 2);
+
+            // pair bases (reads preceding their pairs in the reads list) are coded in the reads list order
+            #pragma omp parallel for schedule(dynamic) num_threads(numberOfThreads)
+            for (uint_reads_cnt_std c = 0; c < chunksCount; c++) {
+                PairReadsOrderChunk &chunk = chunks[c];
+                const uint_reads_cnt_std begin = std::min<uint64_t>(c * chunkLength, readsCount);
+                const uint_reads_cnt_std end = std::min<uint64_t>(begin + chunkLength, readsCount);
+                chunk.offsetInUint8Flag.reserve((end - begin) / 2);
+                chunk.offsetInUint8Value.reserve((end - begin) / 2); // estimated
+                if (fileFlagsMode)
+                    chunk.offsetPairBaseFileFlag.reserve((end - begin) / 2); // estimated
+                for (uint_reads_cnt_std i1 = begin; i1 < end; i1++) {
+                    uint_reads_cnt_std orgIdx = orgIdxs[i1];
+                    uint_reads_cnt_std pairOrgIdx = orgIdx % 2 ? (orgIdx - 1) : (orgIdx + 1);
+                    uint_reads_cnt_std i2 = rev[pairOrgIdx];
+                    if (i2 < i1)
+                        continue;
+                    if (completeOrderInfo) {
+                        revPairBaseOrgIdx[orgIdx / 2] = chunk.offsetInUint8Flag.size() * 2 + orgIdx % 2;
+                        chunk.basePairIdx.push_back(orgIdx / 2);
+                    }
+                    uint_reads_cnt_std pairRelativeOffset = i2 - i1;
+                    chunk.offsetInUint8Flag.push_back((uint8_t) (pairRelativeOffset <= UINT8_MAX));
+                    if (pairRelativeOffset <= UINT8_MAX) {
+                        chunk.offsetInUint8Value.push_back((uint8_t) pairRelativeOffset);
+                        if (fileFlagsMode)
+                            chunk.offsetPairBaseFileFlag.push_back(orgIdx % 2);
+                        continue;
+                    }
+                    if (fileFlagsMode)
+                        chunk.nonOffsetPairBaseFileFlag.push_back(orgIdx % 2);
+                    chunk.nonOffset.push_back(pairRelativeOffset);
+                }
+            }
+            vector<PairOffsetDeltaCodingBoundary> boundaries(chunksCount);
+            resolvePairOffsetDeltaCodingBoundaries<int8_t>(boundaries,
+                    [&](size_t c) -> const vector<uint_reads_cnt_std>& { return chunks[c].nonOffset; });
+            vector<size_t> basesPos(chunksCount + 1, 0), offsetsPos(chunksCount + 1, 0),
+                    nonOffsetsPos(chunksCount + 1, 0), deltasPos(chunksCount + 1, 0);
+            for (uint_reads_cnt_std c = 0; c < chunksCount; c++) {
+                PairReadsOrderChunk &chunk = chunks[c];
+                basesPos[c + 1] = basesPos[c] + chunk.offsetInUint8Flag.size();
+                offsetsPos[c + 1] = offsetsPos[c] + chunk.offsetInUint8Value.size();
+                nonOffsetsPos[c + 1] = nonOffsetsPos[c] + chunk.nonOffset.size();
+                deltasPos[c + 1] = deltasPos[c] + boundaries[c].deltasCount[boundaries[c].beginCase];
+            }
+
+            // coding reads list index relative offset of paired read
+            vector<uint8_t> offsetInUint8Flag(basesPos[chunksCount]);
+            vector<uint8_t> offsetInUint8Value(offsetsPos[chunksCount]);
+            vector<uint8_t> deltaInInt8Flag(nonOffsetsPos[chunksCount]);
+            vector<int8_t> deltaInInt8Value(deltasPos[chunksCount]);
+            vector<uint_reads_cnt_std> fullOffset(nonOffsetsPos[chunksCount] - deltasPos[chunksCount]);
             // flag indicating a processed pair base file (0 - Second, 1 - First)
             vector<uint8_t> offsetPairBaseFileFlag;
             vector<uint8_t> nonOffsetPairBaseFileFlag;
-            if (!ignorePairOrderInformation) {
-                offsetPairBaseFileFlag.reserve(readsCount / 2);
-                nonOffsetPairBaseFileFlag.reserve(readsCount / 4);
+            if (fileFlagsMode) {
+                offsetPairBaseFileFlag.resize(offsetsPos[chunksCount]);
+                nonOffsetPairBaseFileFlag.resize(nonOffsetsPos[chunksCount]);
             }
-
-            // coding reads list index relative offset of paired read
-            vector<uint8_t> offsetInUint8Flag;
-            offsetInUint8Flag.reserve(readsCount / 2);
-            vector<uint8_t> offsetInUint8Value;
-            offsetInUint8Value.reserve(readsCount / 2); // estimated
-            vector<uint8_t> deltaInInt8Flag;
-            deltaInInt8Flag.reserve(readsCount / 4); // estimated
-            vector<int8_t> deltaInInt8Value;
-            deltaInInt8Value.reserve(readsCount / 16); // estimated
-            vector<uint_reads_cnt_std> fullOffset;
-            deltaInInt8Value.reserve(readsCount / 8); // estimated
-
-            vector<bool> isReadDone(readsCount, false);
-            int64_t refPrev = 0;
-            int64_t prev = 0;
-            bool match = false;
-            for (uint32_t i1 = 0; i1 < readsCount; i1++) {
-                if (isReadDone[i1])
-                    continue;
-                uint_reads_cnt_std orgIdx = orgIdxs[i1];
-                uint_reads_cnt_std pairOrgIdx = orgIdx % 2 ? (orgIdx - 1) : (orgIdx + 1);
-                uint_reads_cnt_std i2 = rev[pairOrgIdx]; // i2 > i1
-                isReadDone[i2] = true;
-                if (completeOrderInfo)
-                    revPairBaseOrgIdx[orgIdx / 2] = offsetInUint8Flag.size() * 2 + orgIdx % 2;
-                int64_t pairRelativeOffset = i2 - i1;
-                offsetInUint8Flag.push_back((uint8_t) (pairRelativeOffset <= UINT8_MAX));
-                if (pairRelativeOffset <= UINT8_MAX) {
-                    offsetInUint8Value.push_back((uint8_t) pairRelativeOffset);
-                    if (!completeOrderInfo && !ignorePairOrderInformation)
-                        offsetPairBaseFileFlag.push_back(orgIdx % 2);
-                    continue;
+            #pragma omp parallel for schedule(dynamic) num_threads(numberOfThreads)
+            for (uint_reads_cnt_std c = 0; c < chunksCount; c++) {
+                PairReadsOrderChunk &chunk = chunks[c];
+                std::copy(chunk.offsetInUint8Flag.begin(), chunk.offsetInUint8Flag.end(),
+                          offsetInUint8Flag.begin() + basesPos[c]);
+                std::copy(chunk.offsetInUint8Value.begin(), chunk.offsetInUint8Value.end(),
+                          offsetInUint8Value.begin() + offsetsPos[c]);
+                if (fileFlagsMode) {
+                    std::copy(chunk.offsetPairBaseFileFlag.begin(), chunk.offsetPairBaseFileFlag.end(),
+                              offsetPairBaseFileFlag.begin() + offsetsPos[c]);
+                    std::copy(chunk.nonOffsetPairBaseFileFlag.begin(), chunk.nonOffsetPairBaseFileFlag.end(),
+                              nonOffsetPairBaseFileFlag.begin() + nonOffsetsPos[c]);
                 }
-                if (!completeOrderInfo && !ignorePairOrderInformation)
-                    nonOffsetPairBaseFileFlag.push_back(orgIdx % 2);
-                const int64_t delta = pairRelativeOffset - refPrev;
-                const bool isDeltaInInt8 = delta <= INT8_MAX && delta >= INT8_MIN;
-                deltaInInt8Flag.push_back((uint8_t) isDeltaInInt8);
-                if (isDeltaInInt8) {
-                    match = true;
-                    deltaInInt8Value.push_back((int8_t) delta);
-                    refPrev = pairRelativeOffset;
-                } else {
-                    if (!match || refPrev != prev)
-                        refPrev = pairRelativeOffset;
-                    fullOffset.push_back(pairRelativeOffset);
-                    match = false;
+                for (const uint_reads_cnt_std pairIdx : chunk.basePairIdx)
+                    revPairBaseOrgIdx[pairIdx] += basesPos[c] * 2;
+                PairOffsetDeltaCodingState<int8_t> state = boundaries[c].getState<int8_t>(boundaries[c].beginCase);
+                uint8_t* deltaFlagPtr = deltaInInt8Flag.data() + nonOffsetsPos[c];
+                int8_t* deltaValuePtr = deltaInInt8Value.data() + deltasPos[c];
+                uint_reads_cnt_std* fullOffsetPtr = fullOffset.data() + (nonOffsetsPos[c] - deltasPos[c]);
+                for (const uint_reads_cnt_std pairRelativeOffset : chunk.nonOffset) {
+                    const bool isDeltaInInt8 = state.isDeltaInRange(pairRelativeOffset);
+                    *(deltaFlagPtr++) = (uint8_t) isDeltaInInt8;
+                    if (isDeltaInInt8)
+                        *(deltaValuePtr++) = (int8_t) (pairRelativeOffset - state.refPrev);
+                    else
+                        *(fullOffsetPtr++) = pairRelativeOffset;
+                    state.update(pairRelativeOffset, isDeltaInInt8);
                 }
-                prev = pairRelativeOffset;
+                chunk = PairReadsOrderChunk();
             }
+            *logout << "... preparing pair order streams checkpoint: " << time_millis() << " msec. " << endl;
             vector<CompressionJob> cJobs;
             auto rlRelOffFlagCoderProps = getDefaultCoderProps(PPMD7_CODER, coder_level, 11);
             cJobs.emplace_back("Uint8 reads list relative offsets of pair reads (flag)... ",
@@ -442,9 +585,18 @@ namespace PgTools {
         }
     }
 
+    template <typename uint_pg_len>
+    struct PairPositionsChunk {
+        vector<uint8_t> offsetIsBaseFirstFlag;
+        vector<uint16_t> offsetInUint16Value;
+        vector<uint8_t> nonOffsetIsBaseFirstFlag;
+        vector<uint_pg_len> nonOffset;
+        vector<uint_pg_len> nonOffsetPairPos;
+    };
+
     template <typename uint_pg_len>
     void SeparatedPseudoGenomePersistence::compressReadsPgPositions(ostream &pgrcOut,
-            vector<uint_pg_len_max> orgIdx2PgPos, uint_pg_len_max joinedPgLength, uint8_t coder_level,
+            vector<uint_pg_len_max> &orgIdx2PgPos, uint_pg_len_max joinedPgLength, uint8_t coder_level,
             bool singleFileMode, bool deltaPairEncodingEnabled) {
         time_checkpoint();
         uint_reads_cnt_std readsTotalCount = orgIdx2PgPos.size();
@@ -460,74 +612,99 @@ namespace PgTools {
             auto readsPgPosProps = getReadsPositionsCoderProps(coder_level, lzma_pos_dataperiod_param);
             writeCompressed(pgrcOut, (char*) maxPgPosPtr, readsTotalCount * sizeof(uint_pg_len),
                             readsPgPosProps.get(), estimated_pos_ratio);
+            vector<uint_pg_len_max>().swap(orgIdx2PgPos);
         } else {
-            vector<uint_pg_len> basePairPos;
-            // pair relative offset info
-            vector<uint8_t> offsetInUint16Flag;
-            vector<uint8_t> offsetIsBaseFirstFlag;
-            vector<uint16_t> offsetInUint16Value;
-            vector<uint8_t> deltaInInt16Flag;
-            vector<uint8_t> deltaIsBaseFirstFlag;
-            vector<int16_t> deltaInInt16Value;
-            vector<uint_pg_len> notBasePairPos;
             const uint_reads_cnt_std pairsCount = readsTotalCount / 2;
-            basePairPos.reserve(pairsCount);
-            offsetInUint16Flag.reserve(pairsCount);
-            offsetIsBaseFirstFlag.reserve(pairsCount);
-            offsetInUint16Value.reserve(pairsCount);
-            if (deltaPairEncodingEnabled) {
-                deltaInInt16Flag.reserve(pairsCount / 2);
-                deltaIsBaseFirstFlag.reserve(pairsCount / 8);
-                deltaInInt16Value.reserve(pairsCount / 8);
-            }
-            notBasePairPos.reserve(pairsCount / 4);
-
+            vector<uint_pg_len> basePairPos(pairsCount);
+            #pragma omp parallel for num_threads(numberOfThreads)
+            for (uint_reads_cnt_std p = 0; p < pairsCount; p++)
+                basePairPos[p] = orgIdx2PgPos[p * 2];
             vector<uint_reads_cnt_std> bppRank;
-            bppRank.reserve(pairsCount);
-            for (uint_reads_cnt_std i = 0; i < readsTotalCount; i += 2) {
-                basePairPos.push_back(orgIdx2PgPos[i]);
-                bppRank.push_back(i >> 1);
-            }
-            parallel_algorithm::stable_sort(bppRank.begin(), bppRank.end(),
-                    [&](const uint_reads_cnt_std &idx1, const uint_reads_cnt_std &idx2) -> bool
-                        { return basePairPos[idx1] < basePairPos[idx2]; });
+            radixSortIndexesByKeys(basePairPos.data(), pairsCount, bppRank);
             *logout << "... reordering bases checkpoint: " << time_millis() << " msec. " << endl;
-            int64_t refPrev = 0;
-            int64_t prev = 0;
-            bool match = false;
-            for (uint_reads_cnt_std p = 0; p < pairsCount; p++) {
-                uint_reads_cnt_std i = bppRank[p] * 2;
-
-                bool isBaseBefore = orgIdx2PgPos[i] < orgIdx2PgPos[i + 1];
-                uint_pg_len relativeAbsOffset = isBaseBefore?(orgIdx2PgPos[i + 1] - orgIdx2PgPos[i]):
-                                    orgIdx2PgPos[i] - orgIdx2PgPos[i + 1];
-                const bool isOffsetInUint16 = relativeAbsOffset <= UINT16_MAX;
-                offsetInUint16Flag.push_back(isOffsetInUint16 ? 1 : 0);
-                if (isOffsetInUint16) {
-                    offsetIsBaseFirstFlag.push_back(isBaseBefore?1:0);
-                    offsetInUint16Value.push_back((uint16_t) relativeAbsOffset);
+
+            // pair relative offset info
+            const uint_reads_cnt_std chunksCount = getPairCodingChunksCount(pairsCount);
+            const uint64_t chunkLength = ((uint64_t) pairsCount + chunksCount - 1) / chunksCount;
+            vector<PairPositionsChunk<uint_pg_len>> chunks(chunksCount);
+            vector<uint8_t> offsetInUint16Flag(pairsCount);
+            #pragma omp parallel for schedule(dynamic) num_threads(numberOfThreads)
+            for (uint_reads_cnt_std c = 0; c < chunksCount; c++) {
+                PairPositionsChunk<uint_pg_len> &chunk = chunks[c];
+                const uint_reads_cnt_std begin = std::min<uint64_t>(c * chunkLength, pairsCount);
+                const uint_reads_cnt_std end = std::min<uint64_t>(begin + chunkLength, pairsCount);
+                chunk.offsetIsBaseFirstFlag.reserve(end - begin);
+                chunk.offsetInUint16Value.reserve(end - begin);
+                for (uint_reads_cnt_std p = begin; p < end; p++) {
+                    uint_reads_cnt_std i = bppRank[p] * 2;
+
+                    bool isBaseBefore = orgIdx2PgPos[i] < orgIdx2PgPos[i + 1];
+                    uint_pg_len relativeAbsOffset = isBaseBefore?(orgIdx2PgPos[i + 1] - orgIdx2PgPos[i]):
+                                        orgIdx2PgPos[i] - orgIdx2PgPos[i + 1];
+                    const bool isOffsetInUint16 = relativeAbsOffset <= UINT16_MAX;
+                    offsetInUint16Flag[p] = isOffsetInUint16 ? 1 : 0;
+                    if (isOffsetInUint16) {
+                        chunk.offsetIsBaseFirstFlag.push_back(isBaseBefore?1:0);
+                        chunk.offsetInUint16Value.push_back((uint16_t) relativeAbsOffset);
+                        continue;
+                    }
+                    chunk.nonOffsetIsBaseFirstFlag.push_back(isBaseBefore?1:0);
+                    chunk.nonOffset.push_back(relativeAbsOffset);
+                    chunk.nonOffsetPairPos.push_back((uint_pg_len) orgIdx2PgPos[i + 1]);
+                }
+            }
+            vector<uint_reads_cnt_std>().swap(bppRank);
+            vector<uint_pg_len_max>().swap(orgIdx2PgPos);
+            vector<PairOffsetDeltaCodingBoundary> boundaries(chunksCount);
+            if (deltaPairEncodingEnabled)
+                resolvePairOffsetDeltaCodingBoundaries<int16_t>(boundaries,
+                        [&](size_t c) -> const vector<uint_pg_len>& { return chunks[c].nonOffset; });
+            vector<size_t> offsetsPos(chunksCount + 1, 0), nonOffsetsPos(chunksCount + 1, 0),
+                    deltasPos(chunksCount + 1, 0);
+            for (uint_reads_cnt_std c = 0; c < chunksCount; c++) {
+                offsetsPos[c + 1] = offsetsPos[c] + chunks[c].offsetInUint16Value.size();
+                nonOffsetsPos[c + 1] = nonOffsetsPos[c] + chunks[c].nonOffset.size();
+                deltasPos[c + 1] = deltasPos[c] +
+                        (deltaPairEncodingEnabled ? boundaries[c].deltasCount[boundaries[c].beginCase] : 0);
+            }
+
+            vector<uint8_t> offsetIsBaseFirstFlag(offsetsPos[chunksCount]);
+            vector<uint16_t> offsetInUint16Value(offsetsPos[chunksCount]);
+            vector<uint8_t> deltaInInt16Flag(deltaPairEncodingEnabled ? nonOffsetsPos[chunksCount] : 0);
+            vector<uint8_t> deltaIsBaseFirstFlag(deltasPos[chunksCount]);
+            vector<int16_t> deltaInInt16Value(deltasPos[chunksCount]);
+            vector<uint_pg_len> notBasePairPos(nonOffsetsPos[chunksCount] - deltasPos[chunksCount]);
+            #pragma omp parallel for schedule(dynamic) num_threads(numberOfThreads)
+            for (uint_reads_cnt_std c = 0; c < chunksCount; c++) {
+                PairPositionsChunk<uint_pg_len> &chunk = chunks[c];
+                std::copy(chunk.offsetIsBaseFirstFlag.begin(), chunk.offsetIsBaseFirstFlag.end(),
+                          offsetIsBaseFirstFlag.begin() + offsetsPos[c]);
+                std::copy(chunk.offsetInUint16Value.begin(), chunk.offsetInUint16Value.end(),
+                          offsetInUint16Value.begin() + offsetsPos[c]);
+                uint_pg_len* notBasePairPosPtr = notBasePairPos.data() + (nonOffsetsPos[c] - deltasPos[c]);
+                if (!deltaPairEncodingEnabled) {
+                    std::copy(chunk.nonOffsetPairPos.begin(), chunk.nonOffsetPairPos.end(), notBasePairPosPtr);
+                    chunk = PairPositionsChunk<uint_pg_len>();
                     continue;
                 }
-                if (deltaPairEncodingEnabled) {
-                    const int64_t delta = relativeAbsOffset - refPrev;
-                    const bool isDeltaInInt16 = delta <= INT16_MAX && delta >= INT16_MIN;
-                    deltaInInt16Flag.push_back((uint8_t) isDeltaInInt16);
+                PairOffsetDeltaCodingState<int16_t> state = boundaries[c].getState<int16_t>(boundaries[c].beginCase);
+                uint8_t* deltaFlagPtr = deltaInInt16Flag.data() + nonOffsetsPos[c];
+                uint8_t* deltaIsBaseFirstFlagPtr = deltaIsBaseFirstFlag.data() + deltasPos[c];
+                int16_t* deltaValuePtr = deltaInInt16Value.data() + deltasPos[c];
+                for (size_t j = 0; j < chunk.nonOffset.size(); j++) {
+                    const uint_pg_len relativeAbsOffset = chunk.nonOffset[j];
+                    const bool isDeltaInInt16 = state.isDeltaInRange(relativeAbsOffset);
+                    *(deltaFlagPtr++) = (uint8_t) isDeltaInInt16;
                     if (isDeltaInInt16) {
-                        match = true;
-                        deltaIsBaseFirstFlag.push_back(isBaseBefore ? 1 : 0);
-                        deltaInInt16Value.push_back((int16_t) delta);
-                        refPrev = relativeAbsOffset;
-                    } else {
-                        if (!match || refPrev != prev)
-                            refPrev = relativeAbsOffset;
-                        notBasePairPos.push_back((uint_pg_len) orgIdx2PgPos[i + 1]);
-                        match = false;
-                    }
-                    prev = relativeAbsOffset;
-                } else {
-                    notBasePairPos.push_back((uint_pg_len) orgIdx2PgPos[i + 1]);
+                        *(deltaIsBaseFirstFlagPtr++) = chunk.nonOffsetIsBaseFirstFlag[j];
+                        *(deltaValuePtr++) = (int16_t) (relativeAbsOffset - state.refPrev);
+                    } else
+                        *(notBasePairPosPtr++) = chunk.nonOffsetPairPos[j];
+                    state.update(relativeAbsOffset, isDeltaInInt16);
                 }
+                chunk = PairPositionsChunk<uint_pg_len>();
             }
+            *logout << "... preparing pair positions streams checkpoint: " << time_millis() << " msec. " << endl;
             assert(deltaPairEncodingEnabled);
             vector<CompressionJob> cJobs;
             auto basePosProps = getReadsPositionsCoderProps(coder_level, lzma_pos_dataperiod_param);
@@ -551,7 +728,8 @@ namespace PgTools {
                             selPairRelOffValCoderProps.get());
             auto pairRelOffDeltaFlagProps = getDefaultCoderProps(PPMD7_CODER, coder_level, 10);
             auto pairRelOffDeltaPosFlagProps = getDefaultCoderProps(PPMD7_CODER, coder_level, 5);
-            auto pairRelOffDeltaValProps = getDefaultCoderProps(PPMD7_CODER, CODER_LEVEL_MAX, 3);
+            auto pairRelOffDeltaValProps = getDefaultCoderProps(PPMD7_CODER,
+                    coder_level == CODER_LEVEL_FAST ? CODER_LEVEL_FAST : CODER_LEVEL_MAX, 3);
             if (deltaPairEncodingEnabled) {
                 cJobs.emplace_back("Relative offset deltas of pair positions (flag)... ",
                                    (unsigned char *) deltaInInt16Flag.data(), deltaInInt16Flag.size() * sizeof(uint8_t),
@@ -573,12 +751,176 @@ namespace PgTools {
         *logout << endl;
     }
     template void SeparatedPseudoGenomePersistence::compressReadsPgPositions<uint_pg_len_std>(ostream &pgrcOut,
-            vector<uint_pg_len_max> orgIdx2PgPos, uint_pg_len_max joinedPgLength, uint8_t coder_level,
+            vector<uint_pg_len_max> &orgIdx2PgPos, uint_pg_len_max joinedPgLength, uint8_t coder_level,
             bool singleFileMode, bool deltaPairEncodingEnabled);
     template void SeparatedPseudoGenomePersistence::compressReadsPgPositions<uint_pg_len_max>(ostream &pgrcOut,
-            vector<uint_pg_len_max> orgIdx2PgPos, uint_pg_len_max joinedPgLength, uint8_t coder_level,
+            vector<uint_pg_len_max> &orgIdx2PgPos, uint_pg_len_max joinedPgLength, uint8_t coder_level,
             bool singleFileMode, bool deltaPairEncodingEnabled);
 
+    template <typename uint_pg_len>
+    void SeparatedPseudoGenomePersistence::compressReadsPgPositionsInBlocks(ostream &pgrcOut,
+            vector<uint_pg_len_max> &orgIdx2PgPos, ExtendedReadsListWithConstantAccessOption *hqRl,
+            uint_pg_len_max hqPgLength, uint_pg_len_max joinedPgLength, uint32_t readsPerBlock, uint8_t coder_level,
+            bool singleFileMode) {
+        time_checkpoint();
+        const uint8_t parts = singleFileMode ? 1 : 2;
+        const uint64_t partReadsCount = orgIdx2PgPos.size() / parts;
+        const uint64_t blocksCount = (partReadsCount + readsPerBlock - 1) / readsPerBlock;
+        // HQ reads list is ordered by parts (interleaved indexes of reads are 2 * pair + part)
+        vector<uint64_t> hqRlBegin((blocksCount + 1) * parts, 0);
+        uint64_t hqRlIdx = 0;
+        for (uint8_t p = 0; p < parts; p++) {
+            for (uint64_t b = 0; b < blocksCount; b++) {
+                hqRlBegin[b * parts + p] = hqRlIdx;
+                const uint64_t end = std::min<uint64_t>((b + 1) * readsPerBlock, partReadsCount);
+                for (uint64_t i = b * readsPerBlock; i < end; i++)
+                    hqRlIdx += orgIdx2PgPos[i * parts + p] < hqPgLength;
+            }
+            hqRlBegin[blocksCount * parts + p] = hqRlIdx;
+        }
+        if (hqRlIdx != hqRl->revComp.size() || hqRlIdx != hqRl->misCnt.size()) {
+            fprintf(stderr, "Error during compression: HQ reads list inconsistent with reads positions.\n");
+            exit(EXIT_FAILURE);
+        }
+        vector<uint64_t> misCumCount(hqRl->misCnt.size() + 1, 0);
+        for (size_t i = 0; i < hqRl->misCnt.size(); i++)
+            misCumCount[i + 1] = misCumCount[i] + hqRl->misCnt[i];
+
+        vector<string> pgPosBlocks(blocksCount), hqRlBlocks(blocksCount);
+        #pragma omp parallel for schedule(dynamic) num_threads(numberOfThreads)
+        for (uint64_t b = 0; b < blocksCount; b++) {
+            const uint64_t begin = b * readsPerBlock;
+            const uint64_t end = std::min<uint64_t>(begin + readsPerBlock, partReadsCount);
+            string &pgPosBlock = pgPosBlocks[b];
+            pgPosBlock.resize((end - begin) * parts * sizeof(uint_pg_len));
+            uint_pg_len* posPtr = (uint_pg_len*) pgPosBlock.data();
+            for (uint8_t p = 0; p < parts; p++) {
+                for (uint64_t i = begin; i < end; i++) {
+                    uint_pg_len pos = orgIdx2PgPos[i * parts + p];
+                    *(posPtr++) = p ? (uint_pg_len) (pos - (uint_pg_len) orgIdx2PgPos[i * parts]) : pos;
+                }
+            }
+            string revComp, misCnt, misSym, misOff;
+            for (uint8_t p = 0; p < parts; p++) {
+                const uint64_t rlBegin = hqRlBegin[b * parts + p];
+                const uint64_t rlEnd = hqRlBegin[(b + 1) * parts + p];
+                revComp.append(hqRl->revComp.begin() + rlBegin, hqRl->revComp.begin() + rlEnd);
+                misCnt.append(hqRl->misCnt.begin() + rlBegin, hqRl->misCnt.begin() + rlEnd);
+                if (!hqRl->misSymCode.empty()) {
+                    misSym.append(hqRl->misSymCode.begin() + misCumCount[rlBegin],
+                                  hqRl->misSymCode.begin() + misCumCount[rlEnd]);
+                    misOff.append(hqRl->misOff.begin() + misCumCount[rlBegin],
+                                  hqRl->misOff.begin() + misCumCount[rlEnd]);
+                }
+            }
+            hqRlBlocks[b] = revComp + misCnt + misSym + misOff;
+        }
+        vector<uint_pg_len_max>().swap(orgIdx2PgPos);
+        hqRl->revComp.clear();
+        hqRl->misCnt.clear();
+        hqRl->misSymCode.clear();
+        hqRl->misOff.clear();
+        *logout << "... preparing reads blocks checkpoint: " << time_millis() << " msec. " << endl;
+
+        ostringstream blocksPropsOut;
+        PgHelpers::writeValue<uint32_t>(blocksPropsOut, readsPerBlock);
+        string blocksProps = blocksPropsOut.str();
+        vector<CompressionJob> cJobs;
+        auto fseCoderProps = getDefaultFSECoderProps();
+        cJobs.emplace_back("Reads blocks props... ", blocksProps, fseCoderProps.get());
+        int lzma_pos_dataperiod_param = sizeof(uint_pg_len) == 4 ? LZMA_DATAPERIODCODE_32_t : LZMA_DATAPERIODCODE_64_t;
+        double estimated_pos_ratio = simpleUintCompressionEstimate(joinedPgLength, sizeof(uint_pg_len) == 4?UINT32_MAX:UINT64_MAX);
+        // props are modified during compression (separate props for each block)
+        vector<unique_ptr<CoderProps>> pgPosCoderProps(blocksCount), hqRlCoderProps(blocksCount);
+        for (uint64_t b = 0; b < blocksCount; b++) {
+            pgPosCoderProps[b] = getReadsPositionsCoderProps(coder_level, lzma_pos_dataperiod_param);
+            hqRlCoderProps[b] = getDefaultCoderProps(PPMD7_CODER, coder_level, 3);
+            cJobs.emplace_back("Reads block " + to_string(b) + " positions... ", pgPosBlocks[b],
+                               pgPosCoderProps[b].get(), estimated_pos_ratio);
+            cJobs.emplace_back("HQ reads list... ", hqRlBlocks[b], hqRlCoderProps[b].get());
+        }
+        CompressionJob::writeCompressedCollectiveParallel(pgrcOut, cJobs);
+        *logout << "... compressing reads blocks (" << blocksCount << ") completed in " << time_millis() << " msec. " << endl;
+        *logout << endl;
+    }
+    template void SeparatedPseudoGenomePersistence::compressReadsPgPositionsInBlocks<uint_pg_len_std>(ostream &pgrcOut,
+            vector<uint_pg_len_max> &orgIdx2PgPos, ExtendedReadsListWithConstantAccessOption *hqRl,
+            uint_pg_len_max hqPgLength, uint_pg_len_max joinedPgLength, uint32_t readsPerBlock, uint8_t coder_level,
+            bool singleFileMode);
+    template void SeparatedPseudoGenomePersistence::compressReadsPgPositionsInBlocks<uint_pg_len_max>(ostream &pgrcOut,
+            vector<uint_pg_len_max> &orgIdx2PgPos, ExtendedReadsListWithConstantAccessOption *hqRl,
+            uint_pg_len_max hqPgLength, uint_pg_len_max joinedPgLength, uint32_t readsPerBlock, uint8_t coder_level,
+            bool singleFileMode);
+
+    template <typename uint_pg_len>
+    void SeparatedPseudoGenomePersistence::decompressReadsPgPositionsBlock(const string &pgPosBlock,
+            const string &hqRlBlock, uint64_t blockPartReadsCount, uint8_t parts, uint_pg_len_max hqPgLength,
+            bool revComplPairFile, vector<uint_pg_len_max> &pgPos, vector<uint32_t> &hqRlIdx,
+            ExtendedReadsListWithConstantAccessOption &hqRl) {
+        const uint_pg_len* posPtr = (const uint_pg_len*) pgPosBlock.data();
+        if (pgPosBlock.size() != blockPartReadsCount * parts * sizeof(uint_pg_len)) {
+            fprintf(stderr, "Invalid length of a reads positions block (corrupted archive).\n");
+            exit(EXIT_FAILURE);
+        }
+        pgPos.resize(blockPartReadsCount * parts);
+        hqRlIdx.resize(blockPartReadsCount * parts);
+        uint32_t rlIdx = 0;
+        uint32_t firstPairFileRlIdx = 0;
+        for (uint8_t p = 0; p < parts; p++) {
+            if (p == 1)
+                firstPairFileRlIdx = rlIdx;
+            for (uint64_t i = 0; i < blockPartReadsCount; i++) {
+                const uint64_t k = blockPartReadsCount * p + i;
+                pgPos[k] = p ? (uint_pg_len) (pgPos[i] + posPtr[k]) : posPtr[k];
+                hqRlIdx[k] = rlIdx;
+                rlIdx += pgPos[k] < hqPgLength;
+            }
+        }
+        const char* rlPtr = hqRlBlock.data();
+        const char* const rlGuard = rlPtr + hqRlBlock.size();
+        if (hqRlBlock.size() < 2 * (size_t) rlIdx) {
+            fprintf(stderr, "Invalid length of a HQ reads list block (corrupted archive).\n");
+            exit(EXIT_FAILURE);
+        }
+        hqRl.readsCount = rlIdx;
+        hqRl.revComp.assign(rlPtr, rlPtr + rlIdx);
+        rlPtr += rlIdx;
+        hqRl.misCnt.assign(rlPtr, rlPtr + rlIdx);
+        rlPtr += rlIdx;
+        if (revComplPairFile)
+            for (uint32_t i = firstPairFileRlIdx; i < rlIdx; i++)
+                hqRl.revComp[i] = !hqRl.revComp[i];
+        hqRl.enableConstantAccess(true, true);
+        const uint64_t misCount = hqRl.misCumCount[rlIdx];
+        if (rlGuard - rlPtr != 2 * misCount) {
+            fprintf(stderr, "Invalid length of a HQ reads list block (corrupted archive).\n");
+            exit(EXIT_FAILURE);
+        }
+        hqRl.misSymCode.assign(rlPtr, rlPtr + misCount);
+        rlPtr += misCount;
+        hqRl.misOff.assign(rlPtr, rlPtr + misCount);
+        for (uint32_t i = 0; i < rlIdx; i++)
+            PgHelpers::convertMisRevOffsets2Offsets<uint8_t>(hqRl.misOff.data() + hqRl.misCumCount[i],
+                                                             hqRl.getMisCount(i), hqRl.readLength);
+    }
+    template void SeparatedPseudoGenomePersistence::decompressReadsPgPositionsBlock<uint_pg_len_std>(
+            const string &pgPosBlock, const string &hqRlBlock, uint64_t blockPartReadsCount, uint8_t parts,
+            uint_pg_len_max hqPgLength, bool revComplPairFile, vector<uint_pg_len_max> &pgPos,
+            vector<uint32_t> &hqRlIdx, ExtendedReadsListWithConstantAccessOption &hqRl);
+    template void SeparatedPseudoGenomePersistence::decompressReadsPgPositionsBlock<uint_pg_len_max>(
+            const string &pgPosBlock, const string &hqRlBlock, uint64_t blockPartReadsCount, uint8_t parts,
+            uint_pg_len_max hqPgLength, bool revComplPairFile, vector<uint_pg_len_max> &pgPos,
+            vector<uint32_t> &hqRlIdx, ExtendedReadsListWithConstantAccessOption &hqRl);
+
+    // indexes of pair positions streams at a decoded pair
+    struct PairPositionsDecodingPoint {
+        uint_reads_cnt_std i = 0;
+        size_t offIdx = 0;
+        size_t delFlagIdx = 0;
+        size_t delIdx = 0;
+        bool found = false;
+    };
+
     template <typename uint_pg_len>
     void SeparatedPseudoGenomePersistence::decompressReadsPgPositions(istream &pgrcIn, vector<uint_pg_len> &pgPos,
                                                                           PgRCParams* params) {
@@ -626,48 +968,95 @@ namespace PgTools {
 
             const uint_reads_cnt_std pairsCount = readsTotalCount / 2;
             vector<uint_reads_cnt_std> bppRank;
-            bppRank.reserve(pairsCount);
-            for (uint_reads_cnt_std p = 0; p < pairsCount; p++)
-                bppRank.push_back(p);
-            parallel_algorithm::stable_sort(bppRank.begin(), bppRank.end(),
-                             [&](const uint_reads_cnt_std &idx1, const uint_reads_cnt_std &idx2) -> bool
-                             { return pgPos[idx1] < pgPos[idx2]; });
-
+            radixSortIndexesByKeys(pgPos.data(), pairsCount, bppRank);
             pgPos.resize(readsTotalCount);
-            int64_t nbpPos = 0;
-            int64_t offIdx = -1;
-            int64_t delFlagIdx = -1;
-            int64_t delIdx = -1;
-            int64_t nbpPosIdx = -1;
-            int64_t refPrev = 0;
-            int64_t prev = 0;
-            bool match = false;
-            for (uint_reads_cnt_std i = 0; i < pairsCount; i++) {
-                uint_reads_cnt_std p = bppRank[i];
-                if (offsetInUint16Flag[i] == 1) {
-                    int64_t delta = offsetInUint16Value[++offIdx];
-                    if (offsetIsBaseFirstFlag[offIdx] == 0)
-                        delta = -delta;
-                    nbpPos = pgPos[p] + delta;
-                } else if (deltaInInt16Flag[++delFlagIdx]){
-                    int64_t delta = refPrev + deltaInInt16Value[++delIdx];
-                    refPrev = delta;
-                    prev = delta;
-                    if (deltaIsBaseFirstFlag[delIdx] == 0)
-                        delta = -delta;
-                    nbpPos = pgPos[p] + delta;
-                    match = true;
-                } else {
-                    nbpPos = notBasePairPos[++nbpPosIdx];
-                    int64_t delta = nbpPos - pgPos[p];
-                    if (delta < 0)
-                        delta = -delta;
-                    if (!match || refPrev != prev)
-                        refPrev = delta;
-                    match = false;
-                    prev = delta;
+
+            // chunks are decoded in parallel starting from synchronization points, i.e. explicit (not delta coded)
+            // not-base pair positions preceded by another explicit position (the delta coding state is reset there)
+            const uint_reads_cnt_std chunksCount = getPairCodingChunksCount(pairsCount);
+            const uint64_t chunkLength = ((uint64_t) pairsCount + chunksCount - 1) / chunksCount;
+            auto isDeltaCoded = [&](size_t delFlagIdx) -> bool {
+                return deltaPairEncodingEnabled && deltaInInt16Flag[delFlagIdx];
+            };
+            vector<size_t> offsetsPos(chunksCount + 1, 0), nonOffsetsPos(chunksCount + 1, 0),
+                    deltasPos(chunksCount + 1, 0);
+            #pragma omp parallel for num_threads(numberOfThreads)
+            for (uint_reads_cnt_std c = 0; c < chunksCount; c++) {
+                const uint_reads_cnt_std begin = std::min<uint64_t>(c * chunkLength, pairsCount);
+                const uint_reads_cnt_std end = std::min<uint64_t>(begin + chunkLength, pairsCount);
+                offsetsPos[c + 1] = std::count(offsetInUint16Flag.begin() + begin, offsetInUint16Flag.begin() + end, 1);
+                nonOffsetsPos[c + 1] = (end - begin) - offsetsPos[c + 1];
+            }
+            for (uint_reads_cnt_std c = 0; c < chunksCount; c++) {
+                offsetsPos[c + 1] += offsetsPos[c];
+                nonOffsetsPos[c + 1] += nonOffsetsPos[c];
+            }
+            if (deltaPairEncodingEnabled) {
+                #pragma omp parallel for num_threads(numberOfThreads)
+                for (uint_reads_cnt_std c = 0; c < chunksCount; c++)
+                    deltasPos[c + 1] = std::count(deltaInInt16Flag.begin() + nonOffsetsPos[c],
+                                                  deltaInInt16Flag.begin() + nonOffsetsPos[c + 1], 1);
+                for (uint_reads_cnt_std c = 0; c < chunksCount; c++)
+                    deltasPos[c + 1] += deltasPos[c];
+            }
+            vector<PairPositionsDecodingPoint> syncPoints(chunksCount + 1);
+            syncPoints[0].found = true;
+            syncPoints[chunksCount] = { pairsCount, offsetsPos[chunksCount], nonOffsetsPos[chunksCount],
+                                        deltasPos[chunksCount], true };
+            #pragma omp parallel for schedule(dynamic) num_threads(numberOfThreads)
+            for (uint_reads_cnt_std c = 1; c < chunksCount; c++) {
+                const uint_reads_cnt_std end = std::min<uint64_t>((c + 1) * chunkLength, pairsCount);
+                PairPositionsDecodingPoint point = { (uint_reads_cnt_std) std::min<uint64_t>(c * chunkLength, pairsCount),
+                                                     offsetsPos[c], nonOffsetsPos[c], deltasPos[c], false };
+                for (; point.i < end; point.i++) {
+                    if (offsetInUint16Flag[point.i] == 1) {
+                        point.offIdx++;
+                        continue;
+                    }
+                    if (point.delFlagIdx > 0 && !isDeltaCoded(point.delFlagIdx) && !isDeltaCoded(point.delFlagIdx - 1)) {
+                        point.found = true;
+                        break;
+                    }
+                    point.delIdx += isDeltaCoded(point.delFlagIdx++);
+                }
+                syncPoints[c] = point;
+            }
+
+            #pragma omp parallel for schedule(dynamic) num_threads(numberOfThreads)
+            for (uint_reads_cnt_std c = 0; c < chunksCount; c++) {
+                if (!syncPoints[c].found)
+                    continue;
+                uint_reads_cnt_std next = c + 1;
+                while (!syncPoints[next].found)
+                    next++;
+                const uint_reads_cnt_std end = syncPoints[next].i;
+                size_t offIdx = syncPoints[c].offIdx;
+                size_t delFlagIdx = syncPoints[c].delFlagIdx;
+                size_t delIdx = syncPoints[c].delIdx;
+                PairOffsetDeltaCodingState<int16_t> state;
+                for (uint_reads_cnt_std i = syncPoints[c].i; i < end; i++) {
+                    uint_reads_cnt_std p = bppRank[i];
+                    int64_t nbpPos;
+                    if (offsetInUint16Flag[i] == 1) {
+                        int64_t delta = offsetInUint16Value[offIdx];
+                        if (offsetIsBaseFirstFlag[offIdx++] == 0)
+                            delta = -delta;
+                        nbpPos = pgPos[p] + delta;
+                    } else if (isDeltaCoded(delFlagIdx++)) {
+                        int64_t delta = state.refPrev + deltaInInt16Value[delIdx];
+                        state.update(delta, true);
+                        if (deltaIsBaseFirstFlag[delIdx++] == 0)
+                            delta = -delta;
+                        nbpPos = pgPos[p] + delta;
+                    } else {
+                        nbpPos = notBasePairPos[delFlagIdx - 1 - delIdx];
+                        int64_t delta = nbpPos - pgPos[p];
+                        if (delta < 0)
+                            delta = -delta;
+                        state.update(delta, false);
+                    }
+                    pgPos[pairsCount + p] = nbpPos;
                 }
-                pgPos[pairsCount + p] = nbpPos;
             }
         }
     }
@@ -925,7 +1314,8 @@ namespace PgTools {
                                COMPRESSION_ESTIMATION_UINT8_BITMAP);
         }
         auto rangeCoderProps = getDefaultRangeCoderProps();
-        auto ppmd13CoderProps = getDefaultCoderProps(PPMD7_CODER, CODER_LEVEL_MAX, 13);
+        auto ppmd13CoderProps = getDefaultCoderProps(PPMD7_CODER,
+                coder_level == CODER_LEVEL_FAST ? CODER_LEVEL_FAST : CODER_LEVEL_MAX, 13);
         auto zerosFlagCoderProps = getSelectorCoderProps( { fse12CoderProps.get(),
                                                             ignoreOffDest ? rangeCoderProps.get() : ppmd13CoderProps.get() } );;
         auto mismatchesCountsCoderProps = getSelectorCoderProps( { fse12CoderProps.get(), rangeCoderProps.get() } );
@@ -951,6 +1341,42 @@ namespace PgTools {
         }
     }
 
+    void SeparatedPseudoGenomeOutputBuilder::compressedBuildProps(ostream &pgrcOut,
+                                                                  ExtendedReadsListWithConstantAccessOption *rl) {
+        prebuildAssert(false);
+        buildProps();
+        writeReadMode(*pgPropDest, false);
+        rl->revComp.assign(readsCounter, 0);
+        rl->misCnt.assign(readsCounter, 0);
+        rl->misSymCode.clear();
+        rl->misOff.clear();
+        if (!this->disableRevComp) {
+            string rlRevCompStr = toString(rlRevCompDest);
+            rl->revComp.assign(rlRevCompStr.begin(), rlRevCompStr.end());
+        }
+        string rlMisSym;
+        if (!this->disableMismatches) {
+            string misCnts = toString(rlMisCntDest);
+            rl->misCnt.assign(misCnts.begin(), misCnts.end());
+            rlMisSym = toString(rlMisSymDest);
+        }
+        string basesOrdered = reorderingSymbolsExclusiveMismatchEncoding(rlMisSym);
+        pgrcOut.write(basesOrdered.data(), basesOrdered.length());
+        if (!this->disableMismatches) {
+            rl->misSymCode.assign(rlMisSym.begin(), rlMisSym.end());
+            istringstream misRevOffSrc(toString(rlMisRevOffDest));
+            rl->misOff.resize(rl->misSymCode.size());
+            uint16_t revOff = 0;
+            for (auto &off: rl->misOff) {
+                PgHelpers::readReadLengthValue(misRevOffSrc, revOff, false);
+                off = revOff;
+            }
+        }
+        rl->readsCount = readsCounter;
+        auto fse12CoderProps = getDefaultFSECoderProps(12);
+        writeCompressed(pgrcOut, ((ostringstream*) pgPropDest)->str(), fse12CoderProps.get());
+    }
+
     void SeparatedPseudoGenomeOutputBuilder::updateOriginalIndexesIn(SeparatedPseudoGenome *sPg) {
         string tmp = ((ostringstream *) rlOrgIdxDest)->str();
         uint_reads_cnt_std *orgIdxPtr = (uint_reads_cnt_std *) tmp.data();
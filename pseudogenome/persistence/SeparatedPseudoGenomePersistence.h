@@ -51,11 +51,26 @@ namespace PgTools {
 
         static void writePseudoGenomeSequence(string &pgSequence, string pgPrefix);
 
+        // orgIdx2PgPos is consumed (released as soon as the streams are prepared)
         template <typename uint_pg_len>
-        static void compressReadsPgPositions(ostream &pgrcOut, vector<uint_pg_len_max> orgIdx2PgPos,
+        static void compressReadsPgPositions(ostream &pgrcOut, vector<uint_pg_len_max> &orgIdx2PgPos,
                 uint_pg_len_max joinedPgLength, uint8_t coder_level, bool singleFileMode, bool deltaPairEncodingEnabled = true);
         template <typename uint_pg_len>
         static void decompressReadsPgPositions(istream &pgrcIn, vector<uint_pg_len> &pgPos, PgRCParams* params);
+
+        // random access mode: positions of reads (pairs in PE mode) in the original order are coded in blocks
+        // of readsPerBlock together with entries of HQ reads list (orgIdx2PgPos and hqRl are consumed)
+        template <typename uint_pg_len>
+        static void compressReadsPgPositionsInBlocks(ostream &pgrcOut, vector<uint_pg_len_max> &orgIdx2PgPos,
+                ExtendedReadsListWithConstantAccessOption *hqRl, uint_pg_len_max hqPgLength,
+                uint_pg_len_max joinedPgLength, uint32_t readsPerBlock, uint8_t coder_level, bool singleFileMode);
+        // positions of a block are part-major; HQ reads list of a block is indexed by hqRlIdx of its reads
+        // (with mismatches offsets and pair file reverse complements resolved)
+        template <typename uint_pg_len>
+        static void decompressReadsPgPositionsBlock(const string &pgPosBlock, const string &hqRlBlock,
+                uint64_t blockPartReadsCount, uint8_t parts, uint_pg_len_max hqPgLength, bool revComplPairFile,
+                vector<uint_pg_len_max> &pgPos, vector<uint32_t> &hqRlIdx,
+                ExtendedReadsListWithConstantAccessOption &hqRl);
     };
 
     class SeparatedPseudoGenomeOutputBuilder {
@@ -125,6 +140,9 @@ namespace PgTools {
         void build(const string &pgPrefix);
 
         void compressedBuild(ostream &pgrcOut, uint8_t coder_level, bool ignoreOffDest = false);
+        // random access mode: only properties (and the order of bases) are written; reads list entries
+        // (with rev-coded mismatches offsets) are moved to rl to be coded in blocks with reads positions
+        void compressedBuildProps(ostream &pgrcOut, ExtendedReadsListWithConstantAccessOption *rl);
 
         void updateOriginalIndexesIn(SeparatedPseudoGenome *sPg);
 
@@ -325,41 +325,70 @@ namespace PgTools {
         return isRevCompEnabled()?revComp[idx]:false;
     }
 
+    const static uint_reads_cnt_max MIN_READS_PER_PREFIX_SUMS_BLOCK = 1 << 16;
+
     void ExtendedReadsListWithConstantAccessOption::enableConstantAccess(bool disableIterationMode, bool skipPositions) {
-#pragma parallel omp
-        {
-#pragma omp single
-            {
-#pragma parallel task
-                {
-                    if (pos.empty() && !skipPositions) {
-                        pos.reserve(readsCount + 1);
-                        uint_pg_len_max currPos = 0;
-                        for (uint_reads_cnt_max i = 0; i < readsCount; i++) {
-                            currPos += off[i];
-                            this->pos.push_back(currPos);
-                        }
-                        this->pos.push_back(this->pos.back() + this->readLength);
-                    }
-                    if (disableIterationMode)
-                        off.clear();
+        const bool buildPositions = pos.empty() && !skipPositions;
+        const bool buildMisCumCount = !misCnt.empty();
+        if (buildPositions)
+            pos.resize(readsCount + 1);
+        if (buildMisCumCount)
+            misCumCount.resize(readsCount + 1);
+        // blocked prefix sums (of both arrays): sums within blocks, offsets of blocks, shifting blocks by offsets
+        int blocksCount = readsCount / MIN_READS_PER_PREFIX_SUMS_BLOCK;
+        if (blocksCount > PgHelpers::numberOfThreads)
+            blocksCount = PgHelpers::numberOfThreads;
+        if (blocksCount < 1)
+            blocksCount = 1;
+        const uint_reads_cnt_max blockLength = (readsCount + blocksCount - 1) / blocksCount;
+        vector<uint_pg_len_max> posOffsets(blocksCount, 0);
+        vector<uint_reads_cnt_max> misOffsets(blocksCount, 0);
+        #pragma omp parallel for num_threads(blocksCount)
+        for (int b = 0; b < blocksCount; b++) {
+            const uint_reads_cnt_max start = b * blockLength;
+            const uint_reads_cnt_max end = start + blockLength < readsCount ? start + blockLength : readsCount;
+            if (buildPositions) {
+                uint_pg_len_max currPos = 0;
+                for (uint_reads_cnt_max i = start; i < end; i++) {
+                    currPos += off[i];
+                    pos[i] = currPos;
                 }
-#pragma parallel task
-                {
-                    if (!misCnt.empty()) {
-                        uint_reads_cnt_max cumCount = 0;
-                        misCumCount.reserve(readsCount + 1);
-                        misCumCount.push_back(0);
-                        for (uint_reads_cnt_max i = 0; i < readsCount; i++) {
-                            cumCount += misCnt[i];
-                            misCumCount.push_back(cumCount);
-                        }
-                        if (disableIterationMode)
-                            misCnt.clear();
-                    }
+                posOffsets[b] = currPos;
+            }
+            if (buildMisCumCount) {
+                uint_reads_cnt_max cumCount = 0;
+                for (uint_reads_cnt_max i = start; i < end; i++) {
+                    cumCount += misCnt[i];
+                    misCumCount[i + 1] = cumCount;
                 }
+                misOffsets[b] = cumCount;
             }
         }
+        uint_pg_len_max posOffset = 0;
+        uint_reads_cnt_max misOffset = 0;
+        for (int b = 0; b < blocksCount; b++) {
+            swap(posOffset, posOffsets[b]);
+            posOffset += posOffsets[b];
+            swap(misOffset, misOffsets[b]);
+            misOffset += misOffsets[b];
+        }
+        #pragma omp parallel for num_threads(blocksCount)
+        for (int b = 1; b < blocksCount; b++) {
+            const uint_reads_cnt_max start = b * blockLength;
+            const uint_reads_cnt_max end = start + blockLength < readsCount ? start + blockLength : readsCount;
+            if (buildPositions)
+                for (uint_reads_cnt_max i = start; i < end; i++)
+                    pos[i] += posOffsets[b];
+            if (buildMisCumCount)
+                for (uint_reads_cnt_max i = start; i < end; i++)
+                    misCumCount[i + 1] += misOffsets[b];
+        }
+        if (buildPositions)
+            pos[readsCount] = (readsCount ? pos[readsCount - 1] : 0) + readLength;
+        if (disableIterationMode) {
+            off.clear();
+            misCnt.clear();
+        }
     }
 
     bool ExtendedReadsListWithConstantAccessOption::isConstantAccessEnalbed() {
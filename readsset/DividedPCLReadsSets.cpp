@@ -55,18 +55,31 @@ namespace PgTools {
         }
     }
 
+    uint_reads_cnt_max DividedPCLReadsSets::estimateReadsCountLimit(uint64_t inputSizeInBytes,
+                                                                  uint_read_len_max readLength) {
+        // FASTQ record with empty headers: 2 * (readLength + 1) + 4
+        uint64_t estimate = inputSizeInBytes / (2 * (uint64_t) readLength + 6);
+        return estimate > (uint_reads_cnt_max) -1 ? (uint_reads_cnt_max) -1 : estimate;
+    }
+
     DividedPCLReadsSets*
     DividedPCLReadsSets::getQualityDivisionBasedReadsSets(ReadsSourceIteratorTemplate<uint_read_len_max> *readsIt,
                                                           uint_read_len_max readLength,
                                                           double error_limit, bool simplified_suffix_mode,
-                                                          bool separateNReadsSet, bool nReadsLQ) {
-        DividedPCLReadsSets* readsSets = new DividedPCLReadsSets(readLength, separateNReadsSet, nReadsLQ);
+                                                          bool separateNReadsSet, bool nReadsLQ,
+                                                          uint64_t inputSizeInBytes) {
         time_checkpoint();
         QualityDividingReadsSetIterator<uint_read_len_max> *divReadsIt =
                 new QualityDividingReadsSetIterator<uint_read_len_max>(readsIt, error_limit,
                                                                        simplified_suffix_mode, readLength);
+        const bool readsPresent = divReadsIt->moveNext();
+        if (readLength == 0 && readsPresent)
+            readLength = divReadsIt->getReadLength();
+        DividedPCLReadsSets* readsSets = new DividedPCLReadsSets(readLength, separateNReadsSet, nReadsLQ);
+        if (inputSizeInBytes && readLength)
+            readsSets->hqReadsSet->reserve(estimateReadsCountLimit(inputSizeInBytes, readLength));
         vector<uint_reads_cnt_max> lqMapping, nMapping;
-        while (divReadsIt->moveNext()) {
+        if (readsPresent) do {
             if (separateNReadsSet || nReadsLQ) {
                 if (divReadsIt->containsN()) {
                     (separateNReadsSet ? readsSets->nReadsSet : readsSets->lqReadsSet)->addRead(
@@ -83,7 +96,7 @@ namespace PgTools {
             {
                 readsSets->hqReadsSet->addRead(divReadsIt->getRead().data(), divReadsIt->getReadLength());
             }
-        };
+        } while (divReadsIt->moveNext());
         cout << "Filtered " << (lqMapping.size() + nMapping.size());
         if (separateNReadsSet)
             cout << " (including " << nMapping.size() << " containing N)";
@@ -99,16 +112,105 @@ namespace PgTools {
         return readsSets;
     }
 
+    static const uint8_t HQ_READ_CLASS = 0;
+    static const uint8_t LQ_READ_CLASS = 1;
+    static const uint8_t N_READ_CLASS = 2;
+    static const uint8_t READ_CLASSES_COUNT = 3;
+
+    DividedPCLReadsSets*
+    DividedPCLReadsSets::getQualityDivisionBasedReadsSets(ReadsSetPersistence::ManagedReadsChunks *readsChunks,
+                                                          uint_read_len_max readLength,
+                                                          double error_limit, bool simplified_suffix_mode,
+                                                          bool separateNReadsSet, bool nReadsLQ) {
+        time_checkpoint();
+        const int chunksCount = readsChunks->chunksCount();
+        for(int c = 0; readLength == 0 && c < chunksCount; c++) {
+            ReadsSourceIteratorTemplate<uint_read_len_max>* readsIt = readsChunks->getChunkIterator(c);
+            if (readsIt->moveNext())
+                readLength = readsIt->getReadLength();
+            readsIt->rewind();
+        }
+        DividedPCLReadsSets* readsSets = new DividedPCLReadsSets(readLength, separateNReadsSet, nReadsLQ);
+        const uint_reads_cnt_max readsCount = readsChunks->readsCount();
+        vector<uint8_t> readsClass(readsCount);
+        vector<uint_reads_cnt_max> chunksClassBegIdx((chunksCount + 1) * READ_CLASSES_COUNT, 0);
+        #pragma omp parallel for schedule(dynamic)
+        for(int c = 0; c < chunksCount; c++) {
+            QualityDividingReadsSetIterator<uint_read_len_max> divReadsIt(readsChunks->getChunkIterator(c),
+                    error_limit, simplified_suffix_mode, readLength);
+            uint_reads_cnt_max* classCount = chunksClassBegIdx.data() + (c + 1) * READ_CLASSES_COUNT;
+            uint_reads_cnt_max i = readsChunks->getChunkFirstReadIndex(c);
+            while (divReadsIt.moveNext()) {
+                if (divReadsIt.getReadLength() != readLength) {
+                    fprintf(stderr, "Unsupported variable length reads.\n");
+                    exit(EXIT_FAILURE);
+                }
+                uint8_t readClass = HQ_READ_CLASS;
+                if ((separateNReadsSet || nReadsLQ) && divReadsIt.containsN())
+                    readClass = separateNReadsSet ? N_READ_CLASS : LQ_READ_CLASS;
+                else if (error_limit < 1 && !divReadsIt.isQualityHigh())
+                    readClass = LQ_READ_CLASS;
+                classCount[readClass]++;
+                readsClass[i++] = readClass;
+            }
+        }
+        for(int c = 0; c < chunksCount; c++)
+            for(uint8_t k = 0; k < READ_CLASSES_COUNT; k++)
+                chunksClassBegIdx[(c + 1) * READ_CLASSES_COUNT + k] += chunksClassBegIdx[c * READ_CLASSES_COUNT + k];
+        const uint_reads_cnt_max* classTotal = chunksClassBegIdx.data() + chunksCount * READ_CLASSES_COUNT;
+        readsSets->hqReadsSet->resize(classTotal[HQ_READ_CLASS]);
+        readsSets->lqReadsSet->resize(classTotal[LQ_READ_CLASS]);
+        if (separateNReadsSet)
+            readsSets->nReadsSet->resize(classTotal[N_READ_CLASS]);
+        vector<uint_reads_cnt_max> lqMapping(classTotal[LQ_READ_CLASS]), nMapping(classTotal[N_READ_CLASS]);
+        PackedConstantLengthReadsSet* classReadsSet[READ_CLASSES_COUNT] =
+                { readsSets->hqReadsSet, readsSets->lqReadsSet, readsSets->nReadsSet };
+        uint_reads_cnt_max* classMapping[READ_CLASSES_COUNT] = { nullptr, lqMapping.data(), nMapping.data() };
+        #pragma omp parallel for schedule(dynamic)
+        for(int c = 0; c < chunksCount; c++) {
+            ReadsSourceIteratorTemplate<uint_read_len_max>* readsIt = readsChunks->getChunkIterator(c);
+            readsIt->rewind();
+            uint_reads_cnt_max classIdx[READ_CLASSES_COUNT];
+            std::copy_n(chunksClassBegIdx.data() + c * READ_CLASSES_COUNT, READ_CLASSES_COUNT, classIdx);
+            uint_reads_cnt_max i = readsChunks->getChunkFirstReadIndex(c);
+            while (readsIt->moveNext()) {
+                const uint8_t readClass = readsClass[i];
+                classReadsSet[readClass]->packRead(readsIt->getRead().data(), classIdx[readClass]);
+                if (classMapping[readClass])
+                    classMapping[readClass][classIdx[readClass]] = i;
+                classIdx[readClass]++;
+                i++;
+            }
+        }
+        cout << "Filtered " << (lqMapping.size() + nMapping.size());
+        if (separateNReadsSet)
+            cout << " (including " << nMapping.size() << " containing N)";
+        cout << " reads (out of " << readsCount << ") in " << time_millis() << " msec." << endl;
+        *logout << endl;
+
+        readsSets->lqMapping = new VectorMapping(std::move(lqMapping), readsCount);
+        if (separateNReadsSet)
+            readsSets->nMapping = new VectorMapping(std::move(nMapping), readsCount);
+
+        return readsSets;
+    }
+
     DividedPCLReadsSets *
     DividedPCLReadsSets::getSimpleDividedPCLReadsSets(ReadsSourceIteratorTemplate<uint_read_len_max> *readsIt,
                                                       uint_read_len_max readLength, bool separateNReadsSet,
-                                                      bool nReadsLQ) {
+                                                      bool nReadsLQ, uint64_t inputSizeInBytes) {
         if (separateNReadsSet || nReadsLQ)
-            return DividedPCLReadsSets::getQualityDivisionBasedReadsSets(readsIt, readLength, 1, false, separateNReadsSet, nReadsLQ);
+            return DividedPCLReadsSets::getQualityDivisionBasedReadsSets(readsIt, readLength, 1, false,
+                    separateNReadsSet, nReadsLQ, inputSizeInBytes);
+        const bool readsPresent = readsIt->moveNext();
+        if (readLength == 0 && readsPresent)
+            readLength = readsIt->getReadLength();
         DividedPCLReadsSets* readsSets = new DividedPCLReadsSets(readLength, false, false);
-        while (readsIt->moveNext()) {
+        if (inputSizeInBytes && readLength)
+            readsSets->hqReadsSet->reserve(estimateReadsCountLimit(inputSizeInBytes, readLength));
+        if (readsPresent) do {
             readsSets->hqReadsSet->addRead(readsIt->getRead().data(), readsIt->getReadLength());
-        }
+        } while (readsIt->moveNext());
         readsSets->lqMapping = new VectorMapping({}, readsSets->hqReadsSet->readsCount());
         return readsSets;
     }
@@ -2,6 +2,7 @@
 #define PGTOOLS_DIVIDEDPCLREADSSETS_H
 
 #include "PackedConstantLengthReadsSet.h"
+#include "persistance/ReadsSetPersistence.h"
 
 using namespace PgReadsSet;
 
@@ -36,11 +37,19 @@ namespace PgTools {
 
         static DividedPCLReadsSets* getQualityDivisionBasedReadsSets(
                 ReadsSourceIteratorTemplate<uint_read_len_max> *readsIt, uint_read_len_max readLength,
+                double error_limit, bool simplified_suffix_mode, bool separateNReadsSet = false, bool nReadsLQ = false,
+                uint64_t inputSizeInBytes = 0);
+
+        static DividedPCLReadsSets* getQualityDivisionBasedReadsSets(
+                ReadsSetPersistence::ManagedReadsChunks *readsChunks, uint_read_len_max readLength,
                 double error_limit, bool simplified_suffix_mode, bool separateNReadsSet = false, bool nReadsLQ = false);
 
         static DividedPCLReadsSets *
     getSimpleDividedPCLReadsSets(ReadsSourceIteratorTemplate<uint_read_len_max> *readsIt, uint_read_len_max readLength,
-                                 bool separateNReadsSet, bool nReadsLQ);
+                                 bool separateNReadsSet, bool nReadsLQ, uint64_t inputSizeInBytes = 0);
+
+        // upper bound of reads count in FASTQ input of a given size
+        static uint_reads_cnt_max estimateReadsCountLimit(uint64_t inputSizeInBytes, uint_read_len_max readLength);
 
         static DividedPCLReadsSets *
     loadDivisionReadsSets(ReadsSourceIteratorTemplate<uint_read_len_max> *readsIt, uint_read_len_max readLength,
@@ -20,16 +20,17 @@ namespace PgReadsSet {
         sPacker = SymbolsPackingFacility::getInstance(properties, symbolsPerElement);
 
         packedLength = (properties->maxReadLength + symbolsPerElement - 1) / symbolsPerElement;
+        twoBitsWordsMode = sPacker->isTwoBitsPerSymbolLayout();
     }
 
     void PackedConstantLengthReadsSet::reserve(uint_reads_cnt_max readsCount) {
-        packedReads.reserve((size_t) packedLength * readsCount);
+        packedReads.reserve(packedReadsSize(readsCount));
     }
 
     void PackedConstantLengthReadsSet::resize(uint_reads_cnt_max readsCount) {
         properties->readsCount = readsCount;
         properties->allReadsLength = (size_t) readsCount * properties->minReadLength;
-        packedReads.resize((size_t) packedLength * readsCount);
+        packedReads.resize(packedReadsSize(readsCount));
 //        packedReads.shrink_to_fit();
     }
 
@@ -38,12 +39,16 @@ namespace PgReadsSet {
             fprintf(stderr, "Unsupported variable length reads.\n");
             exit(EXIT_FAILURE);
         }
-        packedReads.resize((size_t) packedLength * ++properties->readsCount);
+        packedReads.resize(packedReadsSize(++properties->readsCount));
         properties->allReadsLength += properties->minReadLength;
         uint_ps_element_min *packedReadsPtr = packedReads.data() + (size_t) packedLength * (properties->readsCount - 1);
         sPacker->packSequence(read, readLength, packedReadsPtr);
     }
 
+    void PackedConstantLengthReadsSet::packRead(const char* read, uint_reads_cnt_max destIdx) {
+        sPacker->packSequence(read, properties->maxReadLength, packedReads.data() + (size_t) packedLength * destIdx);
+    }
+
     void PackedConstantLengthReadsSet::copyRead(uint_reads_cnt_max srcIdx, uint_reads_cnt_max destIdx,
             uint_reads_cnt_max n) {
         std::copy(packedReads.begin() + (size_t) packedLength * srcIdx, packedReads.begin() + (size_t) packedLength * (srcIdx + n),
@@ -90,14 +95,23 @@ namespace PgReadsSet {
     }
 
     int PackedConstantLengthReadsSet::comparePackedReads(uint_reads_cnt_max lIdx, uint_reads_cnt_max rIdx){
+        if (twoBitsWordsMode)
+            return SymbolsPackingFacility::compareTwoBitsSequences(packedReads.data() + lIdx * (size_t) packedLength, 0,
+                    packedReads.data() + rIdx * (size_t) packedLength, 0, properties->maxReadLength);
         return sPacker->compareSequences(packedReads.data() + lIdx * (size_t) packedLength, packedReads.data() + rIdx * (size_t) packedLength, properties->maxReadLength);
     }
 
     int PackedConstantLengthReadsSet::comparePackedReads(uint_reads_cnt_max lIdx, uint_reads_cnt_max rIdx, uint_read_len_max offset) {
+        if (twoBitsWordsMode)
+            return SymbolsPackingFacility::compareTwoBitsSequences(packedReads.data() + lIdx * (size_t) packedLength, offset,
+                    packedReads.data() + rIdx * (size_t) packedLength, offset, properties->maxReadLength - offset);
         return sPacker->compareSequences(packedReads.data() + lIdx * (size_t) packedLength, packedReads.data() + rIdx * (size_t) packedLength, offset, properties->maxReadLength - offset);
     }
 
     int PackedConstantLengthReadsSet::compareSuffixWithPrefix(uint_reads_cnt_max sufIdx, uint_reads_cnt_max preIdx, uint_read_len_max sufOffset) {
+        if (twoBitsWordsMode)
+            return SymbolsPackingFacility::compareTwoBitsSequences(packedReads.data() + sufIdx * (size_t) packedLength, sufOffset,
+                    packedReads.data() + preIdx * (size_t) packedLength, 0, properties->maxReadLength - sufOffset);
         return sPacker->compareSuffixWithPrefix(packedReads.data() + sufIdx * (size_t) packedLength, packedReads.data() + preIdx * (size_t) packedLength, sufOffset, properties->maxReadLength - sufOffset);
     }
 
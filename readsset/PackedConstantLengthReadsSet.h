@@ -16,6 +16,12 @@ namespace PgReadsSet {
         private:
             vector<uint_ps_element_min> packedReads;
             uchar packedLength;
+            // ACGT reads sets are compared using 64-bit words (32 symbols at once)
+            bool twoBitsWordsMode;
+
+            inline size_t packedReadsSize(uint_reads_cnt_max readsCount) const {
+                return (size_t) packedLength * readsCount + (twoBitsWordsMode ? SymbolsPackingFacility::WORD_ACCESS_PADDING : 0);
+            };
 
         public:
 
@@ -27,6 +33,7 @@ namespace PgReadsSet {
             void reserve(uint_reads_cnt_max readsCount);
             void resize(uint_reads_cnt_max readsCount);
             void addRead(const char* read, uint_read_len_max readLength);
+            void packRead(const char* read, uint_reads_cnt_max destIdx);
             void copyRead(uint_reads_cnt_max srcIdx, uint_reads_cnt_max destIdx, uint_reads_cnt_max n = 1);
             void copyPackedRead(const uint_ps_element_min *packedSequence, uint_reads_cnt_max destIdx,
                     uint_reads_cnt_max n = 1);
@@ -37,6 +44,7 @@ namespace PgReadsSet {
 
             inline bool isReadLengthConstant() override { return properties->constantReadLength; };
 
+            inline uchar getPackedLength() const { return packedLength; };
             inline const uint_ps_element_min* getPackedRead(uint_reads_cnt_max i) { return packedReads.data() + i * (size_t) packedLength;};
             inline const string getReadPrefix(uint_reads_cnt_max i, uint_read_len_max skipSuffix) { return sPacker->reverseSequence(packedReads.data() + i * (size_t) packedLength, 0, readLength(i) - skipSuffix);};
             inline void getReadSuffix(char *destPtr, uint_reads_cnt_max i, uint_read_len_max suffixPos) { sPacker->reverseSequence(packedReads.data() + i * (size_t) packedLength, suffixPos, readLength(i) - suffixPos, destPtr);};
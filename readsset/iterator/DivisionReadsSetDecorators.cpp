@@ -10,7 +10,7 @@ namespace PgTools {
     QualityDividingReadsSetIterator<uint_read_len>::QualityDividingReadsSetIterator(
             ReadsSourceIteratorTemplate<uint_read_len> *coreIterator, double error_level, bool suffix_simplified_mode, double read_length)
             :coreIterator(coreIterator), error_level(error_level), suffix_simplified_mode(suffix_simplified_mode) {
-                suffix_pos = read_length * (1 - error_level);
+                suffix_pos = read_length ? read_length * (1 - error_level) : -1;
             }
 
     template<typename uint_read_len>
@@ -20,6 +20,8 @@ namespace PgTools {
     bool QualityDividingReadsSetIterator<uint_read_len>::moveNext() {
         while (coreIterator->moveNext()) {
             allCounter++;
+            if (suffix_pos == -1)
+                suffix_pos = coreIterator->getReadLength() * (1 - error_level);
             return true;
         }
         allCounter++;
@@ -168,7 +168,7 @@ namespace PgReadsSet {
     }
 
     template<typename uint_read_len>
-    FASTQReadsSourceIterator<uint_read_len>::FASTQReadsSourceIterator(std::ifstream* source, std::ifstream* pairSource) {
+    FASTQReadsSourceIterator<uint_read_len>::FASTQReadsSourceIterator(std::istream* source, std::istream* pairSource) {
         ownStreams = false;
         this->source = source;
         this->pairSource = pairSource;
@@ -177,9 +177,6 @@ namespace PgReadsSet {
     template<typename uint_read_len>
     FASTQReadsSourceIterator<uint_read_len>::~FASTQReadsSourceIterator() {
         if (ownStreams) {
-            source->close();
-            if (pairSource)
-                pairSource->close();
             delete(source);
             delete(pairSource);
         }
@@ -242,6 +239,110 @@ namespace PgReadsSet {
     }
 
 
+    template<typename uint_read_len>
+    MemoryMappedFASTQReadsSourceIterator<uint_read_len>::MemoryMappedFASTQReadsSourceIterator(
+            const MemoryMappedFile* source, const MemoryMappedFile* pairSource):
+            MemoryMappedFASTQReadsSourceIterator(source->begin(), source->end(),
+                    pairSource ? pairSource->begin() : nullptr, pairSource ? pairSource->end() : nullptr) {
+    }
+
+    template<typename uint_read_len>
+    MemoryMappedFASTQReadsSourceIterator<uint_read_len>::MemoryMappedFASTQReadsSourceIterator(
+            const char* sourceBegin, const char* sourceEnd, const char* pairSourceBegin, const char* pairSourceEnd):
+            sourceBegin(sourceBegin), sourceEnd(sourceEnd), pairSourceBegin(pairSourceBegin), pairSourceEnd(pairSourceEnd) {
+        line.reserve(UINT8_MAX + 1);
+        quality.reserve(UINT8_MAX + 1);
+        rewind();
+    }
+
+    template<typename uint_read_len>
+    MemoryMappedFASTQReadsSourceIterator<uint_read_len>::~MemoryMappedFASTQReadsSourceIterator() {
+    }
+
+    template<typename uint_read_len>
+    string& MemoryMappedFASTQReadsSourceIterator<uint_read_len>::getRead() {
+        if (!readCopied) {
+            line.assign(readPtr, length);
+            readCopied = true;
+        }
+        return line;
+    }
+
+    template<typename uint_read_len>
+    string& MemoryMappedFASTQReadsSourceIterator<uint_read_len>::getQualityInfo() {
+        if (!qualityCopied) {
+            quality.assign(qualityPtr, length);
+            qualityCopied = true;
+        }
+        return quality;
+    }
+
+    template<typename uint_read_len>
+    uint_read_len MemoryMappedFASTQReadsSourceIterator<uint_read_len>::getReadLength() {
+        return length;
+    }
+
+    template<typename uint_read_len>
+    bool MemoryMappedFASTQReadsSourceIterator<uint_read_len>::moveNext() {
+        const char* end = sourceEnd;
+        const char** srcPos = &sourcePos;
+        if (pair && pairSourceBegin) {
+            end = pairSourceEnd;
+            srcPos = &pairSourcePos;
+        }
+        pair = !pair;
+
+        if (*srcPos >= end)
+            return false;
+        readPtr = nextLine(*srcPos, end);
+        qualityPtr = nextLine(nextLine(readPtr, end), end);
+        *srcPos = nextLine(qualityPtr, end);
+
+        const char* seqPtr = readPtr;
+        while (seqPtr < end && isalpha(*seqPtr))
+            seqPtr++;
+        length = seqPtr - readPtr;
+        if (qualityPtr + length > end) {
+            fprintf(stderr, "truncated FASTQ record (no. %lld)\n", (long long) counter + 1);
+            exit(EXIT_FAILURE);
+        }
+        readCopied = false;
+        qualityCopied = false;
+
+        counter++;
+        return true;
+    }
+
+    template<typename uint_read_len>
+    void MemoryMappedFASTQReadsSourceIterator<uint_read_len>::rewind() {
+        counter = -1;
+        sourcePos = sourceBegin;
+        pairSourcePos = pairSourceBegin;
+        pair = false;
+    }
+
+    template<typename uint_read_len>
+    IndexesMapping* MemoryMappedFASTQReadsSourceIterator<uint_read_len>::retainVisitedIndexesMapping() {
+        return new DirectMapping(counter + 1);
+    }
+
+    template<typename uint_read_len>
+    const char* MemoryMappedFASTQReadsSourceIterator<uint_read_len>::findRecordBeginning(const char* pos,
+            const char* begin, const char* end) {
+        if (pos <= begin)
+            return begin;
+        if (pos[-1] != '\n')
+            pos = nextLine(pos, end);
+        // quality line may also start with '@', but then the next but one line holds the sequence
+        while (pos < end) {
+            const char* optIdPtr = nextLine(nextLine(pos, end), end);
+            if (*pos == '@' && optIdPtr < end && *optIdPtr == '+')
+                return pos;
+            pos = nextLine(pos, end);
+        }
+        return end;
+    }
+
     template<typename uint_read_len>
     ReadsSourceIteratorTemplate<uint_read_len>::~ReadsSourceIteratorTemplate() {
     }
@@ -360,6 +461,8 @@ namespace PgReadsSet {
     template class FASTAReadsSourceIterator<uint_read_len_std>;
     template class FASTQReadsSourceIterator<uint_read_len_min>;
     template class FASTQReadsSourceIterator<uint_read_len_std>;
+    template class MemoryMappedFASTQReadsSourceIterator<uint_read_len_min>;
+    template class MemoryMappedFASTQReadsSourceIterator<uint_read_len_std>;
     template class RevComplPairReadsSetIterator<uint_read_len_min>;
     template class RevComplPairReadsSetIterator<uint_read_len_std>;
     template class IgnoreNReadsSetIterator<uint_read_len_min>;
@@ -151,8 +151,8 @@ namespace PgReadsSet {
         private:
             std::string id, line, opt_id, quality;
             uint_read_len length = 0;
-            std::ifstream* source = nullptr;
-            std::ifstream* pairSource = nullptr;
+            std::istream* source = nullptr;
+            std::istream* pairSource = nullptr;
             bool ownStreams = false;
             bool pair = false;
             int64_t counter = -1;
@@ -160,7 +160,7 @@ namespace PgReadsSet {
         public:
 
             FASTQReadsSourceIterator(const string &srcFile, const string &pairFile = std::string());
-            FASTQReadsSourceIterator(std::ifstream* source, std::ifstream* pairSource);
+            FASTQReadsSourceIterator(std::istream* source, std::istream* pairSource);
 
             ~FASTQReadsSourceIterator() override;
 
@@ -173,6 +173,60 @@ namespace PgReadsSet {
             IndexesMapping* retainVisitedIndexesMapping() override;
     };
 
+    template < typename uint_read_len >
+    class MemoryMappedFASTQReadsSourceIterator: public ReadsSourceIteratorTemplate< uint_read_len >
+    {
+        private:
+            std::string line, quality;
+            const char* readPtr = nullptr;
+            const char* qualityPtr = nullptr;
+            bool readCopied = false;
+            bool qualityCopied = false;
+            uint_read_len length = 0;
+            const char* sourceBegin = nullptr;
+            const char* sourceEnd = nullptr;
+            const char* pairSourceBegin = nullptr;
+            const char* pairSourceEnd = nullptr;
+            const char* sourcePos = nullptr;
+            const char* pairSourcePos = nullptr;
+            bool pair = false;
+            int64_t counter = -1;
+
+        public:
+
+            MemoryMappedFASTQReadsSourceIterator(const PgHelpers::MemoryMappedFile* source,
+                                                 const PgHelpers::MemoryMappedFile* pairSource);
+            // iterates over records in [sourceBegin, sourceEnd) (interleaved with pair records if pairSourceBegin is given)
+            MemoryMappedFASTQReadsSourceIterator(const char* sourceBegin, const char* sourceEnd,
+                                                 const char* pairSourceBegin = nullptr, const char* pairSourceEnd = nullptr);
+
+            ~MemoryMappedFASTQReadsSourceIterator() override;
+
+            bool moveNext() override;
+            string& getRead() override;
+            string& getQualityInfo() override;
+            uint_read_len getReadLength() override;
+            void rewind() override;
+
+            // zero-copy views into the mapped source
+            const char* getReadPtr() const { return readPtr; }
+            const char* getQualityInfoPtr() const { return qualityPtr; }
+
+            static inline const char* nextLine(const char* pos, const char* end) {
+                const char* nl = (const char*) memchr(pos, '\n', end - pos);
+                return nl ? nl + 1 : end;
+            }
+
+            static inline const char* nextRecord(const char* pos, const char* end) {
+                return nextLine(nextLine(nextLine(nextLine(pos, end), end), end), end);
+            }
+
+            // returns the beginning of the first record starting at pos or later (end if not found)
+            static const char* findRecordBeginning(const char* pos, const char* begin, const char* end);
+
+            IndexesMapping* retainVisitedIndexesMapping() override;
+    };
+
     template < typename uint_read_len >
     class RevComplPairReadsSetIterator: public ReadsSourceIteratorTemplate< uint_read_len > {
     private:
@@ -0,0 +1,248 @@
+#include "GzipFileIStream.h"
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace PgReadsSet {
+
+    static const uint8_t GZIP_ID1 = 0x1f;
+    static const uint8_t GZIP_ID2 = 0x8b;
+    static const uint8_t GZIP_FLG_FEXTRA = 4;
+    static const size_t GZIP_HEADER_LENGTH = 10;
+    static const size_t GZIP_FOOTER_LENGTH = 8;
+
+    static inline uint32_t readLE(const char* pos, int bytes) {
+        uint32_t res = 0;
+        for(int i = bytes; i-- > 0;)
+            res = (res << 8) | (uint8_t) pos[i];
+        return res;
+    }
+
+    // returns the total length of the BGZF block starting at pos (0 if it is not a BGZF block)
+    static size_t getBGZFBlockLength(const char* pos, const char* end) {
+        if (end - pos < (ptrdiff_t) (GZIP_HEADER_LENGTH + 2) || (uint8_t) pos[0] != GZIP_ID1 ||
+            (uint8_t) pos[1] != GZIP_ID2 || !(pos[3] & GZIP_FLG_FEXTRA))
+            return 0;
+        const size_t xLen = readLE(pos + GZIP_HEADER_LENGTH, 2);
+        const char* field = pos + GZIP_HEADER_LENGTH + 2;
+        const char* fieldsEnd = field + xLen;
+        if (fieldsEnd > end)
+            return 0;
+        while (field + 4 <= fieldsEnd) {
+            const size_t sLen = readLE(field + 2, 2);
+            if (field[0] == 'B' && field[1] == 'C' && sLen == 2 && field + 6 <= fieldsEnd) {
+                const size_t blockLength = readLE(field + 4, 2) + 1;
+                return pos + blockLength <= end ? blockLength : 0;
+            }
+            field += 4 + sLen;
+        }
+        return 0;
+    }
+
+    bool GzipFileIStream::isGzipFile(const string &filename) {
+        ifstream src(filename, ios_base::in | ios_base::binary);
+        return (uint8_t) src.get() == GZIP_ID1 && (uint8_t) src.get() == GZIP_ID2;
+    }
+
+    GzipFileIStream* GzipFileIStream::open(const string &filename) {
+#ifndef HAVE_ZLIB
+        fprintf(stderr, "gzip compressed input (%s) is not supported in this build (zlib not found).\n",
+                filename.c_str());
+        exit(EXIT_FAILURE);
+#endif
+        PgHelpers::MemoryMappedFile* mapping = PgHelpers::MemoryMappedFile::open(filename);
+        if (!mapping) {
+            fprintf(stderr, "cannot map gzip compressed reads file %s\n", filename.c_str());
+            exit(EXIT_FAILURE);
+        }
+        const bool bgzfMode = getBGZFBlockLength(mapping->begin(), mapping->end()) > 0;
+        return new GzipFileIStream(new gzipbuf(mapping, bgzfMode));
+    }
+
+    GzipFileIStream::~GzipFileIStream() {
+        delete(sbuf);
+    }
+
+    GzipFileIStream::gzipbuf::gzipbuf(PgHelpers::MemoryMappedFile* mapping, bool bgzfMode) :
+            mapping(mapping), bgzfMode(bgzfMode) {
+        setg(nullptr, nullptr, nullptr);
+        startProducer();
+    }
+
+    GzipFileIStream::gzipbuf::~gzipbuf() {
+        stopProducer();
+        delete(mapping);
+    }
+
+    void GzipFileIStream::gzipbuf::startProducer() {
+        finished = false;
+        stopRequested = false;
+        producer = std::thread([this] {
+            if (bgzfMode)
+                decompressBGZF();
+            else
+                decompressGzip();
+            std::lock_guard<std::mutex> lk(mut);
+            finished = true;
+            notEmpty.notify_one();
+        });
+    }
+
+    void GzipFileIStream::gzipbuf::stopProducer() {
+        {
+            std::lock_guard<std::mutex> lk(mut);
+            stopRequested = true;
+            notFull.notify_one();
+        }
+        if (producer.joinable())
+            producer.join();
+        queue.clear();
+        current.clear();
+        setg(nullptr, nullptr, nullptr);
+    }
+
+    bool GzipFileIStream::gzipbuf::pushBlock(string &block) {
+        std::unique_lock<std::mutex> lk(mut);
+        notFull.wait(lk, [this] { return queue.size() < QUEUE_LIMIT || stopRequested; });
+        if (stopRequested)
+            return false;
+        queue.push_back(std::move(block));
+        notEmpty.notify_one();
+        return true;
+    }
+
+    GzipFileIStream::gzipbuf::int_type GzipFileIStream::gzipbuf::underflow() {
+        if (gptr() < egptr())
+            return traits_type::to_int_type(*gptr());
+        do {
+            std::unique_lock<std::mutex> lk(mut);
+            notEmpty.wait(lk, [this] { return !queue.empty() || finished; });
+            if (queue.empty())
+                return traits_type::eof();
+            current = std::move(queue.front());
+            queue.pop_front();
+            notFull.notify_one();
+        } while (current.empty());
+        setg(&current[0], &current[0], &current[0] + current.size());
+        return traits_type::to_int_type(*gptr());
+    }
+
+    GzipFileIStream::gzipbuf::pos_type GzipFileIStream::gzipbuf::seekoff(off_type off, std::ios_base::seekdir dir,
+                                                                         std::ios_base::openmode which) {
+        if (off != 0 || dir != std::ios_base::beg)
+            return pos_type(off_type(-1));
+        stopProducer();
+        startProducer();
+        return pos_type(0);
+    }
+
+    GzipFileIStream::gzipbuf::pos_type GzipFileIStream::gzipbuf::seekpos(pos_type pos, std::ios_base::openmode which) {
+        return seekoff(off_type(pos), std::ios_base::beg, which);
+    }
+
+#ifdef HAVE_ZLIB
+    void GzipFileIStream::gzipbuf::decompressGzip() {
+        z_stream strm;
+        memset(&strm, 0, sizeof(strm));
+        if (inflateInit2(&strm, 15 + 16) != Z_OK) {
+            fprintf(stderr, "error initializing gzip decompression\n");
+            exit(EXIT_FAILURE);
+        }
+        const char* inPos = mapping->begin();
+        const char* inEnd = mapping->end();
+        int ret = Z_OK;
+        while (ret == Z_OK) {
+            string block;
+            block.resize(GZIP_OUTPUT_BLOCK_SIZE);
+            strm.next_out = (Bytef*) &block[0];
+            strm.avail_out = GZIP_OUTPUT_BLOCK_SIZE;
+            while (strm.avail_out > 0) {
+                if (strm.avail_in == 0 && inPos < inEnd) {
+                    strm.next_in = (Bytef*) inPos;
+                    strm.avail_in = std::min<size_t>(inEnd - inPos, UINT32_MAX);
+                    inPos += strm.avail_in;
+                }
+                ret = inflate(&strm, Z_NO_FLUSH);
+                if (ret == Z_STREAM_END) {
+                    if (strm.avail_in == 0 && inPos == inEnd)
+                        break;
+                    // concatenated gzip members
+                    inflateReset(&strm);
+                    ret = Z_OK;
+                } else if (ret == Z_BUF_ERROR)
+                    break;
+                else if (ret != Z_OK) {
+                    fprintf(stderr, "corrupted gzip compressed input (%s)\n", strm.msg ? strm.msg : "");
+                    exit(EXIT_FAILURE);
+                }
+            }
+            block.resize(GZIP_OUTPUT_BLOCK_SIZE - strm.avail_out);
+            if (!block.empty() && !pushBlock(block)) {
+                inflateEnd(&strm);
+                return;
+            }
+        }
+        if (ret != Z_STREAM_END) {
+            fprintf(stderr, "truncated gzip compressed input\n");
+            exit(EXIT_FAILURE);
+        }
+        inflateEnd(&strm);
+    }
+
+    void GzipFileIStream::gzipbuf::decompressBGZF() {
+        const int batchLimit = PgHelpers::numberOfThreads * BGZF_BLOCKS_PER_THREAD_IN_BATCH;
+        vector<const char*> blocks;
+        vector<size_t> blocksLength, outPos;
+        const char* pos = mapping->begin();
+        const char* end = mapping->end();
+        while (pos < end) {
+            blocks.clear();
+            blocksLength.clear();
+            outPos.assign(1, 0);
+            while (pos < end && (int) blocks.size() < batchLimit) {
+                size_t blockLength = getBGZFBlockLength(pos, end);
+                if (blockLength == 0 || blockLength < GZIP_HEADER_LENGTH + GZIP_FOOTER_LENGTH) {
+                    fprintf(stderr, "corrupted BGZF compressed input (at offset %zu)\n",
+                            (size_t) (pos - mapping->begin()));
+                    exit(EXIT_FAILURE);
+                }
+                blocks.push_back(pos);
+                blocksLength.push_back(blockLength);
+                outPos.push_back(outPos.back() + readLE(pos + blockLength - 4, 4));
+                pos += blockLength;
+            }
+            string batch;
+            batch.resize(outPos.back());
+            const int blocksCount = blocks.size();
+            #pragma omp parallel for schedule(dynamic) num_threads(PgHelpers::numberOfThreads)
+            for(int i = 0; i < blocksCount; i++) {
+                const size_t dataPos = GZIP_HEADER_LENGTH + 2 + readLE(blocks[i] + GZIP_HEADER_LENGTH, 2);
+                const size_t outLength = outPos[i + 1] - outPos[i];
+                z_stream strm;
+                memset(&strm, 0, sizeof(strm));
+                int ret = inflateInit2(&strm, -15);
+                strm.next_in = (Bytef*) blocks[i] + dataPos;
+                strm.avail_in = blocksLength[i] - dataPos - GZIP_FOOTER_LENGTH;
+                strm.next_out = (Bytef*) &batch[0] + outPos[i];
+                strm.avail_out = outLength;
+                if (ret == Z_OK)
+                    ret = inflate(&strm, Z_FINISH);
+                inflateEnd(&strm);
+                if (ret != Z_STREAM_END || strm.avail_out != 0 ||
+                    crc32(0, (Bytef*) &batch[0] + outPos[i], outLength) != readLE(blocks[i] + blocksLength[i] - 8, 4)) {
+                    fprintf(stderr, "corrupted BGZF compressed input (at offset %zu)\n",
+                            (size_t) (blocks[i] - mapping->begin()));
+                    exit(EXIT_FAILURE);
+                }
+            }
+            if (!pushBlock(batch))
+                return;
+        }
+    }
+#else
+    void GzipFileIStream::gzipbuf::decompressGzip() { }
+    void GzipFileIStream::gzipbuf::decompressBGZF() { }
+#endif
+
+}
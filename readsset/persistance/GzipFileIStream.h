@@ -0,0 +1,68 @@
+#ifndef PGTOOLS_GZIPFILEISTREAM_H
+#define PGTOOLS_GZIPFILEISTREAM_H
+
+#include "../../utils/helper.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace PgReadsSet {
+
+    // gzip compressed file decompressed by a dedicated thread into a bounded queue of blocks
+    // (BGZF blocks are decompressed in parallel batches); only rewinding (seekg(0)) is supported
+    class GzipFileIStream : public istream {
+
+    private:
+
+        class gzipbuf : public std::streambuf {
+        private:
+            PgHelpers::MemoryMappedFile* mapping;
+            const bool bgzfMode;
+
+            string current;
+            std::deque<string> queue;
+            std::mutex mut;
+            std::condition_variable notEmpty, notFull;
+            bool finished = false;
+            bool stopRequested = false;
+            std::thread producer;
+
+            void startProducer();
+            void stopProducer();
+            bool pushBlock(string &block);
+
+            void decompressGzip();
+            void decompressBGZF();
+
+        public:
+            gzipbuf(PgHelpers::MemoryMappedFile* mapping, bool bgzfMode);
+            ~gzipbuf() override;
+
+        protected:
+            int_type underflow() override;
+            pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+            pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+        };
+
+        gzipbuf* sbuf;
+
+        GzipFileIStream(gzipbuf* sbuf) : istream(sbuf), sbuf(sbuf) {}
+
+    public:
+        static const size_t GZIP_OUTPUT_BLOCK_SIZE = 1 << 22;
+        static const int BGZF_BLOCKS_PER_THREAD_IN_BATCH = 16;
+        static const int QUEUE_LIMIT = 4;
+
+        static bool isGzipFile(const string &filename);
+
+        static GzipFileIStream* open(const string &filename);
+
+        ~GzipFileIStream() override;
+    };
+
+}
+
+#endif //PGTOOLS_GZIPFILEISTREAM_H
@@ -1,9 +1,12 @@
 #include "ReadsSetPersistence.h"
 
 #include "../iterator/DivisionReadsSetDecorators.h"
+#include "GzipFileIStream.h"
 
 namespace PgReadsSet {
 
+    bool ReadsSetPersistence::memoryMappedFASTQMode = true;
+
     ReadsSourceIteratorTemplate<uint_read_len_max> *ReadsSetPersistence::createManagedReadsIterator(const string &srcFile,
                                                                                                     const string &pairFile,
                                                                                                     bool revComplPairFile,
@@ -15,28 +18,135 @@ namespace PgReadsSet {
                                            ignoreNReads, ignoreNoNReads);
     }
 
+    typedef MemoryMappedFASTQReadsSourceIterator<uint_read_len_max> MappedFASTQIterator;
+
+    static vector<const char*> divideIntoRecordsChunks(const MemoryMappedFile* mapping, int chunksCount) {
+        vector<const char*> bounds(chunksCount + 1);
+        bounds[0] = mapping->begin();
+        bounds[chunksCount] = mapping->end();
+        #pragma omp parallel for
+        for(int i = 1; i < chunksCount; i++)
+            bounds[i] = MappedFASTQIterator::findRecordBeginning(
+                    mapping->begin() + mapping->length() / chunksCount * i, mapping->begin(), mapping->end());
+        for(int i = 1; i < chunksCount; i++)
+            bounds[i] = std::max(bounds[i], bounds[i - 1]);
+        return bounds;
+    }
+
+    static vector<uint64_t> getRecordsChunksPositions(const vector<const char*> &bounds) {
+        const int chunksCount = bounds.size() - 1;
+        vector<uint64_t> positions(chunksCount + 1, 0);
+        #pragma omp parallel for schedule(dynamic)
+        for(int i = 0; i < chunksCount; i++) {
+            uint64_t count = 0;
+            const char* pos = bounds[i];
+            while (pos < bounds[i + 1]) {
+                pos = MappedFASTQIterator::nextRecord(pos, bounds[i + 1]);
+                count++;
+            }
+            positions[i + 1] = count;
+        }
+        for(int i = 0; i < chunksCount; i++)
+            positions[i + 1] += positions[i];
+        return positions;
+    }
+
+    ReadsSetPersistence::ManagedReadsChunks* ReadsSetPersistence::createManagedReadsChunks(const string &srcFile,
+            const string &pairFile, bool revComplPairFile, int chunksCount) {
+        MemoryMappedFile* srcMapping = MemoryMappedFile::open(srcFile);
+        if (!srcMapping)
+            return nullptr;
+        MemoryMappedFile* pairMapping = nullptr;
+        if (*srcMapping->begin() != '@' || (pairFile != "" && (!(pairMapping = MemoryMappedFile::open(pairFile)) ||
+                *pairMapping->begin() != '@'))) {
+            delete(srcMapping);
+            delete(pairMapping);
+            return nullptr;
+        }
+        ManagedReadsChunks* chunks = new ManagedReadsChunks(srcMapping, pairMapping);
+        const vector<const char*> srcBounds = divideIntoRecordsChunks(srcMapping, chunksCount);
+        const vector<uint64_t> srcPositions = getRecordsChunksPositions(srcBounds);
+        vector<const char*> pairBounds(chunksCount + 1, nullptr);
+        if (pairMapping) {
+            const vector<const char*> pairChunksBounds = divideIntoRecordsChunks(pairMapping, chunksCount);
+            const vector<uint64_t> pairPositions = getRecordsChunksPositions(pairChunksBounds);
+            if (pairPositions.back() != srcPositions.back()) {
+                delete(chunks);
+                return nullptr;
+            }
+            #pragma omp parallel for
+            for(int i = 0; i <= chunksCount; i++) {
+                int j = std::upper_bound(pairPositions.begin(), pairPositions.end(), srcPositions[i])
+                        - pairPositions.begin() - 1;
+                const char* pos = pairChunksBounds[j];
+                for(uint64_t k = pairPositions[j]; k < srcPositions[i]; k++)
+                    pos = MappedFASTQIterator::nextRecord(pos, pairMapping->end());
+                pairBounds[i] = pos;
+            }
+        }
+        const int readsPerRecord = pairMapping ? 2 : 1;
+        for(int i = 0; i < chunksCount; i++) {
+            ReadsSourceIteratorTemplate<uint_read_len_max>* chunkIterator = new MappedFASTQIterator(
+                    srcBounds[i], srcBounds[i + 1], pairBounds[i], pairBounds[i + 1]);
+            if (pairMapping && revComplPairFile) {
+                chunks->coreIterators.push_back(chunkIterator);
+                chunkIterator = new RevComplPairReadsSetIterator<uint_read_len_max>(chunkIterator);
+            }
+            chunks->chunksIterators.push_back(chunkIterator);
+            chunks->chunksBegIdx.push_back(srcPositions[i] * readsPerRecord);
+        }
+        chunks->chunksBegIdx.push_back(srcPositions[chunksCount] * readsPerRecord);
+        return chunks;
+    }
+
+    ReadsSetPersistence::ManagedReadsChunks::~ManagedReadsChunks() {
+        for(ReadsSourceIteratorTemplate<uint_read_len_max>* chunkIterator: chunksIterators)
+            delete(chunkIterator);
+        for(ReadsSourceIteratorTemplate<uint_read_len_max>* coreIterator: coreIterators)
+            delete(coreIterator);
+        delete(srcMapping);
+        delete(pairMapping);
+    }
+
     using namespace PgTools;
 
+    static istream* openReadsFile(const string &filename, char* buf) {
+        if (GzipFileIStream::isGzipFile(filename))
+            return GzipFileIStream::open(filename);
+        ifstream* source = new ifstream(filename, ios_base::in | ios_base::binary);
+        source->rdbuf()->pubsetbuf(buf, 1 << 16);
+        return source;
+    }
+
     ReadsSetPersistence::ManagedReadsSetIterator::ManagedReadsSetIterator(const string &srcFile, const string &pairFile,
             bool revComplPairFile, const string &divisionFile, bool divisionComplement, bool ignoreNReads, bool ignoreNoNReads) {
-        srcSource = new ifstream(srcFile, ios_base::in | ios_base::binary);
+        srcSource = openReadsFile(srcFile, buf1);
         if (srcSource->fail()) {
             fprintf(stderr, "cannot open reads file %s\n", srcFile.c_str());
             exit(EXIT_FAILURE);
         }
-        srcSource->rdbuf()->pubsetbuf(buf1, 1 << 16);
         if (pairFile != "") {
-            pairSource = new ifstream(pairFile, ios_base::in | ios_base::binary);
+            pairSource = openReadsFile(pairFile, buf2);
             if (pairSource->fail()) {
                 fprintf(stderr, "cannot open reads pair file %s\n", pairFile.c_str());
                 exit(EXIT_FAILURE);
             }
-            pairSource->rdbuf()->pubsetbuf(buf2, 1 << 16);
         }
-        char firstSymbol = srcSource->get();
-        srcSource->clear();
-        srcSource->seekg(0);
-        switch(firstSymbol) {case '@': readsIterator = new FASTQReadsSourceIterator<uint_read_len_max>(srcSource, pairSource);
+        char firstSymbol = srcSource->peek();
+        const bool compressedInput = dynamic_cast<GzipFileIStream*>(srcSource) ||
+                dynamic_cast<GzipFileIStream*>(pairSource);
+        if (firstSymbol == '@' && memoryMappedFASTQMode && !compressedInput) {
+            srcMapping = MemoryMappedFile::open(srcFile);
+            if (srcMapping && pairFile != "" && !(pairMapping = MemoryMappedFile::open(pairFile))) {
+                delete(srcMapping);
+                srcMapping = nullptr;
+            }
+        }
+        switch(firstSymbol) {case '@':
+                if (srcMapping)
+                    readsIterator = new MemoryMappedFASTQReadsSourceIterator<uint_read_len_max>(srcMapping, pairMapping);
+                else
+                    readsIterator = new FASTQReadsSourceIterator<uint_read_len_max>(srcSource, pairSource);
                 break;
             case ';':
             case '>':
@@ -68,14 +178,13 @@ namespace PgReadsSet {
         delete(readsIterator);
         for(ReadsSourceIteratorTemplate<uint_read_len_max>* coreIterator: coreIterators)
             delete(coreIterator);
-        srcSource->close();
-        if (pairSource)
-            pairSource->close();
         if (divSource)
             divSource->close();
         delete(srcSource);
         delete(pairSource);
         delete(divSource);
+        delete(srcMapping);
+        delete(pairMapping);
     }
 
     bool ReadsSetPersistence::ManagedReadsSetIterator::moveNext() {
@@ -18,9 +18,11 @@ namespace PgReadsSet {
             char* buf1 = new char[1 << 16];
             char* buf2 = new char[1 << 16];
 
-            ifstream* srcSource = nullptr;
-            ifstream* pairSource = nullptr;
+            istream* srcSource = nullptr;
+            istream* pairSource = nullptr;
             ifstream* divSource = nullptr;
+            MemoryMappedFile* srcMapping = nullptr;
+            MemoryMappedFile* pairMapping = nullptr;
         public:
             ManagedReadsSetIterator(const string &srcFile, const string &pairFile = "", bool revComplPairFile = false,
                     const string &divisionFile = "", bool divisionComplement = false,
@@ -39,6 +41,34 @@ namespace PgReadsSet {
         };
 
     public:
+        static bool memoryMappedFASTQMode;
+
+        // memory-mapped FASTQ input divided on records boundaries into chunks (for parallel processing)
+        class ManagedReadsChunks {
+        private:
+            MemoryMappedFile* srcMapping = nullptr;
+            MemoryMappedFile* pairMapping = nullptr;
+            vector<ReadsSourceIteratorTemplate<uint_read_len_max>*> chunksIterators;
+            vector<ReadsSourceIteratorTemplate<uint_read_len_max>*> coreIterators;
+            vector<uint_reads_cnt_max> chunksBegIdx;
+
+            ManagedReadsChunks(MemoryMappedFile* srcMapping, MemoryMappedFile* pairMapping) :
+                srcMapping(srcMapping), pairMapping(pairMapping) {};
+
+            friend class ReadsSetPersistence;
+        public:
+            int chunksCount() const { return chunksIterators.size(); };
+            uint_reads_cnt_max readsCount() const { return chunksBegIdx.back(); };
+            uint_reads_cnt_max getChunkFirstReadIndex(int i) const { return chunksBegIdx[i]; };
+            ReadsSourceIteratorTemplate<uint_read_len_max>* getChunkIterator(int i) const { return chunksIterators[i]; };
+
+            ~ManagedReadsChunks();
+        };
+
+        // returns nullptr if the input is not a memory mappable FASTQ file (or pair files are not consistent)
+        static ManagedReadsChunks* createManagedReadsChunks(const string &srcFile, const string &pairFile = "",
+                                                           bool revComplPairFile = false, int chunksCount = 1);
+
         static ReadsSourceIteratorTemplate<uint_read_len_max>* createManagedReadsIterator(const string &srcFile,
                                                                                           const string &pairFile = "",
                                                                                           bool revComplPairFile = false,
@@ -2,6 +2,17 @@
 
 #include "byteswap.h"
 
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
 std::ostream *PgHelpers::logout = &std::cout;
 std::ostream *PgHelpers::appout = &std::cout;
 std::ostream *PgHelpers::devout = &std::cout;
@@ -11,6 +22,38 @@ int PgHelpers::numberOfThreads = 8;
 NullBuffer null_buffer;
 std::ostream null_stream(&null_buffer);
 
+// MEMORY
+
+static size_t readProcStatusValue(const char* key) {
+    std::ifstream status("/proc/self/status");
+    string line;
+    const size_t keyLength = strlen(key);
+    while (getline(status, line))
+        if (line.compare(0, keyLength, key) == 0)
+            return strtoull(line.c_str() + keyLength, nullptr, 10) * 1024;
+    return 0;
+}
+
+size_t PgHelpers::getResidentMemory() {
+    return readProcStatusValue("VmRSS:");
+}
+
+size_t PgHelpers::getPeakResidentMemory() {
+    return readProcStatusValue("VmHWM:");
+}
+
+void PgHelpers::resetPeakResidentMemory() {
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    if (clearRefs)
+        clearRefs << "5";
+}
+
+void PgHelpers::releaseFreedMemory() {
+#ifdef __GLIBC__
+    malloc_trim(0);
+#endif
+}
+
 // TIME
 
 clock_t checkpoint;
@@ -186,6 +229,50 @@ void PgHelpers::writeUIntByteFrugal(std::ostream &dest, uint64_t value) {
     dest.write((char *) &yByte, sizeof(uint8_t));
 }
 
+uint32_t PgHelpers::calculateCRC32(const void* data, size_t length, uint32_t crc) {
+#ifdef HAVE_ZLIB
+    const Bytef* pos = (const Bytef*) data;
+    while (length > 0) {
+        const uInt chunkLength = (uInt) std::min<size_t>(length, UINT32_MAX);
+        crc = ::crc32(crc, pos, chunkLength);
+        pos += chunkLength;
+        length -= chunkLength;
+    }
+    return crc;
+#else
+    // slicing-by-8 (little-endian words are processed 8 bytes per step)
+    static const struct CRC32Tables {
+        uint32_t values[8][256];
+        CRC32Tables() {
+            for (uint32_t i = 0; i < 256; i++) {
+                uint32_t c = i;
+                for (int k = 0; k < 8; k++)
+                    c = c & 1 ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+                values[0][i] = c;
+            }
+            for (uint32_t i = 0; i < 256; i++)
+                for (int t = 1; t < 8; t++)
+                    values[t][i] = values[0][values[t - 1][i] & 0xFF] ^ (values[t - 1][i] >> 8);
+        }
+    } tables;
+    const uint8_t* pos = (const uint8_t*) data;
+    crc = ~crc;
+    for (; length >= 8; length -= 8, pos += 8) {
+        uint32_t lo, hi;
+        memcpy(&lo, pos, sizeof(lo));
+        memcpy(&hi, pos + 4, sizeof(hi));
+        lo ^= crc;
+        crc = tables.values[7][lo & 0xFF] ^ tables.values[6][(lo >> 8) & 0xFF] ^
+              tables.values[5][(lo >> 16) & 0xFF] ^ tables.values[4][lo >> 24] ^
+              tables.values[3][hi & 0xFF] ^ tables.values[2][(hi >> 8) & 0xFF] ^
+              tables.values[1][(hi >> 16) & 0xFF] ^ tables.values[0][hi >> 24];
+    }
+    for (; length > 0; length--, pos++)
+        crc = tables.values[0][(crc ^ *pos) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+#endif
+}
+
 bool PgHelpers::bytePerReadLengthMode = false;
 
 void PgHelpers::readReadLengthValue(std::istream &src, uint16_t &value, bool plainTextReadMode) {
@@ -560,3 +647,44 @@ int PgHelpers::strcmplcp(const char* lStrPtr, const char* rStrPtr, int length) {
     return 0;
 
 }
+
+static vector<string> spilledFiles;
+
+static void removeSpilledFiles() {
+    for (const string &filename: spilledFiles)
+        remove(filename.c_str());
+}
+
+void PgHelpers::registerSpilledFile(const string &filename) {
+    static const bool cleanupRegistered = atexit(removeSpilledFiles) == 0;
+    (void) cleanupRegistered;
+    if (std::find(spilledFiles.begin(), spilledFiles.end(), filename) == spilledFiles.end())
+        spilledFiles.push_back(filename);
+}
+
+void PgHelpers::removeSpilledFile(const string &filename) {
+    spilledFiles.erase(std::remove(spilledFiles.begin(), spilledFiles.end(), filename), spilledFiles.end());
+    remove(filename.c_str());
+}
+
+PgHelpers::MemoryMappedFile* PgHelpers::MemoryMappedFile::open(const string &filename, bool sequentialAccess) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd == -1)
+        return nullptr;
+    struct stat st;
+    if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+        close(fd);
+        return nullptr;
+    }
+    void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return nullptr;
+    if (sequentialAccess)
+        madvise(data, st.st_size, MADV_SEQUENTIAL);
+    return new MemoryMappedFile((char*) data, st.st_size);
+}
+
+PgHelpers::MemoryMappedFile::~MemoryMappedFile() {
+    munmap(data, size);
+}
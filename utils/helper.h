@@ -13,6 +13,8 @@
 #include <climits>
 #include <cmath>
 #include <sstream>
+#include <memory>
+#include <vector>
 
 using namespace std;
 
@@ -73,6 +75,15 @@ namespace PgHelpers {
     unsigned long long int time_millis(chrono::steady_clock::time_point checkpoint);
 
 
+    // memory usage routines (resident set size in bytes; 0 if not supported by the system)
+
+    size_t getResidentMemory();
+    size_t getPeakResidentMemory();
+    void resetPeakResidentMemory();
+    // returns freed heap memory to the system
+    void releaseFreedMemory();
+
+
     // string conversion routines
 
     string toString(unsigned long long value);
@@ -206,6 +217,9 @@ namespace PgHelpers {
 
     void writeUIntByteFrugal(std::ostream &dest, uint64_t value);
 
+    // CRC-32 (IEEE 802.3) of data continuing the given crc value
+    uint32_t calculateCRC32(const void* data, size_t length, uint32_t crc = 0);
+
     template<typename t_val>
     void readUIntByteFrugal(std::istream &src, t_val& value) {
         value = 0;
@@ -264,6 +278,144 @@ namespace PgHelpers {
         }
     };
 
+    class MemoryMappedFile {
+    private:
+        char* data = nullptr;
+        size_t size = 0;
+
+        MemoryMappedFile(char* data, size_t size) : data(data), size(size) {}
+
+    public:
+        // returns nullptr if the file cannot be mapped (e.g. it is not a regular file)
+        static MemoryMappedFile* open(const string &filename, bool sequentialAccess = true);
+
+        const char* begin() const { return data; }
+        const char* end() const { return data + size; }
+        size_t length() const { return size; }
+
+        ~MemoryMappedFile();
+    };
+
+    // leaves elements uninitialized on vector resize (allows first-touch initialization by worker threads)
+    template <typename T, typename A = std::allocator<T>>
+    class DefaultInitAllocator : public A {
+        typedef std::allocator_traits<A> a_t;
+    public:
+        template <typename U> struct rebind {
+            using other = DefaultInitAllocator<U, typename a_t::template rebind_alloc<U>>;
+        };
+
+        using A::A;
+
+        template <typename U>
+        void construct(U* ptr) { ::new(static_cast<void*>(ptr)) U; }
+        template <typename U, typename... Args>
+        void construct(U* ptr, Args&&... args) {
+            a_t::construct(static_cast<A&>(*this), ptr, std::forward<Args>(args)...);
+        }
+    };
+
+    // stable (LSD) radix sort of indexes [0, count) by their keys (each pass is performed in parallel blocks)
+    template <typename uint_key, typename uint_idx>
+    void radixSortIndexesByKeys(const uint_key* keys, uint_idx count, vector<uint_idx> &sortedIdxs) {
+        const static uint8_t RADIX_BITS = 11;
+        const static size_t RADIX_SIZE = (size_t) 1 << RADIX_BITS;
+        const static size_t MIN_BLOCK_LENGTH = 1 << 16;
+        const size_t blocksCount = std::max<size_t>(1, std::min<size_t>(count / MIN_BLOCK_LENGTH, numberOfThreads));
+        const size_t blockLength = ((size_t) count + blocksCount - 1) / blocksCount;
+        uint_key maxKey = 0;
+        #pragma omp parallel for reduction(max:maxKey) num_threads(blocksCount)
+        for (size_t i = 0; i < count; i++)
+            if (keys[i] > maxKey)
+                maxKey = keys[i];
+
+        vector<uint_key, DefaultInitAllocator<uint_key>> keysBuffers[2];
+        vector<uint_idx> idxsBuffers[2];
+        const uint_key* srcKeys = keys;
+        const uint_idx* srcIdxs = nullptr;
+        uint8_t destBuffer = 0;
+        vector<size_t> blockDigitPos(blocksCount * RADIX_SIZE);
+        for (uint8_t shift = 0; shift < sizeof(uint_key) * 8 && (maxKey >> shift); shift += RADIX_BITS) {
+            const bool isLastPass = shift + RADIX_BITS >= sizeof(uint_key) * 8 || !(maxKey >> (shift + RADIX_BITS));
+            if (!isLastPass)
+                keysBuffers[destBuffer].resize(count);
+            idxsBuffers[destBuffer].resize(count);
+            uint_key* destKeys = keysBuffers[destBuffer].data();
+            uint_idx* destIdxs = idxsBuffers[destBuffer].data();
+            std::fill(blockDigitPos.begin(), blockDigitPos.end(), 0);
+            #pragma omp parallel for num_threads(blocksCount)
+            for (size_t b = 0; b < blocksCount; b++) {
+                size_t* digitCount = blockDigitPos.data() + b * RADIX_SIZE;
+                const size_t end = std::min<size_t>((b + 1) * blockLength, count);
+                for (size_t i = b * blockLength; i < end; i++)
+                    digitCount[(srcKeys[i] >> shift) & (RADIX_SIZE - 1)]++;
+            }
+            size_t pos = 0;
+            for (size_t d = 0; d < RADIX_SIZE; d++) {
+                for (size_t b = 0; b < blocksCount; b++) {
+                    const size_t digitCount = blockDigitPos[b * RADIX_SIZE + d];
+                    blockDigitPos[b * RADIX_SIZE + d] = pos;
+                    pos += digitCount;
+                }
+            }
+            #pragma omp parallel for num_threads(blocksCount)
+            for (size_t b = 0; b < blocksCount; b++) {
+                size_t* digitPos = blockDigitPos.data() + b * RADIX_SIZE;
+                const size_t end = std::min<size_t>((b + 1) * blockLength, count);
+                for (size_t i = b * blockLength; i < end; i++) {
+                    const size_t destPos = digitPos[(srcKeys[i] >> shift) & (RADIX_SIZE - 1)]++;
+                    if (!isLastPass)
+                        destKeys[destPos] = srcKeys[i];
+                    destIdxs[destPos] = srcIdxs ? srcIdxs[i] : (uint_idx) i;
+                }
+            }
+            srcKeys = destKeys;
+            srcIdxs = destIdxs;
+            destBuffer ^= 1;
+        }
+        if (srcIdxs) {
+            sortedIdxs = std::move(idxsBuffers[destBuffer ^ 1]);
+        } else {
+            sortedIdxs.resize(count);
+            for (size_t i = 0; i < count; i++)
+                sortedIdxs[i] = i;
+        }
+    }
+
+    // spilled files (left e.g. after an error) are removed at exit
+    void registerSpilledFile(const string &filename);
+    void removeSpilledFile(const string &filename);
+
+    // writes a vector (or string) content to a file releasing its memory (returns false if nothing was spilled)
+    template <typename C>
+    bool spillToFile(C &container, const string &filename) {
+        if (container.empty())
+            return false;
+        registerSpilledFile(filename);
+        std::ofstream out(filename, ios::out | ios::binary | ios::trunc);
+        out.write((const char*) container.data(), container.size() * sizeof(*container.data()));
+        if (!out) {
+            fprintf(stderr, "Error spilling data to file %s\n", filename.c_str());
+            exit(EXIT_FAILURE);
+        }
+        C().swap(container);
+        return true;
+    }
+
+    // restores a content spilled to a file (read directly into the container) and removes the file
+    template <typename C>
+    void restoreSpilledFile(C &container, const string &filename) {
+        std::ifstream in(filename, ios::in | ios::binary | ios::ate);
+        const size_t length = in ? (size_t) in.tellg() : 0;
+        container.resize(length / sizeof(*container.data()));
+        if (!in.seekg(0) || !in.read((char*) container.data(), length)) {
+            fprintf(stderr, "Error restoring data spilled to file %s\n", filename.c_str());
+            exit(EXIT_FAILURE);
+        }
+        in.close();
+        removeSpilledFile(filename);
+    }
+
 }
 
 #endif // HELPER_H_INCLUDED
@@ -0,0 +1,114 @@
+#include "mismatches.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define MISMATCHES_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace PgHelpers {
+
+    uint8_t countSymbolsMismatchesScalar(const char *pattern, const char *text, uint64_t length, uint8_t maxMismatches) {
+        uint8_t res = 0;
+        const char *patEnd = pattern + length;
+        while (pattern != patEnd) {
+            if (*pattern++ != *text++) {
+                if (res++ >= maxMismatches)
+                    return UINT8_MAX;
+            }
+        }
+        return res;
+    }
+
+#ifdef MISMATCHES_X86_KERNELS
+    __attribute__((target("sse4.2,popcnt")))
+    uint8_t countSymbolsMismatchesSSE42(const char *pattern, const char *text, uint64_t length, uint8_t maxMismatches) {
+        uint64_t res = 0;
+        uint64_t i = 0;
+        for(; i + 16 <= length; i += 16) {
+            const __m128i p = _mm_loadu_si128((const __m128i*) (pattern + i));
+            const __m128i t = _mm_loadu_si128((const __m128i*) (text + i));
+            const uint32_t matchMask = _mm_movemask_epi8(_mm_cmpeq_epi8(p, t));
+            res += _mm_popcnt_u32(~matchMask & 0xFFFF);
+            if (res > maxMismatches)
+                return UINT8_MAX;
+        }
+        for(; i < length; i++) {
+            if (pattern[i] != text[i] && res++ >= maxMismatches)
+                return UINT8_MAX;
+        }
+        return res;
+    }
+
+    __attribute__((target("avx2,popcnt")))
+    uint8_t countSymbolsMismatchesAVX2(const char *pattern, const char *text, uint64_t length, uint8_t maxMismatches) {
+        uint64_t res = 0;
+        uint64_t i = 0;
+        for(; i + 32 <= length; i += 32) {
+            const __m256i p = _mm256_loadu_si256((const __m256i*) (pattern + i));
+            const __m256i t = _mm256_loadu_si256((const __m256i*) (text + i));
+            const uint32_t matchMask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(p, t));
+            res += _mm_popcnt_u32(~matchMask);
+            if (res > maxMismatches)
+                return UINT8_MAX;
+        }
+        if (i + 16 <= length) {
+            const __m128i p = _mm_loadu_si128((const __m128i*) (pattern + i));
+            const __m128i t = _mm_loadu_si128((const __m128i*) (text + i));
+            const uint32_t matchMask = _mm_movemask_epi8(_mm_cmpeq_epi8(p, t));
+            res += _mm_popcnt_u32(~matchMask & 0xFFFF);
+            if (res > maxMismatches)
+                return UINT8_MAX;
+            i += 16;
+        }
+        for(; i < length; i++) {
+            if (pattern[i] != text[i] && res++ >= maxMismatches)
+                return UINT8_MAX;
+        }
+        return res;
+    }
+
+    bool isSSE42Supported() {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt");
+    }
+
+    bool isAVX2Supported() {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+    }
+#else
+    uint8_t countSymbolsMismatchesSSE42(const char *pattern, const char *text, uint64_t length, uint8_t maxMismatches) {
+        return countSymbolsMismatchesScalar(pattern, text, length, maxMismatches);
+    }
+
+    uint8_t countSymbolsMismatchesAVX2(const char *pattern, const char *text, uint64_t length, uint8_t maxMismatches) {
+        return countSymbolsMismatchesScalar(pattern, text, length, maxMismatches);
+    }
+
+    bool isSSE42Supported() { return false; }
+    bool isAVX2Supported() { return false; }
+#endif
+
+    static MismatchesCountingKernel selectMismatchesCountingKernel() {
+        if (isAVX2Supported())
+            return countSymbolsMismatchesAVX2;
+        if (isSSE42Supported())
+            return countSymbolsMismatchesSSE42;
+        return countSymbolsMismatchesScalar;
+    }
+
+    static const MismatchesCountingKernel mismatchesCountingKernel = selectMismatchesCountingKernel();
+
+    uint8_t countSymbolsMismatches(const char *pattern, const char *text, uint64_t length, uint8_t maxMismatches) {
+        return mismatchesCountingKernel(pattern, text, length, maxMismatches);
+    }
+
+    const char* getMismatchesCountingKernelName() {
+        if (mismatchesCountingKernel == countSymbolsMismatchesAVX2)
+            return "AVX2";
+        if (mismatchesCountingKernel == countSymbolsMismatchesSSE42)
+            return "SSE4.2";
+        return "scalar";
+    }
+
+}
@@ -0,0 +1,25 @@
+#ifndef PGTOOLS_MISMATCHES_H
+#define PGTOOLS_MISMATCHES_H
+
+#include <cstdint>
+
+namespace PgHelpers {
+
+    typedef uint8_t (*MismatchesCountingKernel)(const char *pattern, const char *text, uint64_t length,
+            uint8_t maxMismatches);
+
+    // returns the number of mismatches between pattern and text or UINT8_MAX if it exceeds maxMismatches;
+    // the kernel (AVX2, SSE4.2 or scalar) is selected at runtime according to CPU capabilities
+    uint8_t countSymbolsMismatches(const char *pattern, const char *text, uint64_t length, uint8_t maxMismatches);
+
+    uint8_t countSymbolsMismatchesScalar(const char *pattern, const char *text, uint64_t length, uint8_t maxMismatches);
+    uint8_t countSymbolsMismatchesSSE42(const char *pattern, const char *text, uint64_t length, uint8_t maxMismatches);
+    uint8_t countSymbolsMismatchesAVX2(const char *pattern, const char *text, uint64_t length, uint8_t maxMismatches);
+
+    bool isSSE42Supported();
+    bool isAVX2Supported();
+    const char* getMismatchesCountingKernelName();
+
+}
+
+#endif //PGTOOLS_MISMATCHES_H